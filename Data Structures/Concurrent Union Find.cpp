@@ -0,0 +1,280 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <random>
+#include <chrono>
+#include <numeric>
+#include <algorithm>
+
+// The union-find used by the Kruskal and the Eulerian path files, copied
+// as is. Only used here as the base of the mutex-protected version.
+struct UnionFind
+{
+    // Optimization: sizes will be stored in the parents array.
+    //  if node x has a parent of -5, this means that x is a
+    //  root and the size of the component (forest) is 5.
+
+    // not using ranks here.
+
+    int node_count;
+    int components; // (forests)
+    std::vector<int> parent;
+
+    UnionFind(int size) : node_count(size), components(size), parent(size, -1) {}
+
+    int parent_of(int x)
+    {
+        if (parent[x] < 0) return x;
+        parent[x] = parent_of(parent[x]);
+        return parent[x];
+    }
+
+    int component_size(int x) {
+        return -parent[parent_of(x)];
+    }
+
+    bool are_connected(int a, int b) {
+        return parent_of(a) == parent_of(b);
+    }
+
+    void connect(int a, int b)
+    {
+        if (are_connected(a, b)) return;
+
+        components--;
+        parent[parent_of(a)] += -component_size(b);
+        parent[parent_of(b)] = parent_of(a);
+    }
+};
+
+struct MutexUnionFind
+{
+    // Even finds modify the structure (path compression),
+    // so every operation has to take the lock.
+
+    std::mutex mutex;
+    UnionFind unionFind;
+
+    MutexUnionFind(int size) : unionFind(size) {}
+
+    bool are_connected(int a, int b)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return unionFind.are_connected(a, b);
+    }
+
+    bool connect(int a, int b)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (unionFind.are_connected(a, b)) return false;
+        unionFind.connect(a, b);
+        return true;
+    }
+
+    int components()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return unionFind.components;
+    }
+};
+
+class ConcurrentUnionFind
+{
+    // A lock-free union-find. Any number of threads can call parent_of,
+    // are_connected and connect at the same time, and a thread that gets
+    // delayed never blocks the others.
+    //
+    // Every parent pointer is an atomic, and modified only using CAS:
+    //  - parent_of uses path halving: each visited node is pointed to its
+    //    grandparent. If the CAS fails, another thread has already moved the
+    //    node up, so the failure is simply ignored. Since a node only ever
+    //    moves closer to its root, this never breaks the structure.
+    //  - connect links one root under the other. The CAS expects the node
+    //    to still be a root, and if another thread linked it first, the
+    //    roots are looked up again and the operation is retried.
+    //
+    // Union by rank would require updating the rank and the parent together.
+    // Instead, each node gets a random priority once, and the root with the
+    // lower priority is always linked under the one with the higher priority
+    // (randomized linking by index). This keeps the trees shallow (O(log n)
+    // expected depth, as with ranks), and since the priorities never change,
+    // the links can never form a cycle.
+
+    std::vector<std::atomic<int>> parent;
+    std::vector<int> priority;
+    std::atomic<int> components_count;
+
+public:
+
+    explicit ConcurrentUnionFind(int size, unsigned seed = 1)
+        : parent(size), priority(size), components_count(size)
+    {
+        for (int i = 0; i < size; i++) {
+            parent[i].store(i, std::memory_order_relaxed);
+        }
+
+        std::iota(priority.begin(), priority.end(), 0);
+        std::shuffle(priority.begin(), priority.end(), std::mt19937(seed));
+    }
+
+    int parent_of(int x)
+    {
+        while (true) {
+            int p = parent[x].load(std::memory_order_acquire);
+            if (p == x) return x;
+            int grandparent = parent[p].load(std::memory_order_acquire);
+            if (p != grandparent) {
+                parent[x].compare_exchange_weak(p, grandparent, std::memory_order_acq_rel);
+            }
+            x = grandparent;
+        }
+    }
+
+    bool are_connected(int a, int b)
+    {
+        while (true) {
+            a = parent_of(a);
+            b = parent_of(b);
+            if (a == b) return true;
+            // If a is still a root after finding b, there was a moment
+            // where both a and b were roots, so they weren't connected.
+            if (parent[a].load(std::memory_order_acquire) == a) return false;
+        }
+    }
+
+    // Returns whether this call is the one that connected the two components.
+    bool connect(int a, int b)
+    {
+        while (true) {
+            a = parent_of(a);
+            b = parent_of(b);
+            if (a == b) return false;
+            if (priority[a] > priority[b]) std::swap(a, b);
+            int expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) {
+                components_count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    int components() const {
+        return components_count.load(std::memory_order_relaxed);
+    }
+
+    int size() const {
+        return parent.size();
+    }
+};
+
+struct Pair
+{
+    int a;
+    int b;
+};
+
+std::vector<Pair> get_random_pairs(int n, int count, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<Pair> pairs(count);
+    for (Pair& pair : pairs) {
+        pair = {(int)(random() % n), (int)(random() % n)};
+    }
+    return pairs;
+}
+
+template <typename Function>
+void run_threads(int threads_count, Function function)
+{
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; t++) {
+        threads.emplace_back(function, t);
+    }
+    for (auto& thread : threads) thread.join();
+}
+
+void stress_test(int n, int pairs_count, int threads_count, int repetitions)
+{
+    for (int repetition = 0; repetition < repetitions; repetition++)
+    {
+        auto pairs = get_random_pairs(n, pairs_count, repetition);
+
+        // The final partition doesn't depend on the order of the unions.
+        UnionFind expected(n);
+        for (const Pair& pair : pairs) expected.connect(pair.a, pair.b);
+
+        ConcurrentUnionFind unionFind(n, repetition);
+        std::atomic<int> successful_connects(0);
+        std::atomic<bool> failed(false);
+
+        run_threads(threads_count, [&](int thread) {
+            int connects = 0;
+            for (int i = thread; i < pairs.size(); i += threads_count) {
+                const Pair& pair = pairs[i];
+                connects += unionFind.connect(pair.a, pair.b);
+                // Once connect returns, the nodes must appear connected to everyone.
+                if (!unionFind.are_connected(pair.a, pair.b)) failed = true;
+            }
+            successful_connects += connects;
+        });
+
+        if (failed)
+            std::cout << "Connected nodes reported as disconnected!" << std::endl;
+
+        // Each successful connect must have merged two different components.
+        if (n - successful_connects != expected.components || unionFind.components() != expected.components)
+            std::cout << "Wrong number of components!" << std::endl;
+
+        for (int i = 0; i < n; i++) {
+            int j = (i * 7919 + 13) % n;
+            if (expected.are_connected(i, j) != unionFind.are_connected(i, j)) {
+                std::cout << "Wrong connectivity!" << std::endl;
+                break;
+            }
+        }
+    }
+}
+
+template <typename UnionFindType>
+long long time_test(int n, const std::vector<Pair>& pairs, int threads_count)
+{
+    UnionFindType unionFind(n);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    run_threads(threads_count, [&](int thread) {
+        // Half of the operations are queries, as in a connectivity tracker.
+        for (int i = thread; i < pairs.size(); i += threads_count) {
+            const Pair& pair = pairs[i];
+            if (i & 1) unionFind.connect(pair.a, pair.b);
+            else unionFind.are_connected(pair.a, pair.b);
+        }
+    });
+    auto end = std::chrono::high_resolution_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+void benchmark(int n, int operations)
+{
+    auto pairs = get_random_pairs(n, operations, 12345);
+    std::cout << n << " nodes, " << operations << " operations" << std::endl;
+
+    int max_threads = std::max(8u, std::thread::hardware_concurrency());
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        long long lock_free = time_test<ConcurrentUnionFind>(n, pairs, threads);
+        long long locked = time_test<MutexUnionFind>(n, pairs, threads);
+        std::cout << threads << " threads: lock-free " << lock_free << " ms, mutex " << locked << " ms" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    stress_test(1000, 2000, 8, 50);
+    stress_test(100000, 200000, 4, 5);
+
+    benchmark(1'000'000, 10'000'000);
+}
@@ -0,0 +1,629 @@
+#include <iostream>
+#include <functional>
+#include <vector>
+#include <stack>
+#include <chrono>
+#include <random>
+
+#define V(x) IncrementalSAT2::index_of(x)
+#define nV(x) IncrementalSAT2::compliment(V(x))
+
+const int UNKNOWN = -1;
+const int UNVISITED = -1;
+typedef std::vector<std::vector<int>> Graph;
+
+class IncrementalSAT2
+{
+    // Answers "is it still satisfiable?" after each added clause, without
+    // rebuilding the implication graph or recomputing the components.
+    //
+    // A satisfying assignment of the clauses added so far is kept at all times.
+    // When a clause (p or q) is added:
+    //  - If the current assignment already satisfies it, nothing changes.
+    //  - Otherwise, try to make p true: set p, and follow the implications out
+    //    of every literal that became true. A literal that is already true needs
+    //    nothing (everything it implies is already true, since the assignment
+    //    satisfies all the clauses). A false literal whose variable wasn't touched
+    //    yet is flipped, and its implications are followed in turn. Reaching a
+    //    false literal whose variable was set during this attempt means that p
+    //    implies both a literal and its complement, so p can't be true.
+    //  - If p failed, the changes are rolled back and q is tried the same way.
+    //  - If both fail, there is no solution, and adding more clauses can't fix it.
+    //
+    // A successful attempt leaves a satisfying assignment: every clause that
+    // contains a literal that became false is an implication out of the
+    // complement of that literal, which became true and was followed. Since
+    // only the flipped variables are visited, an attempt usually touches a
+    // handful of nodes instead of the whole graph. The worst case is still
+    // O(V + E) per clause.
+    //
+    // The same attempt works for solving under assumptions: the assumed literals
+    // are set one after the other, keeping all the variables set so far locked,
+    // and the changes are rolled back afterwards.
+
+    int n;
+    Graph graph;
+    bool satisfiable;
+
+    std::vector<bool> var_values;
+    std::vector<bool> locked;
+    std::vector<int> trail;  // variables flipped by the current attempt
+    std::vector<int> locked_trail;  // variables locked by the current attempt
+    std::vector<int> stack;
+
+    bool is_true(int literal) const {
+        return var_values[reverse_index_of(literal)] != is_compliment(literal);
+    }
+
+    void set_true(int literal)
+    {
+        int var = reverse_index_of(literal);
+        if (!is_true(literal)) {
+            var_values[var] = !var_values[var];
+            trail.push_back(var);
+        }
+        locked[var] = true;
+        locked_trail.push_back(var);
+    }
+
+    // Tries to make the literal true, while keeping every clause
+    // satisfied and without changing any locked variable.
+    bool propagate(int literal)
+    {
+        int var = reverse_index_of(literal);
+        if (!is_true(literal) && locked[var]) return false;
+        if (!locked[var]) set_true(literal);
+        stack.assign(1, literal);
+
+        while (!stack.empty())
+        {
+            int x = stack.back();
+            stack.pop_back();
+
+            for (int y : graph[x]) {
+                if (is_true(y)) continue;
+                if (locked[reverse_index_of(y)]) return false;
+                set_true(y);
+                stack.push_back(y);
+            }
+        }
+
+        return true;
+    }
+
+    void rollback()
+    {
+        for (int var : trail) var_values[var] = !var_values[var];
+        trail.clear();
+        unlock();
+    }
+
+    void unlock()
+    {
+        for (int var : locked_trail) locked[var] = false;
+        locked_trail.clear();
+    }
+
+    bool try_literal(int literal)
+    {
+        if (propagate(literal)) {
+            trail.clear();
+            unlock();
+            return true;
+        }
+        rollback();
+        return false;
+    }
+
+    bool add_clause(int p, int q)
+    {
+        graph[compliment(p)].push_back(q);
+        graph[compliment(q)].push_back(p);
+
+        if (!satisfiable) return false;
+        if (is_true(p) || is_true(q)) return true;
+
+        satisfiable = try_literal(p) || try_literal(q);
+        return satisfiable;
+    }
+
+public:
+
+    explicit IncrementalSAT2(int n) : n(n), graph(n * 2), satisfiable(true),
+        var_values(n, false), locked(n, false) {}
+
+    static inline int index_of(int x) { return x * 2; }
+    static inline int reverse_index_of(int x) { return x / 2; }
+    static inline int compliment(int x) { return x ^ 1; }
+    static inline bool is_compliment(int x) { return x % 2; }
+
+    // Each of these returns whether the
+    // clauses are still satisfiable.
+
+    bool add_implication(int p, int q) {
+        return add_clause(compliment(p), q);
+    }
+
+    bool force_true(int x) {
+        return add_clause(x, x);
+    }
+
+    bool force_false(int x) {
+        return force_true(compliment(x));
+    }
+
+    bool add_or(int p, int q) {
+        return add_clause(p, q);
+    }
+
+    bool add_xor(int p, int q) {
+        add_or(p, q);
+        return add_or(compliment(p), compliment(q));
+    }
+
+    bool add_bidirectional_implication(int p, int q) {
+        return add_xor(compliment(p), q);
+    }
+
+    bool is_satisfiable() const {
+        return satisfiable;
+    }
+
+    // Same as SAT2::solve, returns an empty vector if there is no solution.
+    std::vector<bool> solve() const
+    {
+        if (!satisfiable) return {};
+        return var_values;
+    }
+
+    // Returns a solution where all the given literals are true, or an empty
+    // vector if there is none. The clauses themselves are not changed.
+    std::vector<bool> solve_with_assumptions(const std::vector<int>& literals)
+    {
+        if (!satisfiable) return {};
+
+        bool possible = true;
+        for (int literal : literals) {
+            if (!propagate(literal)) {
+                possible = false;
+                break;
+            }
+        }
+
+        std::vector<bool> result;
+        if (possible) result = var_values;
+        rollback();
+        return result;
+    }
+};
+
+// The code below is a copy of "2-Satisfiability.cpp", used only to compare against.
+
+// The returned component_of are sorted in a reverse topological order.
+std::vector<int> get_SCCs(const Graph& graph)
+{
+    int n = graph.size();
+
+    std::vector<int> result(n);
+
+    int last_id = 0;
+    int last_component_number = 0;
+    std::vector<int> id(n, UNVISITED);
+    std::vector<int> low_link(n);
+    std::vector<bool> on_stack(n, false);
+    std::stack<int> stack;
+
+    std::function<void(int)> dfs = [&](int x)
+    {
+        id[x] = low_link[x] = last_id++;
+        stack.push(x);
+        on_stack[x] = true;
+
+        for (int neighbour : graph[x])
+        {
+            // self-loops shouldn't be a problem.
+
+            if (id[neighbour] == UNVISITED) {
+                dfs(neighbour);
+                low_link[x] = std::min(low_link[x], low_link[neighbour]);
+            } else if (on_stack[neighbour]) {
+                low_link[x] = std::min(low_link[x], low_link[neighbour]);
+                // this will also work.
+                // low_link[x] = std::min(low_link[x], id[neighbour]);
+            }
+        }
+
+        if (low_link[x] == id[x]) {
+            while (stack.top() != x) {
+                int node = stack.top();
+                stack.pop();
+                on_stack[node] = false;
+                result[node] = last_component_number;
+            }
+            // TODO remove code duplication.
+            stack.pop();
+            on_stack[x] = false;
+            result[x] = last_component_number;
+            last_component_number++;
+        }
+    };
+
+    for (int i = 0; i < n; i++) {
+        if (id[i] == UNVISITED) {
+            dfs(i);
+        }
+    }
+
+    return result;
+}
+
+class SAT2
+{
+    // Solves a CNF (Conjunctive Normal Form) with
+    //  each clause containing at most 2 variables.
+    // Anything that can be represented in terms of implication can be
+    //  solved. Examples: or, xor, and bidirectional implication (equality)
+
+    // a variable and its complement are stored next to each other.
+    //  x0 -> 0, !x0 -> 1. In general, xi -> 2 * i, !xi -> 2 * i + 1.
+
+    int n;
+    Graph graph;
+
+    int components_count;
+    Graph components_graph;
+    Graph components_graph_transpose;
+
+    std::vector<int> component_of;
+    std::vector<int> component_val;  // this is unnecessary
+    std::vector<std::vector<int>> components;
+
+    std::vector<bool> var_values;
+
+    void set_components()
+    {
+        // TODO this looks like a lot of
+        //  work. optimize this function.
+
+        components.clear();
+        components_graph.clear();
+        components_graph_transpose.clear();
+
+        component_of = get_SCCs(graph);
+
+        // TODO optimize this.
+        components_count = 0;
+        for (int i = 0; i < graph.size(); i++) {
+            components_count = std::max(components_count, component_of[i]);
+        }
+        components_count++;
+
+        component_val.resize(components_count, UNKNOWN);
+        components.resize(components_count);
+        components_graph.resize(components_count);
+        components_graph_transpose.resize(components_count);
+
+        for (int i = 0; i < graph.size(); i++) {
+            components[component_of[i]].push_back(i);
+        }
+
+        for (int i = 0; i < graph.size(); i++) {
+            for (int neighbour : graph[i]) {
+                if (component_of[i] != component_of[neighbour]) {
+                    int a = component_of[i];
+                    int b = component_of[neighbour];
+                    components_graph[a].push_back(b);
+                    components_graph_transpose[b].push_back(a);
+                }
+            }
+        }
+    }
+
+    int component_compliment(int component)
+    {
+        int x = components[component].front();
+        return component_of[compliment(x)];
+    }
+
+    void set_var_value(int var, int value)
+    {
+        int index = reverse_index_of(var);
+        var_values[index] = value ^ is_compliment(var);
+    }
+
+    void set_component_value(int i, bool value)
+    {
+        component_val[i] = value;
+
+        // for every cycle in the graph (a component), there will be
+        //  an exact same cycle with the variables being negated. this
+        //  means that each component has a complement component.
+        int j = component_compliment(i);
+        if (component_val[j] == UNKNOWN)
+        {
+            // set the variables only if they're
+            //  not set from the complement component.
+            for (int var : components[i]) {
+                set_var_value(var, value);
+            }
+
+            set_component_value(j, !value);
+        }
+
+        // For a logical implication p -> q:
+        //  - if p is true , then q must be true
+        //  - if q is false, then p must be false
+        // If a -> b -> c -> d:
+        //  if b is true, then we're certain that both c and d
+        //  (and anything after b in the chain) are true, but
+        //  we still don't know the value of a (and anything
+        //  before b in the chain).
+        //  similarly, if c is false, then we're certain that both
+        //  b and a (and anything before c in the chain) are false,
+        //  but we still don't know the value of d (and anything
+        //  after c in the chain).
+        const Graph& g = value ? components_graph : components_graph_transpose;
+        for (int component : g[i]) {
+            set_component_value(component, value);
+        }
+    }
+
+public:
+
+    explicit SAT2(int n) : n(n), graph(n * 2) {}
+
+    static inline int index_of(int x) {
+        // TODO find a clean way to
+        //  get rid of this function.
+        return x * 2;
+    }
+
+    static inline int reverse_index_of(int x) {
+        return x / 2;
+    }
+
+    static inline int compliment(int x) {
+        // 4 -> 5
+        // 5 -> 4
+        return x ^ 1;
+    }
+
+    static inline bool is_compliment(int x) {
+        return x % 2;
+    }
+
+    void add_implication(int p, int q) {
+        graph[p].push_back(q);
+    }
+
+    void force_true(int x) {
+        // equivalent to (x or x)
+        add_implication(compliment(x), x);
+    }
+
+    void force_false(int x) {
+        force_true(compliment(x));
+    }
+
+    void add_or(int p, int q) {
+        // if p is false, then q must be true.
+        //  otherwise, the expression will be
+        //  false. so, p is false implies q.
+        // same for q and p.
+        add_implication(compliment(p), q);
+        add_implication(compliment(q), p);
+    }
+
+    void add_xor(int p, int q) {
+        add_or(p, q);
+        add_or(compliment(p), compliment(q));
+    }
+
+    void add_bidirectional_implication(int p, int q) {
+        add_xor(compliment(p), q);
+    }
+
+    bool has_no_solution()
+    {
+        for (int i = 0; i < n; i++) {
+            // !x ->  x = x is true.
+            //  x -> !x = x is false.
+            // !x -> x and x -> !x means
+            //  x is both true and false.
+            // Thus, if x and !x are in a
+            // cycle, there is no solution.
+            int x = index_of(i);
+            if (component_of[x] == component_of[compliment(x)]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<bool> solve()
+    {
+        // For a logical implication p -> q:
+        //  - if p is true , then q must be true
+        //  - if q is false, then p must be false
+        // If a -> b -> c -> a (a, b, and c are in a cycle),
+        //  it means that all of them must have the same value.
+        // Since all variables in a cycle have the same value,
+        //  it makes sense work with the strongly connected components.
+        // Computing the SCCs doesn't only reduce the number of nodes
+        //  to work with, but also converts the graph to a DAG which
+        //  is needed for the following code to work properly.
+
+        // TODO if there is no solution, some unnecessary
+        //  computations are done (anything other than the
+        //  computation of component_of).
+        set_components();
+
+        if (has_no_solution()) {
+            return {};
+        }
+
+        var_values.resize(n);
+
+        // For a logical implication p -> q:
+        //  - if q is true , then p can be true or false.
+        //  using this fact, if a component doesn't imply other
+        //  components, we'll set it to be true and set all the other
+        //  relating components to their corresponding values, and
+        //  consider it removed from the graph, and repeat until
+        //  we're done.
+        // Luckily, Tarjan's algorithm returns the components sorted
+        //  in a reverse topological order. which means that we can
+        //  just iterate over the components without trying to compute
+        //  the reverse topological order.
+        for (int i = 0; i < components_count; i++) {
+            if (component_val[i] == UNKNOWN) {
+                set_component_value(i, true);
+            }
+        }
+
+        return var_values;
+    }
+};
+
+
+struct Clause
+{
+    int p;
+    int q;
+};
+
+std::vector<Clause> get_random_clauses(int n, int count, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<Clause> clauses(count);
+    for (Clause& clause : clauses) {
+        clause = {(int)(random() % (2 * n)), (int)(random() % (2 * n))};
+    }
+    return clauses;
+}
+
+bool satisfies(const std::vector<Clause>& clauses, int count, const std::vector<bool>& values)
+{
+    auto is_true = [&](int literal) { return values[literal / 2] != (literal % 2); };
+    for (int i = 0; i < count; i++) {
+        if (!is_true(clauses[i].p) && !is_true(clauses[i].q)) return false;
+    }
+    return true;
+}
+
+void test(int n, const std::vector<Clause>& clauses)
+{
+    IncrementalSAT2 sat(n);
+    for (const Clause& clause : clauses) {
+        std::cout << "Adding (" << (clause.p % 2 ? "!x" : "x") << clause.p / 2 << " or "
+                  << (clause.q % 2 ? "!x" : "x") << clause.q / 2 << "): ";
+        std::cout << (sat.add_or(clause.p, clause.q) ? "satisfiable" : "no solution") << std::endl;
+    }
+    auto res = sat.solve();
+    for (int i = 0; i < res.size(); i++) {
+        std::cout << "x" << i << ": " << res[i] << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(17);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 30;
+        auto clauses = get_random_clauses(n, 1 + random() % (3 * n), t);
+
+        IncrementalSAT2 incremental(n);
+        SAT2 sat(n);
+
+        for (int i = 0; i < clauses.size(); i++)
+        {
+            bool result = incremental.add_or(clauses[i].p, clauses[i].q);
+            sat.add_or(clauses[i].p, clauses[i].q);
+
+            SAT2 copy = sat;
+            bool expected = !copy.solve().empty();
+
+            if (result != expected) {
+                std::cout << "Wrong answer!" << std::endl;
+                break;
+            }
+
+            if (result && !satisfies(clauses, i + 1, incremental.solve())) {
+                std::cout << "Wrong assignment!" << std::endl;
+                break;
+            }
+
+            if (!result) break;
+
+            // Every literal can be assumed on its own. The answer must
+            // match adding it as a clause to a copy of the instance.
+            int literal = random() % (2 * n);
+            auto assumed = incremental.solve_with_assumptions({literal});
+            SAT2 forced = sat;
+            forced.force_true(literal);
+            if (assumed.empty() != forced.solve().empty())
+                std::cout << "Wrong answer under assumptions!" << std::endl;
+            if (!assumed.empty() && (!satisfies(clauses, i + 1, assumed) || assumed[literal / 2] == (literal % 2)))
+                std::cout << "Wrong assignment under assumptions!" << std::endl;
+        }
+    }
+}
+
+// Adds the clauses one by one, and checks the
+// satisfiability after each one, until there is none.
+void time_test(int n, int clauses_count, bool run_from_scratch)
+{
+    auto clauses = get_random_clauses(n, clauses_count, 2024);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    IncrementalSAT2 incremental(n);
+    int incremental_added = 0;
+    for (const Clause& clause : clauses) {
+        incremental_added++;
+        if (!incremental.add_or(clause.p, clause.q)) break;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    std::cout << n << " variables, no solution after " << incremental_added << " clauses" << std::endl;
+    std::cout << "Incremental: " << us << " micro-seconds ("
+              << incremental_added * 1'000'000LL / std::max(1LL, (long long)us) << " clauses/sec)" << std::endl;
+
+    if (!run_from_scratch) {
+        std::cout << std::endl;
+        return;
+    }
+
+    start = std::chrono::high_resolution_clock::now();
+    SAT2 sat(n);
+    int added = 0;
+    for (const Clause& clause : clauses) {
+        added++;
+        sat.add_or(clause.p, clause.q);
+        SAT2 copy = sat;
+        if (copy.solve().empty()) break;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    std::cout << "From scratch: " << us << " micro-seconds ("
+              << added * 1'000'000LL / std::max(1LL, (long long)us) << " clauses/sec)" << std::endl;
+
+    if (added != incremental_added)
+        std::cout << "Different answers!" << std::endl;
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test(3, {{V(0), V(1)}, {nV(0), V(2)}, {nV(1), nV(2)}, {V(0), nV(1)}, {nV(0), nV(2)}});
+
+    random_test(300);
+
+    time_test(1000, 10000, true);
+    time_test(2000, 20000, true);
+    time_test(1'000'000, 10'000'000, false);
+}
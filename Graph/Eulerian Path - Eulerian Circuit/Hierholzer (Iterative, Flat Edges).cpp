@@ -0,0 +1,611 @@
+#include <iostream>
+#include <functional>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+// Hierholzer's algorithm, without recursion, for directed and undirected
+//  multigraphs given as a flat array of edges. The conditions for a path or a
+//  circuit are the same as in "Directed Graph.cpp" and "Undirected Graph.cpp".
+
+enum class EulerianPathType
+{
+    None=0, Path, Circuit
+};
+
+struct Edge
+{
+    int from;
+    int to;
+};
+
+class EulerianPathFinder
+{
+    // All the nodes and their edges are in one flat array. The block of each
+    //  node is:
+    //   [node, next, end, the edges out of it...]
+    //  where next is the position of the first edge out of it that wasn't used
+    //  yet (the cursor of the node), and end is the end of its block. Each edge
+    //  stores the position of the block of its target instead of the node, so
+    //  moving to the next node reads one place in the array.
+    //
+    // An undirected edge is in the blocks of both of its ends, as
+    //  [target block, position of the same edge in the other block]. When it's
+    //  used from one end, its copy in the other block is marked as used, so
+    //  removing it is O(1), and the other end skips it when its cursor gets to it.
+    //
+    // The DFS keeps the current path on a stack. When the node on top has no
+    //  unused edges left, it's popped and added to the result, which builds the
+    //  path backwards, and the cycles found later are spliced into it in the
+    //  right places, like in the recursive version.
+    //
+    // On large graphs, almost all the time goes to cache misses, since each step
+    //  goes to a random node. With this layout, a step is usually one miss (the
+    //  block of the next node), and marking the other copy of an undirected edge
+    //  is a write that nothing waits for. While popping, the nodes further down
+    //  the stack are known in advance, so their blocks are prefetched.
+    //
+    // The connectivity isn't checked up front: if some edges aren't reached from
+    //  the start, the path is shorter than the number of edges + 1.
+
+    static const int HEADER_SIZE = 3;
+    static const int USED = -1;
+    static const int PREFETCH_DISTANCE = 16;
+
+    int nodes_count;
+    long long edges_count;
+    bool is_directed;
+
+    std::vector<int> graph;
+    std::vector<int> block_of;
+
+    // outdegree - indegree for directed graphs, and the degree for undirected graphs.
+    std::vector<int> balance;
+
+    int edge_size() const {
+        return is_directed ? 1 : 2;
+    }
+
+    void init_graph(const std::vector<Edge>& edges)
+    {
+        std::vector<int> degree(nodes_count, 0);
+        balance.assign(nodes_count, 0);
+        for (auto& edge : edges) {
+            degree[edge.from]++;
+            balance[edge.from]++;
+            if (is_directed) {
+                balance[edge.to]--;
+            } else {
+                degree[edge.to]++;
+                balance[edge.to]++;
+            }
+        }
+
+        block_of.resize(nodes_count);
+        long long size = 0;
+        for (int i = 0; i < nodes_count; i++) {
+            block_of[i] = size;
+            size += HEADER_SIZE + (long long)degree[i] * edge_size();
+        }
+
+        graph.resize(size);
+        for (int i = 0; i < nodes_count; i++) {
+            int block = block_of[i];
+            graph[block] = i;
+            graph[block + 1] = block + HEADER_SIZE;
+            graph[block + 2] = block + HEADER_SIZE + degree[i] * edge_size();
+        }
+
+        // The cursors are used as the next free places while filling.
+        for (auto& edge : edges)
+        {
+            int from_block = block_of[edge.from];
+            int to_block = block_of[edge.to];
+            if (is_directed) {
+                graph[graph[from_block + 1]++] = to_block;
+            } else {
+                int from_position = graph[from_block + 1];
+                graph[from_block + 1] += 2;
+                int to_position = graph[to_block + 1];
+                graph[to_block + 1] += 2;
+                graph[from_position] = to_block;
+                graph[from_position + 1] = to_position;
+                graph[to_position] = from_block;
+                graph[to_position + 1] = from_position;
+            }
+        }
+
+        for (int i = 0; i < nodes_count; i++)
+            graph[block_of[i] + 1] = block_of[i] + HEADER_SIZE;
+    }
+
+    bool has_edges(int node) const {
+        return graph[block_of[node] + 2] > block_of[node] + HEADER_SIZE;
+    }
+
+    // The start of the path, or -1 if there are no edges.
+    int get_start_node() const
+    {
+        int start_node = -1;
+        for (int i = 0; i < nodes_count; i++)
+        {
+            if (!has_edges(i))
+                continue;
+
+            if (start_node == -1)
+                start_node = i;
+
+            bool is_path_start = is_directed ? balance[i] == 1 : balance[i] % 2 == 1;
+            if (is_path_start)
+                return i;
+        }
+        return start_node;
+    }
+
+public:
+
+    EulerianPathFinder(int nodes_count, const std::vector<Edge>& edges, bool is_directed) :
+        nodes_count(nodes_count), edges_count(edges.size()), is_directed(is_directed)
+    {
+        init_graph(edges);
+    }
+
+    // Only from the degrees, the connectivity is checked by get_eulerian_path.
+    EulerianPathType compute_path_type() const
+    {
+        // {-1, 0, 1} for directed graphs, and {even, odd} for undirected graphs.
+        int count[3] = {0, 0, 0};
+        for (int i = 0; i < nodes_count; i++)
+        {
+            if (is_directed) {
+                if (abs(balance[i]) > 1) return EulerianPathType::None;
+                count[balance[i] + 1]++;
+            } else {
+                count[balance[i] % 2]++;
+            }
+        }
+
+        if (is_directed) {
+            if (count[1] == nodes_count) return EulerianPathType::Circuit;
+            if (count[0] <= 1 && count[2] <= 1) return EulerianPathType::Path;
+        } else {
+            if (count[0] == nodes_count) return EulerianPathType::Circuit;
+            if (count[1] == 2) return EulerianPathType::Path;
+        }
+        return EulerianPathType::None;
+    }
+
+    // The nodes of the path in order, or empty if there is no path (or no
+    //  edges). This uses up the edges, so it can only be called once.
+    std::vector<int> get_eulerian_path()
+    {
+        if (compute_path_type() == EulerianPathType::None)
+            return {};
+
+        int start_node = get_start_node();
+        if (start_node == -1)
+            return {};
+
+        std::vector<int> result;
+        result.reserve(edges_count + 1);
+        std::vector<int> stack = {block_of[start_node]};
+
+        while (!stack.empty())
+        {
+            int block = stack.back();
+            int& next = graph[block + 1];
+            int end = graph[block + 2];
+
+            if (!is_directed) {
+                while (next < end && graph[next] == USED)
+                    next += 2;
+            }
+
+            if (next == end) {
+                result.push_back(graph[block]);
+                stack.pop_back();
+                if (stack.size() > PREFETCH_DISTANCE)
+                    __builtin_prefetch(&graph[stack[stack.size() - PREFETCH_DISTANCE]]);
+                continue;
+            }
+
+            int to_block = graph[next];
+            if (is_directed) {
+                next++;
+            } else {
+                graph[graph[next + 1]] = USED;
+                next += 2;
+            }
+            stack.push_back(to_block);
+        }
+
+        if (result.size() != edges_count + 1) {
+            // disconnected
+            return {};
+        }
+
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+};
+
+typedef std::vector<std::vector<int>> Graph;
+
+// A copy of "Directed Graph.cpp", used only to compare against.
+namespace directed
+{
+
+std::vector<int> get_indegree(const Graph& graph)
+{
+    std::vector<int> indegree(graph.size(), 0);
+
+    for (const auto &node : graph) {
+        for (int neighbour : node) {
+            indegree[neighbour]++;
+        }
+    }
+
+    return indegree;
+}
+
+EulerianPathType compute_path_type(const Graph& graph)
+{
+    int n = graph.size();
+
+    auto indegree = get_indegree(graph);
+
+    // {in-out = -1, in-out = 0, in-out = 1}
+    int count[3] = {0, 0, 0};
+    for (int i = 0; i < n; i++) {
+        int diff = indegree[i] - graph[i].size();
+        if (abs(diff) > 1) return EulerianPathType::None;
+        count[diff + 1]++;
+    }
+
+    if (count[1] == n) return EulerianPathType::Circuit;
+    if (count[0] <= 1 && count[2] <= 1) return EulerianPathType::Path;
+    return EulerianPathType::None;
+}
+
+std::vector<int> get_eulerian_path(const Graph& graph)
+{
+    if (compute_path_type(graph) == EulerianPathType::None) {
+        return {};
+    }
+
+    int n = graph.size();
+    std::vector<int> result;
+
+    int edge_count = 0;
+    for (int i = 0; i < n; i++) {
+        edge_count += graph[i].size();
+    }
+
+    // TODO this is being computed twice.
+    auto indegree = get_indegree(graph);
+
+    int start_node = -1;
+    for (int i = 0; i < n; i++)
+    {
+        if (graph[i].empty())
+            continue;
+
+        start_node = i;
+
+        if (indegree[i] - graph[i].size() == 1)
+            break;
+    }
+
+    std::vector<int> last_index(n, 0);
+    std::function<void(int)> find_path = [&](int x) {
+        while (last_index[x] < graph[x].size()) {
+            int neighbour = graph[x][last_index[x]++];
+            find_path(neighbour);
+        }
+        result.push_back(x);
+    };
+
+    find_path(start_node);
+
+    if (result.size() != edge_count + 1) {
+        // disconnected
+        return {};
+    }
+
+    return result;
+}
+
+}
+
+// A copy of "Undirected Graph.cpp", used only to compare against.
+namespace undirected
+{
+
+EulerianPathType compute_path_type(const Graph& graph)
+{
+    // odd degree count and
+    // even degree count.
+    int count[2] = {0, 0};
+
+    for (int i = 0; i < graph.size(); i++) {
+        count[graph[i].size() % 2]++;
+    }
+
+    if (count[0] == graph.size()) return EulerianPathType::Circuit;
+    if (count[1] == 2) return EulerianPathType::Path;
+    return EulerianPathType::None;
+}
+
+std::vector<int> get_eulerian_path(const Graph& graph)
+{
+    if (compute_path_type(graph) == EulerianPathType::None) {
+        return {};
+    }
+
+    int n = graph.size();
+    std::vector<int> result;
+
+    // adjMatrix[i][j] = number of edges from i to j (or j to i).
+    std::vector<std::vector<int>> adjMatrix(n, std::vector<int>(n, 0));
+
+    int edge_count = 0;
+
+    for (int i = 0; i < n; i++) {
+        edge_count += graph[i].size();
+        for (int neighbour : graph[i]) {
+            // adjMatrix[neighbour][i] will
+            // be incremented when i = neighbour.
+            adjMatrix[i][neighbour]++;
+        }
+    }
+
+    // every edge will be counted
+    // twice, once from each end.
+    edge_count /= 2;
+
+    int start_node = -1;
+    for (int i = 0; i < n; i++)
+    {
+        if (graph[i].empty())
+            continue;
+
+        start_node = i;
+
+        if (graph[i].size() % 2 == 1)
+            break;
+    }
+
+    std::vector<int> last_index(n, 0);
+    std::function<void(int)> find_path = [&](int x) {
+        while (last_index[x] < graph[x].size()) {
+            int neighbour = graph[x][last_index[x]++];
+            if (adjMatrix[x][neighbour]) {
+                adjMatrix[x][neighbour]--;
+                adjMatrix[neighbour][x]--;
+                find_path(neighbour);
+            }
+        }
+        result.push_back(x);
+    };
+
+    find_path(start_node);
+
+    if (result.size() != edge_count + 1) {
+        // disconnected
+        return {};
+    }
+
+    return result;
+}
+
+}
+
+Graph get_graph(int nodes_count, const std::vector<Edge>& edges, bool is_directed)
+{
+    Graph graph(nodes_count);
+    for (auto& edge : edges) {
+        graph[edge.from].push_back(edge.to);
+        if (!is_directed) graph[edge.to].push_back(edge.from);
+    }
+    return graph;
+}
+
+// The edges of the samples in "Directed Graph.cpp" and "Undirected Graph.cpp".
+std::vector<Edge> get_directed_edges_with_circuit()
+{
+    return {{2, 1}, {1, 5}, {3, 2}, {5, 2}, {2, 6}, {4, 3}, {3, 5}, {6, 3}, {6, 4}, {5, 6}};
+}
+
+std::vector<Edge> get_directed_edges_with_path()
+{
+    auto edges = get_directed_edges_with_circuit();
+    edges.pop_back();
+    return edges;
+}
+
+std::vector<Edge> get_undirected_edges_with_circuit()
+{
+    return {{1, 2}, {1, 2}, {1, 3}, {1, 3}, {1, 4}, {1, 4}};
+}
+
+std::vector<Edge> get_undirected_edges_with_none()
+{
+    return {{1, 2}, {3, 4}};
+}
+
+void test(int nodes_count, const std::vector<Edge>& edges, bool is_directed)
+{
+    const char* types[] = {"None", "Path", "Circuit"};
+    EulerianPathFinder finder(nodes_count, edges, is_directed);
+    std::cout << types[(int)finder.compute_path_type()] << std::endl;
+    std::cout << "Nodes: ";
+    for (int node : finder.get_eulerian_path()) {
+        std::cout << node << ' ';
+    }
+    std::cout << std::endl << std::endl;
+}
+
+// Whether the path uses each edge exactly once.
+bool is_valid_path(const std::vector<int>& path, const std::vector<Edge>& edges, bool is_directed)
+{
+    if (path.size() != edges.size() + 1) return false;
+
+    auto get_key = [&](int from, int to) {
+        if (!is_directed && from > to) std::swap(from, to);
+        return ((long long)from << 32) | to;
+    };
+
+    std::vector<long long> expected, found;
+    expected.reserve(edges.size());
+    found.reserve(edges.size());
+    for (auto& edge : edges) expected.push_back(get_key(edge.from, edge.to));
+    for (int i = 0; i + 1 < (int)path.size(); i++) found.push_back(get_key(path[i], path[i + 1]));
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    return expected == found;
+}
+
+// Whether all the nodes with edges are connected, ignoring the directions.
+bool is_connected(int nodes_count, const std::vector<Edge>& edges)
+{
+    auto graph = get_graph(nodes_count, edges, false);
+    std::vector<char> visited(nodes_count, false);
+    std::vector<int> stack;
+    int edges_reached = 0;
+    for (int i = 0; i < nodes_count && stack.empty(); i++) {
+        if (!graph[i].empty()) {
+            stack.push_back(i);
+            visited[i] = true;
+        }
+    }
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        edges_reached += graph[node].size();
+        for (int neighbour : graph[node]) {
+            if (!visited[neighbour]) {
+                visited[neighbour] = true;
+                stack.push_back(neighbour);
+            }
+        }
+    }
+    return edges_reached == 2 * (int)edges.size();
+}
+
+// A few random walks, so the graph is often (but not always) Eulerian.
+std::vector<Edge> get_random_edges(int nodes_count, std::mt19937& random)
+{
+    std::vector<Edge> edges;
+    int walks = 1 + random() % 3;
+    for (int w = 0; w < walks; w++)
+    {
+        int start = random() % nodes_count;
+        int node = start;
+        int length = random() % 30;
+        for (int i = 0; i < length; i++) {
+            int next = random() % nodes_count;
+            edges.push_back({node, next});
+            node = next;
+        }
+        if (random() % 2 && length > 0) edges.push_back({node, start});
+    }
+    std::shuffle(edges.begin(), edges.end(), random);
+    return edges;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(43);
+    for (int t = 0; t < tests; t++)
+    {
+        int nodes_count = 1 + random() % 10;
+        auto edges = get_random_edges(nodes_count, random);
+
+        for (bool is_directed : {true, false})
+        {
+            EulerianPathFinder finder(nodes_count, edges, is_directed);
+            auto path = finder.get_eulerian_path();
+
+            auto graph = get_graph(nodes_count, edges, is_directed);
+            auto type = is_directed ? directed::compute_path_type(graph) : undirected::compute_path_type(graph);
+            bool has_path = !edges.empty() && type != EulerianPathType::None && is_connected(nodes_count, edges);
+
+            if (finder.compute_path_type() != type || path.empty() == has_path ||
+                (has_path && !is_valid_path(path, edges, is_directed))) {
+                std::cout << "Wrong Eulerian path!" << std::endl;
+                return;
+            }
+        }
+    }
+}
+
+// The de Bruijn graph of order k over an alphabet: the nodes are the words of
+//  length k - 1, and each word of length k is an edge from its prefix to its
+//  suffix. Every node has alphabet edges in and out, so it has a circuit. The
+//  edges are shuffled, like k-mers that come in any order.
+std::vector<Edge> get_de_bruijn_edges(int alphabet, int k, int& nodes_count)
+{
+    nodes_count = 1;
+    for (int i = 0; i < k - 1; i++) nodes_count *= alphabet;
+
+    std::vector<Edge> edges((size_t)nodes_count * alphabet);
+    for (long long word = 0; word < (long long)edges.size(); word++)
+        edges[word] = {(int)(word / alphabet), (int)(word % nodes_count)};
+
+    std::mt19937 random(k);
+    std::shuffle(edges.begin(), edges.end(), random);
+    return edges;
+}
+
+void time_test(int alphabet, int k, bool run_original, bool check)
+{
+    int nodes_count;
+    auto edges = get_de_bruijn_edges(alphabet, k, nodes_count);
+    std::cout << "de Bruijn graph, alphabet " << alphabet << ", k = " << k << ": "
+              << nodes_count << " nodes, " << edges.size() << " edges" << std::endl;
+
+    for (bool is_directed : {true, false})
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto path = EulerianPathFinder(nodes_count, edges, is_directed).get_eulerian_path();
+        auto end = std::chrono::high_resolution_clock::now();
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        std::cout << (is_directed ? "Directed" : "Undirected") << ", iterative: " << ms << " ms, "
+                  << (double)edges.size() / std::max<long long>(ms, 1) / 1000 << "M edges per second" << std::endl;
+
+        if (check && !is_valid_path(path, edges, is_directed)) std::cout << "Wrong Eulerian path!" << std::endl;
+        if (!check && path.size() != edges.size() + 1) std::cout << "Wrong Eulerian path!" << std::endl;
+        path = {};
+
+        if (run_original)
+        {
+            // The original is recursive (one level per edge), and the undirected
+            //  one uses an adjacency matrix, so they only run on small graphs.
+            auto graph = get_graph(nodes_count, edges, is_directed);
+            start = std::chrono::high_resolution_clock::now();
+            auto original_path = is_directed ? directed::get_eulerian_path(graph) : undirected::get_eulerian_path(graph);
+            end = std::chrono::high_resolution_clock::now();
+            ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+            std::cout << (is_directed ? "Directed" : "Undirected") << ", recursive: " << ms << " ms" << std::endl;
+            if (original_path.size() != edges.size() + 1) std::cout << "Wrong Eulerian path!" << std::endl;
+        }
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test(7, get_directed_edges_with_circuit(), true);
+    test(7, get_directed_edges_with_path(), true);
+    test(5, get_undirected_edges_with_circuit(), false);
+    test(5, get_undirected_edges_with_none(), false);
+    random_test(1000);
+
+    time_test(4, 6, true, true);
+    time_test(4, 7, true, true);
+    time_test(4, 12, false, true);
+    time_test(4, 13, false, false);
+}
@@ -0,0 +1,499 @@
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+const int UNMATCHED = -1;
+const int NO_PARENT = -1;
+const int SOURCE = -2;
+const int INF = 1e9;
+
+struct Edge
+{
+    // Let A and B be the two sets of the bipartite graph.
+    // a is always the node in set A and b is always the
+    // node in set B.
+    int a;
+    int b;
+};
+
+class FastMaximumBipartiteMatchingCalculator
+{
+    // A Hopcroft-Karp implementation tuned for large graphs:
+    //  - The graph is stored in a flat (CSR) layout. The neighbours of the node
+    //    a are adjacency[offsets[a]..offsets[a + 1]). Only the edges going out of
+    //    the nodes of A are stored, since the B -> A direction is always the
+    //    matched edge, which is already known from matched_with.
+    //  - The matching starts from a greedy matching, which usually matches most
+    //    of the nodes, leaving only a few phases for Hopcroft-Karp.
+    //  - All the buffers used by the phases (distances, queue, DFS stack and
+    //    edge cursors) are allocated once and reused across phases.
+    //  - The DFS is iterative, so long augmenting paths don't overflow the stack.
+
+    int n;
+    std::vector<int> sources;
+    std::vector<int> offsets;
+    std::vector<int> adjacency;
+    std::vector<int> matched_with;
+
+    // Phase buffers
+    std::vector<int> distance;
+    std::vector<int> queue;
+    std::vector<int> stack;
+    std::vector<int> next_edge;
+
+    void construct_graph(const std::vector<Edge>& edges)
+    {
+        offsets.assign(n + 1, 0);
+        for (const Edge& edge : edges) {
+            offsets[edge.a + 1]++;
+        }
+        for (int i = 0; i < n; i++) {
+            offsets[i + 1] += offsets[i];
+        }
+
+        adjacency.resize(edges.size());
+        std::vector<int> position(offsets.begin(), offsets.end() - 1);
+        for (const Edge& edge : edges) {
+            adjacency[position[edge.a]++] = edge.b;
+        }
+
+        for (int a = 0; a < n; a++) {
+            if (offsets[a] != offsets[a + 1]) {
+                sources.push_back(a);
+            }
+        }
+    }
+
+    void greedy_matching()
+    {
+        // Matching the nodes with fewer options first leaves the
+        // nodes with more options for later, which results in a
+        // bigger initial matching (the same idea as Karp-Sipser).
+        std::vector<int> order = sources;
+        std::sort(order.begin(), order.end(), [&](int x, int y) {
+            return offsets[x + 1] - offsets[x] < offsets[y + 1] - offsets[y];
+        });
+
+        for (int a : order) {
+            for (int i = offsets[a]; i < offsets[a + 1]; i++) {
+                int b = adjacency[i];
+                if (matched_with[b] == UNMATCHED) {
+                    matched_with[a] = b;
+                    matched_with[b] = a;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Layers the nodes of A by their distance from the free nodes of A.
+    // Returns whether a free node in B is reachable.
+    bool calculate_layers()
+    {
+        int head = 0, tail = 0;
+        for (int a : sources) {
+            if (matched_with[a] == UNMATCHED) {
+                distance[a] = 0;
+                queue[tail++] = a;
+            } else {
+                distance[a] = INF;
+            }
+        }
+
+        bool found_free_node = false;
+        while (head < tail)
+        {
+            int a = queue[head++];
+            for (int i = offsets[a]; i < offsets[a + 1]; i++) {
+                int next = matched_with[adjacency[i]];
+                if (next == UNMATCHED) {
+                    found_free_node = true;
+                } else if (distance[next] == INF) {
+                    distance[next] = distance[a] + 1;
+                    queue[tail++] = next;
+                }
+            }
+        }
+
+        return found_free_node;
+    }
+
+    bool augment_path(int root)
+    {
+        int top = 0;
+        stack[top++] = root;
+
+        while (top > 0)
+        {
+            int a = stack[top - 1];
+
+            if (next_edge[a] == offsets[a + 1]) {
+                // Dead end, no need to visit it again in this phase.
+                distance[a] = INF;
+                top--;
+                if (top > 0) next_edge[stack[top - 1]]++;
+                continue;
+            }
+
+            int b = adjacency[next_edge[a]];
+            int next = matched_with[b];
+
+            if (next == UNMATCHED) {
+                // Each node in the stack takes the B node its cursor points to.
+                // The old partner of that B node is the next node in the stack.
+                for (int i = 0; i < top; i++) {
+                    int node = stack[i];
+                    int partner = adjacency[next_edge[node]];
+                    matched_with[node] = partner;
+                    matched_with[partner] = node;
+                    // Keeps the paths of the same phase vertex-disjoint.
+                    distance[node] = INF;
+                }
+                return true;
+            }
+
+            if (distance[next] == distance[a] + 1) {
+                stack[top++] = next;
+            } else {
+                next_edge[a]++;
+            }
+        }
+
+        return false;
+    }
+
+public:
+
+    FastMaximumBipartiteMatchingCalculator(int n, const std::vector<Edge>& edges)
+        : n(n), matched_with(n), distance(n), queue(n), stack(n), next_edge(n)
+    {
+        construct_graph(edges);
+    }
+
+    std::vector<Edge> solve()
+    {
+        std::fill(matched_with.begin(), matched_with.end(), UNMATCHED);
+
+        greedy_matching();
+
+        while (calculate_layers())
+        {
+            for (int a : sources) {
+                next_edge[a] = offsets[a];
+            }
+
+            bool augmented = false;
+            for (int a : sources) {
+                if (matched_with[a] == UNMATCHED && distance[a] == 0) {
+                    augmented |= augment_path(a);
+                }
+            }
+
+            if (!augmented) break;
+        }
+
+        std::vector<Edge> result;
+        for (int a : sources) {
+            if (matched_with[a] != UNMATCHED) {
+                result.push_back({a, matched_with[a]});
+            }
+        }
+
+        return result;
+    }
+};
+
+// The implementations below are copies of the ones in "Hopcroft-Karp - O(E . sqrt(V)).cpp"
+// and "Kuhn - O(EV).cpp", and are only used to compare against.
+
+typedef std::vector<std::vector<int>> Graph;
+
+class MaximumBipartiteMatchingCalculator
+{
+    std::vector<Edge> edges;
+    std::vector<int> matched_with;
+    std::vector<int> parent_of;
+    std::vector<int> sources;
+    Graph graph;
+
+    void construct_graph()
+    {
+        for (Edge &edge : edges) {
+            graph[edge.a].push_back(edge.b);
+            graph[edge.b].push_back(edge.a);
+        }
+    }
+
+    void augment_path(int child)
+    {
+        bool match = true;
+        int parent = parent_of[child];
+        while (parent != SOURCE) {
+            if (match) {
+                matched_with[child] = parent;
+                matched_with[parent] = child;
+            }
+            child = parent;
+            parent = parent_of[parent];
+            match = !match;
+        }
+    }
+
+    bool augment_paths()
+    {
+        std::fill(parent_of.begin(), parent_of.end(), NO_PARENT);
+
+        std::queue<int> queue;
+        for (int source : sources) {
+            if (matched_with[source] == UNMATCHED) {
+                queue.push(source);
+                parent_of[source] = SOURCE;
+            }
+        }
+
+        bool found_augmenting_path = false;
+
+        while (!queue.empty())
+        {
+            int node = queue.front();
+            queue.pop();
+
+            for (int child : graph[node])
+            {
+                if (parent_of[child] != NO_PARENT) continue;
+                parent_of[child] = node;
+
+                if (matched_with[child] == UNMATCHED) {
+                    augment_path(child);
+                    found_augmenting_path = true;
+                    break;
+                } else {
+                    queue.push(child);
+                }
+            }
+        }
+
+        return found_augmenting_path;
+    }
+
+public:
+
+    MaximumBipartiteMatchingCalculator(int n, std::vector<Edge> edges)
+            : edges(std::move(edges)), matched_with(n), parent_of(n), graph(n)
+    {
+        construct_graph();
+    }
+
+    std::vector<Edge> solve()
+    {
+        std::vector<Edge> result;
+
+        sources.clear();
+        std::vector<bool> visited(graph.size(), false);
+        for (const Edge& edge : edges) {
+            if (!visited[edge.a]) {
+                sources.push_back(edge.a);
+                visited[edge.a] = true;
+            }
+        }
+
+        std::fill(matched_with.begin(), matched_with.end(), UNMATCHED);
+
+        while (augment_paths());
+
+        for (int source : sources) {
+            if (matched_with[source] != UNMATCHED) {
+                result.push_back({source, matched_with[source]});
+            }
+        }
+
+        return result;
+    }
+};
+
+class KuhnMaximumBipartiteMatchingCalculator
+{
+    std::vector<Edge> edges;
+    std::vector<bool> visited;
+    std::vector<int> matched_with;
+    Graph graph;
+
+    void construct_graph()
+    {
+        for (Edge &edge : edges) {
+            graph[edge.a].push_back(edge.b);
+            graph[edge.b].push_back(edge.a);
+        }
+    }
+
+    bool try_matching(int node)
+    {
+        if (visited[node]) {
+            return false;
+        }
+        visited[node] = true;
+
+        for (int neighbour : graph[node]) {
+            int matched_node = matched_with[neighbour];
+            if (matched_node == -1 || try_matching(matched_node)) {
+                matched_with[node] = neighbour;
+                matched_with[neighbour] = node;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+public:
+
+    KuhnMaximumBipartiteMatchingCalculator(int n, std::vector<Edge> edges)
+        : edges(std::move(edges)), visited(n), matched_with(n), graph(n)
+    {
+        construct_graph();
+    }
+
+    std::vector<Edge> solve()
+    {
+        std::vector<Edge> result;
+
+        std::fill(visited.begin(), visited.end(), false);
+        std::vector<int> A;
+        for (Edge& edge : edges) {
+            if (!visited[edge.a]) {
+                A.push_back(edge.a);
+                visited[edge.a] = true;
+            }
+        }
+
+        std::fill(matched_with.begin(), matched_with.end(), -1);
+
+        for (int a : A) {
+            std::fill(visited.begin(), visited.end(), false);
+            if (matched_with[a] == -1) {
+                try_matching(a);
+            }
+        }
+
+        for (int a : A) {
+            if (matched_with[a] != -1) {
+                result.push_back({a, matched_with[a]});
+            }
+        }
+
+        return result;
+    }
+};
+
+std::vector<Edge> get_sample_graph_1()
+{
+    std::vector<Edge> edges;
+
+    edges.push_back({0, 7});
+    edges.push_back({0, 8});
+    edges.push_back({2, 6});
+    edges.push_back({2, 9});
+    edges.push_back({3, 8});
+    edges.push_back({4, 8});
+    edges.push_back({4, 9});
+    edges.push_back({5, 11});
+
+    return edges;
+}
+
+std::vector<Edge> get_sample_graph_2()
+{
+    std::vector<Edge> edges;
+
+    edges.push_back({0, 4});
+    edges.push_back({0, 5});
+    edges.push_back({1, 5});
+    edges.push_back({1, 6});
+    edges.push_back({2, 6});
+    edges.push_back({2, 7});
+    edges.push_back({3, 4});
+
+    return edges;
+}
+
+// Nodes [0, half) are in A, and nodes [half, 2 * half) are in B.
+std::vector<Edge> get_random_graph(int half, int degree)
+{
+    std::vector<Edge> edges;
+    for (int a = 0; a < half; a++) {
+        for (int i = 0; i < degree; i++) {
+            edges.push_back({a, half + rand() % half});
+        }
+    }
+    return edges;
+}
+
+int get_nodes_count(const std::vector<Edge>& edges)
+{
+    int n = 0;
+    for (const Edge& edge : edges) {
+        n = std::max(n, std::max(edge.a, edge.b) + 1);
+    }
+    return n;
+}
+
+void test(const std::vector<Edge>& edges)
+{
+    auto result = FastMaximumBipartiteMatchingCalculator(get_nodes_count(edges), edges).solve();
+
+    for (const Edge& edge : result) {
+        std::cout << edge.a << " --- " << edge.b << std::endl;
+    }
+
+    std::cout << "Number of matches: " << result.size() << std::endl << std::endl;
+}
+
+template <typename Calculator>
+int time_test(const std::string& name, const std::vector<Edge>& edges, int n)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    int matches = Calculator(n, edges).solve().size();
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    std::cout << name << ": " << matches << " matches (" << ms << " ms)" << std::endl;
+    return matches;
+}
+
+void compare(int nodes_count, int degree, bool include_kuhn)
+{
+    int half = nodes_count / 2;
+    auto edges = get_random_graph(half, degree);
+    std::cout << "V = " << 2 * half << ", E = " << edges.size() << std::endl;
+
+    int fast = time_test<FastMaximumBipartiteMatchingCalculator>("CSR Hopcroft-Karp", edges, 2 * half);
+
+    // The BFS of the current Hopcroft-Karp keeps going after augmenting a
+    // path, using the stale parents of the flipped nodes, so it can stop
+    // before reaching a maximum matching. It's only timed here, and Kuhn
+    // is used to validate the size of the matching.
+    time_test<MaximumBipartiteMatchingCalculator>("Hopcroft-Karp", edges, 2 * half);
+
+    if (include_kuhn) {
+        // Kuhn is O(EV), and its recursion depth can reach V,
+        // so it's only run on the smaller graphs.
+        int kuhn = time_test<KuhnMaximumBipartiteMatchingCalculator>("Kuhn", edges, 2 * half);
+        if (fast != kuhn)
+            std::cout << "Wrong matching size!" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test(get_sample_graph_1());
+    test(get_sample_graph_2());
+
+    compare(20000, 3, true);
+    compare(100000, 3, false);
+    compare(1000000, 3, false);
+}
@@ -0,0 +1,578 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+
+struct Edge
+{
+    // Unlike the cardinality matching files, a and b are indexed
+    // separately here: a is in [0, |A|) and b is in [0, |B|).
+    // Weights are expected to be non-negative, since a negative
+    // edge is never worth taking over leaving both nodes unmatched.
+    int a;
+    int b;
+    int weight;
+};
+
+typedef std::vector<std::vector<long long>> Matrix;
+
+// Both algorithms solve the assignment problem on a square matrix. Missing
+// edges (and the padding needed when |A| != |B|) get a weight of 0, which
+// means "not matched", so a maximum weight perfect assignment on the matrix
+// is a maximum weight matching on the original graph.
+Matrix get_weight_matrix(int a_count, int b_count, const std::vector<Edge>& edges)
+{
+    int n = std::max(a_count, b_count);
+    Matrix weights(n, std::vector<long long>(n, 0));
+    for (const Edge& edge : edges) {
+        weights[edge.a][edge.b] = std::max(weights[edge.a][edge.b], (long long)edge.weight);
+    }
+    return weights;
+}
+
+std::vector<Edge> get_matched_edges(const Matrix& weights, const std::vector<int>& assigned_to)
+{
+    std::vector<Edge> result;
+    for (int a = 0; a < assigned_to.size(); a++) {
+        int b = assigned_to[a];
+        if (b != -1 && weights[a][b] > 0) {
+            result.push_back({a, b, (int)weights[a][b]});
+        }
+    }
+    return result;
+}
+
+class HungarianCalculator
+{
+    // The O(n^3) version of the Hungarian algorithm, based on potentials.
+    // Read more here: https://cp-algorithms.com/graph/hungarian-algorithm.html
+    //
+    // The algorithm minimizes the cost, so the weights are negated. The rows
+    // (nodes of A) are added one by one. Each time, a Dijkstra-like search over
+    // the columns finds the cheapest way (with respect to the reduced costs
+    // cost[i][j] - u[i] - v[j]) to fit the new row in, by shifting some of the
+    // already assigned rows to other columns. The potentials are updated while
+    // searching so that the reduced costs of the assigned pairs stay 0, which
+    // makes each search O(n^2), and the whole algorithm O(n^3).
+
+    int n;
+    Matrix weights;
+
+public:
+
+    HungarianCalculator(int a_count, int b_count, const std::vector<Edge>& edges)
+        : n(std::max(a_count, b_count)), weights(get_weight_matrix(a_count, b_count, edges)) {}
+
+    std::vector<Edge> solve()
+    {
+        const long long INF = LLONG_MAX / 4;
+
+        // 1-indexed, column 0 is a fake column that holds
+        // the row currently being added.
+        std::vector<long long> u(n + 1, 0), v(n + 1, 0);
+        std::vector<int> row_of(n + 1, 0);
+        std::vector<int> previous_column(n + 1, 0);
+        std::vector<long long> min_reduced_cost(n + 1);
+        std::vector<bool> used(n + 1);
+
+        for (int row = 1; row <= n; row++)
+        {
+            row_of[0] = row;
+            int column = 0;
+            std::fill(min_reduced_cost.begin(), min_reduced_cost.end(), INF);
+            std::fill(used.begin(), used.end(), false);
+
+            do {
+                used[column] = true;
+                int i = row_of[column];
+                long long delta = INF;
+                int next_column = 0;
+
+                for (int j = 1; j <= n; j++) {
+                    if (used[j]) continue;
+                    long long reduced_cost = -weights[i - 1][j - 1] - u[i] - v[j];
+                    if (reduced_cost < min_reduced_cost[j]) {
+                        min_reduced_cost[j] = reduced_cost;
+                        previous_column[j] = column;
+                    }
+                    if (min_reduced_cost[j] < delta) {
+                        delta = min_reduced_cost[j];
+                        next_column = j;
+                    }
+                }
+
+                for (int j = 0; j <= n; j++) {
+                    if (used[j]) {
+                        u[row_of[j]] += delta;
+                        v[j] -= delta;
+                    } else {
+                        min_reduced_cost[j] -= delta;
+                    }
+                }
+
+                column = next_column;
+            } while (row_of[column] != 0);
+
+            // Shift the rows along the alternating path.
+            do {
+                int previous = previous_column[column];
+                row_of[column] = row_of[previous];
+                column = previous;
+            } while (column != 0);
+        }
+
+        std::vector<int> assigned_to(n, -1);
+        for (int j = 1; j <= n; j++) {
+            assigned_to[row_of[j] - 1] = j - 1;
+        }
+
+        return get_matched_edges(weights, assigned_to);
+    }
+};
+
+class AuctionCalculator
+{
+    // Each unassigned node of A (a bidder) looks for the node of B (an object)
+    // with the best value = weight - price, and bids for it, raising its price
+    // by the difference between the best and the second best values plus eps.
+    // The object goes to the highest bidder, and its old owner becomes unassigned.
+    //
+    // The assignment at the end is within n * eps of the optimum. The weights
+    // are multiplied by (n + 1), so that with eps = 1, the error is less than
+    // one unit of the original weights, which makes the result optimal since
+    // the weights are integers. eps is scaled down from a large value, keeping
+    // the prices between the phases, which makes the number of bids much
+    // smaller than running with eps = 1 from the start.
+    //
+    // This is the Jacobi version of the algorithm: all the unassigned bidders
+    // compute their bids at the same time against the same prices, which is
+    // what gets split across the threads. The bids are then resolved per object.
+
+    int n;
+    int threads_count;
+    Matrix weights;
+    Matrix scaled_weights;
+
+    std::vector<long long> price;
+    std::vector<int> owner_of;
+    std::vector<int> assigned_to;
+
+    std::vector<int> bid_object;
+    std::vector<long long> bid_value;
+
+    void compute_bid(int bidder, long long eps)
+    {
+        const std::vector<long long>& row = scaled_weights[bidder];
+
+        long long best = LLONG_MIN, second_best = LLONG_MIN;
+        int best_object = 0;
+        for (int object = 0; object < n; object++) {
+            long long value = row[object] - price[object];
+            if (value > best) {
+                second_best = best;
+                best = value;
+                best_object = object;
+            } else if (value > second_best) {
+                second_best = value;
+            }
+        }
+
+        // With a single object, there is nothing to compete with.
+        if (second_best == LLONG_MIN) second_best = best;
+
+        bid_object[bidder] = best_object;
+        bid_value[bidder] = price[best_object] + (best - second_best) + eps;
+    }
+
+    void compute_bids(const std::vector<int>& bidders, long long eps)
+    {
+        // Starting threads isn't worth it for a small amount of work.
+        long long work = (long long)bidders.size() * n;
+        int threads = (work < (1 << 16)) ? 1 : threads_count;
+
+        if (threads == 1) {
+            for (int bidder : bidders) compute_bid(bidder, eps);
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        int chunk = (bidders.size() + threads - 1) / threads;
+        for (int t = 0; t < threads; t++) {
+            int begin = t * chunk;
+            int end = std::min((int)bidders.size(), begin + chunk);
+            if (begin >= end) break;
+            workers.emplace_back([&, begin, end]() {
+                for (int i = begin; i < end; i++) compute_bid(bidders[i], eps);
+            });
+        }
+        for (auto& worker : workers) worker.join();
+    }
+
+    void run_phase(long long eps)
+    {
+        std::fill(owner_of.begin(), owner_of.end(), -1);
+        std::fill(assigned_to.begin(), assigned_to.end(), -1);
+
+        std::vector<int> bidders(n);
+        for (int i = 0; i < n; i++) bidders[i] = i;
+
+        std::vector<int> best_bidder(n, -1);
+
+        while (!bidders.empty())
+        {
+            compute_bids(bidders, eps);
+
+            std::vector<int> touched_objects;
+            for (int bidder : bidders) {
+                int object = bid_object[bidder];
+                int& best = best_bidder[object];
+                if (best == -1) touched_objects.push_back(object);
+                if (best == -1 || bid_value[bidder] > bid_value[best]) best = bidder;
+            }
+
+            std::vector<int> next_bidders;
+            for (int bidder : bidders) {
+                if (best_bidder[bid_object[bidder]] != bidder) {
+                    next_bidders.push_back(bidder);
+                }
+            }
+
+            for (int object : touched_objects) {
+                int winner = best_bidder[object];
+                best_bidder[object] = -1;
+
+                if (owner_of[object] != -1) {
+                    assigned_to[owner_of[object]] = -1;
+                    next_bidders.push_back(owner_of[object]);
+                }
+                owner_of[object] = winner;
+                assigned_to[winner] = object;
+                price[object] = bid_value[winner];
+            }
+
+            bidders.swap(next_bidders);
+        }
+    }
+
+public:
+
+    AuctionCalculator(int a_count, int b_count, const std::vector<Edge>& edges,
+                      int threads_count = std::max(1u, std::thread::hardware_concurrency()))
+        : n(std::max(a_count, b_count)), threads_count(threads_count),
+          weights(get_weight_matrix(a_count, b_count, edges)), price(n), owner_of(n),
+          assigned_to(n), bid_object(n), bid_value(n)
+    {
+        scaled_weights = weights;
+        for (auto& row : scaled_weights) {
+            for (long long& weight : row) weight *= (n + 1);
+        }
+    }
+
+    std::vector<Edge> solve()
+    {
+        long long max_weight = 1;
+        for (auto& row : scaled_weights) {
+            for (long long weight : row) max_weight = std::max(max_weight, weight);
+        }
+
+        std::fill(price.begin(), price.end(), 0);
+
+        long long eps = std::max(1LL, max_weight / 4);
+        while (true) {
+            run_phase(eps);
+            if (eps == 1) break;
+            eps = std::max(1LL, eps / 5);
+        }
+
+        return get_matched_edges(weights, assigned_to);
+    }
+};
+
+// A copy of the calculator in "Minimum Cost Flow/Ford-Fulkerson with Bellman-Ford.cpp",
+// used only to cross-validate the results. The only change is that Bellman-Ford
+// doesn't relax edges going out of unreached nodes, since the costs can be negative.
+
+const int MAX_VAL = 1'000'000;
+
+class Graph : public std::vector<std::vector<int>>
+{
+    std::vector<std::vector<int>> weights;
+    std::vector<std::vector<int>> costs;
+
+public:
+
+    explicit Graph(int n) : std::vector<std::vector<int>>(n),
+                            weights(n, std::vector<int>(n, 0)),
+                            costs(n, std::vector<int>(n, 0)) {}
+
+    void add_weight(int from, int to, int weight) {
+        if (weights[from][to] == 0) {
+            (*this)[from].push_back(to);
+        }
+        weights[from][to] += weight;
+    }
+
+    void add_weight(int from, int to, int weight, int cost)
+    {
+        add_weight(from, to, weight);
+        costs[from][to] += cost;
+        costs[to][from] -= cost;
+    }
+
+    int get_weight(int from, int to) const { return weights[from][to]; }
+    int get_cost(int from, int to) const { return costs[from][to]; }
+};
+
+class MinCostFlowCalculator
+{
+    struct FlowEdge
+    {
+        int from;
+        int to;
+        int weight;
+    };
+
+    int source;
+    int sink;
+    const Graph flow_graph;
+    Graph residual_graph;
+
+    int get_flow_value(int from, int to) const
+    {
+        int a = flow_graph.get_weight(to, from);
+        int b = residual_graph.get_weight(to, from);
+        return b - a;
+    }
+
+    std::vector<FlowEdge> get_residual_edges_with_remaining_capacity() const
+    {
+        std::vector<FlowEdge> result;
+        for (int from = 0; from < residual_graph.size(); from++) {
+            for (int to: residual_graph[from]) {
+                int weight = residual_graph.get_weight(from, to);
+                if (weight > 0) {
+                    result.push_back({from, to, weight});
+                }
+            }
+        }
+        return result;
+    }
+
+    std::vector<FlowEdge> get_shortest_augmenting_path()
+    {
+        std::vector<FlowEdge> edges = get_residual_edges_with_remaining_capacity();
+
+        int V = residual_graph.size();
+        std::vector<int> minimum_cost(V, MAX_VAL);
+        std::vector<FlowEdge> prev_edge(V, {-1, -1, -1});
+
+        minimum_cost[source] = 0;
+
+        for (int i = 0; i < V - 1; i++)
+        {
+            bool relaxed = false;
+
+            for (auto &e : edges)
+            {
+                if (minimum_cost[e.from] == MAX_VAL) continue;
+
+                int cost = residual_graph.get_cost(e.from, e.to);
+                int old_cost = minimum_cost[e.to];
+                int new_cost = minimum_cost[e.from] + cost;
+
+                if (new_cost < old_cost) {
+                    minimum_cost[e.to] = new_cost;
+                    prev_edge[e.to] = e;
+                    relaxed = true;
+                }
+            }
+
+            if (!relaxed) {
+                break;
+            }
+        }
+
+        if (prev_edge[sink].to != sink) {
+            return {};
+        }
+
+        std::vector<FlowEdge> path;
+        for (int node = sink; node != source; node = prev_edge[node].from)
+            path.push_back(prev_edge[node]);
+
+        return path;
+    }
+
+    int add_shortest_augmenting_path()
+    {
+        std::vector<FlowEdge> path = get_shortest_augmenting_path();
+
+        if (path.empty()) return 0;
+
+        int bottleneck = MAX_VAL;
+        for (FlowEdge &e : path)
+            bottleneck = std::min(bottleneck, e.weight);
+
+        for (FlowEdge &e : path)
+        {
+            residual_graph.add_weight(e.from, e.to, -bottleneck);
+            residual_graph.add_weight(e.to, e.from,  bottleneck);
+        }
+
+        return bottleneck;
+    };
+
+public:
+
+    MinCostFlowCalculator(const Graph& graph)
+        : flow_graph(graph), residual_graph({}) {}
+
+    int get_min_cost(int source, int sink)
+    {
+        residual_graph = flow_graph;
+        this->source = source;
+        this->sink = sink;
+        while (add_shortest_augmenting_path() != 0);
+
+        int cost = 0;
+        for (int from = 0; from < flow_graph.size(); from++) {
+            for (int to : flow_graph[from]) {
+                int value = get_flow_value(from, to);
+                if (value > 0) cost += value * flow_graph.get_cost(from, to);
+            }
+        }
+        return cost;
+    }
+};
+
+// source = 0, A = [1, n], B = [n + 1, 2n], sink = 2n + 1. Every pair (a, b)
+// gets an edge with a cost of -weight (0 for missing edges), so the minimum
+// cost of a flow of n units is the negated maximum weight of a matching.
+long long get_max_weight_using_min_cost_flow(int a_count, int b_count, const std::vector<Edge>& edges)
+{
+    int n = std::max(a_count, b_count);
+    Matrix weights = get_weight_matrix(a_count, b_count, edges);
+
+    Graph graph(2 * n + 2);
+    int source = 0, sink = 2 * n + 1;
+    for (int i = 0; i < n; i++) {
+        graph.add_weight(source, 1 + i, 1, 0);
+        graph.add_weight(1 + n + i, sink, 1, 0);
+        for (int j = 0; j < n; j++) {
+            graph.add_weight(1 + i, 1 + n + j, 1, -weights[i][j]);
+        }
+    }
+
+    return -MinCostFlowCalculator(graph).get_min_cost(source, sink);
+}
+
+long long total_weight(const std::vector<Edge>& edges)
+{
+    long long total = 0;
+    for (const Edge& edge : edges) total += edge.weight;
+    return total;
+}
+
+std::vector<Edge> get_sample_graph()
+{
+    std::vector<Edge> edges;
+
+    edges.push_back({0, 0, 7});
+    edges.push_back({0, 1, 5});
+    edges.push_back({1, 0, 6});
+    edges.push_back({1, 2, 3});
+    edges.push_back({2, 1, 8});
+    edges.push_back({2, 2, 2});
+    edges.push_back({3, 1, 9});
+
+    return edges;
+}
+
+std::vector<Edge> get_random_graph(int a_count, int b_count, int degree, int max_weight)
+{
+    std::vector<Edge> edges;
+    for (int a = 0; a < a_count; a++) {
+        for (int i = 0; i < degree; i++) {
+            edges.push_back({a, rand() % b_count, rand() % max_weight});
+        }
+    }
+    return edges;
+}
+
+void test(int a_count, int b_count, const std::vector<Edge>& edges)
+{
+    auto result = HungarianCalculator(a_count, b_count, edges).solve();
+
+    for (const Edge& edge : result) {
+        std::cout << edge.a << " --" << edge.weight << "-- " << edge.b << std::endl;
+    }
+
+    std::cout << "Total weight: " << total_weight(result) << std::endl;
+    std::cout << "Auction total weight: " << total_weight(AuctionCalculator(a_count, b_count, edges).solve()) << std::endl;
+    std::cout << "Min cost flow total weight: " << get_max_weight_using_min_cost_flow(a_count, b_count, edges) << std::endl << std::endl;
+}
+
+void cross_validation_test(int tests)
+{
+    for (int i = 0; i < tests; i++)
+    {
+        int a_count = 1 + rand() % 20;
+        int b_count = 1 + rand() % 20;
+        auto edges = get_random_graph(a_count, b_count, 1 + rand() % b_count, 1000);
+
+        long long expected = get_max_weight_using_min_cost_flow(a_count, b_count, edges);
+        long long hungarian = total_weight(HungarianCalculator(a_count, b_count, edges).solve());
+        long long auction = total_weight(AuctionCalculator(a_count, b_count, edges).solve());
+
+        if (hungarian != expected)
+            std::cout << "Wrong Hungarian weight!" << std::endl;
+
+        if (auction != expected)
+            std::cout << "Wrong auction weight!" << std::endl;
+    }
+}
+
+template <typename Calculator>
+long long time_test(const std::string& name, int n, const std::vector<Edge>& edges, int repetitions)
+{
+    long long weight = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < repetitions; i++) {
+        weight = total_weight(Calculator(n, n, edges).solve());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    std::cout << name << ": weight " << weight << ", " << us / repetitions << " micro-seconds per instance ("
+              << (long long)n * repetitions * 1'000'000 / std::max(1LL, (long long)us) << " agents/sec)" << std::endl;
+    return weight;
+}
+
+void compare(int n, int degree, int repetitions)
+{
+    auto edges = get_random_graph(n, n, degree, 1'000'000);
+    std::cout << n << " agents, " << edges.size() << " edges" << std::endl;
+
+    long long hungarian = time_test<HungarianCalculator>("Hungarian", n, edges, repetitions);
+    long long auction = time_test<AuctionCalculator>("Auction", n, edges, repetitions);
+
+    if (hungarian != auction)
+        std::cout << "Different weights!" << std::endl;
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test(4, 3, get_sample_graph());
+
+    cross_validation_test(200);
+
+    compare(100, 100, 50);
+    compare(500, 50, 3);
+    compare(1000, 1000, 1);
+}
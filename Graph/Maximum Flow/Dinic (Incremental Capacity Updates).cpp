@@ -0,0 +1,446 @@
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <climits>
+#include <chrono>
+#include <cstdlib>
+
+struct Edge
+{
+    int from;
+    int to;
+    int weight;
+};
+
+class IncrementalMaxFlowCalculator
+{
+    // Same as the Dinic implementation, but the instance is kept
+    // alive after solving, so that capacity changes can be applied
+    // to the current residual graph instead of recomputing the
+    // flow from scratch.
+
+    int source, sink;
+    int flow_value;
+    int nodes_count;
+
+    // capacities[u][v] is the capacity of the edge u -> v, and residual[u][v]
+    // is the remaining capacity that can be pushed from u to v (including the
+    // flow that can be cancelled on the edge v -> u). If g is the net flow
+    // going from u to v, then:
+    //  residual[u][v] = capacities[u][v] - g
+    //  residual[v][u] = capacities[v][u] + g
+    std::vector<std::vector<int>> capacities;
+    std::vector<std::vector<int>> residual;
+
+    // Both directions of every edge are stored, so that the
+    // adjacency lists don't change while augmenting. Each pair is
+    // added once, even if its capacities drop to 0 and come back.
+    std::vector<std::vector<int>> neighbours;
+    std::vector<std::vector<char>> is_neighbour;
+
+    std::vector<int> levels;
+    std::vector<int> next_child_index;
+
+    bool calculate_level_graph(int from, int to)
+    {
+        std::fill(levels.begin(), levels.end(), -1);
+        std::queue<int> queue;
+
+        queue.push(from);
+        levels[from] = 0;
+
+        while (!queue.empty())
+        {
+            int node = queue.front();
+            queue.pop();
+
+            for (int child : neighbours[node]) {
+                if (residual[node][child] > 0 && levels[child] == -1) {
+                    levels[child] = levels[node] + 1;
+                    queue.push(child);
+                }
+            }
+        }
+
+        return levels[to] != -1;
+    }
+
+    int add_augmenting_path(int from, int to, int bottleneck)
+    {
+        if (bottleneck == 0 || from == to) {
+            return bottleneck;
+        }
+
+        for (int& i = next_child_index[from]; i < neighbours[from].size(); i++)
+        {
+            int child = neighbours[from][i];
+            if (levels[child] != (levels[from] + 1)) continue;
+            int weight = residual[from][child];
+            if (weight == 0) continue;
+            int value = add_augmenting_path(child, to, std::min(weight, bottleneck));
+            if (value > 0) {
+                residual[from][child] -= value;
+                residual[child][from] += value;
+                return value;
+            }
+        }
+
+        return 0;
+    }
+
+    // Pushes at most limit units of flow from "from" to "to" through the
+    // residual graph, and returns the amount that got pushed. This is used
+    // both for the usual source -> sink augmentation, and for sending the
+    // excess created by a capacity decrease back to where it came from.
+    int push_flow(int from, int to, int limit = INT_MAX)
+    {
+        int pushed = 0;
+
+        while (pushed < limit && calculate_level_graph(from, to))
+        {
+            std::fill(next_child_index.begin(), next_child_index.end(), 0);
+
+            int bottleneck = -1;
+            while (pushed < limit && bottleneck != 0) {
+                bottleneck = add_augmenting_path(from, to, limit - pushed);
+                pushed += bottleneck;
+            }
+        }
+
+        return pushed;
+    }
+
+    // The net flow going into the sink, which is the value of the flow.
+    int get_sink_inflow() const
+    {
+        int inflow = 0;
+        for (int node = 0; node < nodes_count; node++) {
+            inflow += capacities[node][sink] - residual[node][sink];
+        }
+        return inflow;
+    }
+
+    void add_neighbours(int from, int to)
+    {
+        if (!is_neighbour[from][to]) {
+            is_neighbour[from][to] = is_neighbour[to][from] = true;
+            neighbours[from].push_back(to);
+            neighbours[to].push_back(from);
+        }
+    }
+
+public:
+
+    explicit IncrementalMaxFlowCalculator(const std::vector<Edge>& edges, int nodes_count)
+        : source(-1), sink(-1), flow_value(0), nodes_count(nodes_count),
+          capacities(nodes_count, std::vector<int>(nodes_count, 0)),
+          residual(nodes_count, std::vector<int>(nodes_count, 0)),
+          neighbours(nodes_count), is_neighbour(nodes_count, std::vector<char>(nodes_count, false)),
+          levels(nodes_count), next_child_index(nodes_count)
+    {
+        for (const Edge& edge : edges) {
+            add_neighbours(edge.from, edge.to);
+            capacities[edge.from][edge.to] += edge.weight;
+            residual[edge.from][edge.to] += edge.weight;
+        }
+    }
+
+    // Solves for the given source and sink. Calling it again with the same
+    // terminals keeps the current flow, and with other terminals starts over.
+    int get_max_flow(int source, int sink)
+    {
+        if (source != this->source || sink != this->sink) {
+            this->source = source;
+            this->sink = sink;
+            residual = capacities;
+        }
+
+        push_flow(source, sink);
+        flow_value = get_sink_inflow();
+        return flow_value;
+    }
+
+    // Increasing a capacity only adds residual capacity, so the current
+    // flow remains valid, and we only need to look for new augmenting paths.
+    // Before the first get_max_flow, this only changes the graph.
+    int increase_capacity(int from, int to, int delta)
+    {
+        add_neighbours(from, to);
+        capacities[from][to] += delta;
+        residual[from][to] += delta;
+        if (source == -1) return flow_value;
+
+        push_flow(source, sink);
+        flow_value = get_sink_inflow();
+        return flow_value;
+    }
+
+    int decrease_capacity(int from, int to, int delta)
+    {
+        delta = std::min(delta, capacities[from][to]);
+        capacities[from][to] -= delta;
+        residual[from][to] -= delta;
+
+        // If the residual capacity is still non-negative, the current flow
+        // respects the new capacity. The flow is still maximum because the
+        // capacity of the minimum cut can't increase by decreasing an edge.
+        // This is always the case before the first get_max_flow (no flow).
+        if (residual[from][to] >= 0) {
+            return flow_value;
+        }
+
+        // Otherwise, the net flow on the edge exceeds the new capacity by
+        // "excess" units. Clamping the flow leaves "from" with an excess and
+        // "to" with a deficit of the same amount.
+        int excess = -residual[from][to];
+        residual[from][to] = 0;
+        residual[to][from] -= excess;
+
+        // First, the clamped flow is sent around the edge where possible. This
+        // also cancels the flow of the cycles that went through the edge.
+        excess -= push_flow(from, to, excess);
+
+        // No flow goes from "to" to "from" anymore, so the rest of the excess at
+        // "from" came from the terminals, and can go back to them (and the rest
+        // of the deficit at "to" can be taken back from them). The terminals
+        // themselves don't need to be balanced.
+        if (from != source && from != sink) {
+            int left = excess - push_flow(from, source, excess);
+            push_flow(from, sink, left);
+        }
+        if (to != source && to != sink) {
+            int left = excess - push_flow(sink, to, excess);
+            push_flow(source, to, left);
+        }
+
+        // The removed flow might be reroutable through other paths.
+        push_flow(source, sink);
+        flow_value = get_sink_inflow();
+        return flow_value;
+    }
+
+    int change_capacity(int from, int to, int delta)
+    {
+        if (delta >= 0) return increase_capacity(from, to, delta);
+        return decrease_capacity(from, to, -delta);
+    }
+
+    std::vector<Edge> get_flow_edges() const
+    {
+        std::vector<Edge> result;
+
+        for (int from = 0; from < nodes_count; from++) {
+            for (int to : neighbours[from]) {
+                int value = capacities[from][to] - residual[from][to];
+                if (capacities[from][to] > 0 && value > 0) {
+                    result.push_back({from, to, std::min(value, capacities[from][to])});
+                }
+            }
+        }
+
+        return result;
+    }
+};
+
+std::vector<Edge> get_sample_graph()
+{
+    std::vector<Edge> edges;
+
+    edges.push_back({0, 1, 16});
+    edges.push_back({0, 2, 13});
+    edges.push_back({1, 2, 10});
+    edges.push_back({2, 1, 4});
+    edges.push_back({1, 3, 12});
+    edges.push_back({3, 2, 9});
+    edges.push_back({2, 4, 14});
+    edges.push_back({4, 3, 7});
+    edges.push_back({4, 5, 4});
+    edges.push_back({3, 5, 20});
+
+    return edges;
+}
+
+void print_flow(const IncrementalMaxFlowCalculator& calculator, int total_flow)
+{
+    for (const Edge& edge : calculator.get_flow_edges())
+    {
+        std::cout << edge.from << " --" << edge.weight;
+        if (edge.weight < 10) std::cout << ' ';
+        std::cout << "--> " <<  edge.to << std::endl;
+    }
+    std::cout << "Total Flow: " << total_flow << std::endl << std::endl;
+}
+
+void sample_test()
+{
+    auto edges = get_sample_graph();
+    IncrementalMaxFlowCalculator calculator(edges, 6);
+
+    print_flow(calculator, calculator.get_max_flow(0, 5));
+
+    std::cout << "Decreasing 3 -> 5 by 15" << std::endl;
+    print_flow(calculator, calculator.change_capacity(3, 5, -15));
+
+    std::cout << "Increasing 4 -> 5 by 10" << std::endl;
+    print_flow(calculator, calculator.change_capacity(4, 5, 10));
+}
+
+std::vector<Edge> get_random_graph(int n, int m, int max_weight)
+{
+    std::vector<Edge> edges;
+    for (int i = 0; i < m; i++) {
+        int from = rand() % n;
+        int to = rand() % n;
+        if (from == to) continue;
+        edges.push_back({from, to, 1 + rand() % max_weight});
+    }
+    return edges;
+}
+
+int get_fresh_max_flow(const std::vector<Edge>& edges, int n, int source, int sink) {
+    return IncrementalMaxFlowCalculator(edges, n).get_max_flow(source, sink);
+}
+
+// Applies a random edit to one of the edges (on both the calculator and the
+// edge list), and returns what the calculator says.
+int apply_random_edit(IncrementalMaxFlowCalculator& calculator, std::vector<Edge>& edges, int max_delta)
+{
+    Edge& edge = edges[rand() % edges.size()];
+    int delta = rand() % 2 ? (rand() % max_delta) : -(rand() % max_delta);
+    if (edge.weight + delta < 0) delta = -edge.weight;
+    edge.weight += delta;
+    return calculator.change_capacity(edge.from, edge.to, delta);
+}
+
+bool has_duplicate_flow_edges(const IncrementalMaxFlowCalculator& calculator, int n)
+{
+    std::vector<std::vector<char>> is_seen(n, std::vector<char>(n, false));
+    for (const Edge& edge : calculator.get_flow_edges()) {
+        if (is_seen[edge.from][edge.to]) return true;
+        is_seen[edge.from][edge.to] = true;
+    }
+    return false;
+}
+
+// Small graphs with cycles and edges into the source / out of the sink,
+// edits before the first solve, and changes of the terminals.
+void random_test(int tests)
+{
+    // A graph where the edits used to clamp flow cycles through the source.
+    std::vector<Edge> sample = {{0, 2, 1}, {0, 3, 5}, {1, 0, 5}, {0, 3, 4}, {2, 1, 6}, {3, 0, 6}, {1, 4, 2}};
+
+    // An edge that drops to 0 and comes back shouldn't be listed again.
+    IncrementalMaxFlowCalculator path({{0, 1, 5}, {1, 2, 5}}, 3);
+    path.get_max_flow(0, 2);
+    for (int i = 0; i < 3; i++) {
+        path.change_capacity(0, 1, -5);
+        path.change_capacity(0, 1, 5);
+    }
+    if (path.get_flow_edges().size() != 2) {
+        std::cout << "Wrong flow edges!" << std::endl;
+        return;
+    }
+
+    for (int t = 0; t < tests; t++)
+    {
+        int n = t % 10 == 0 ? 5 : 2 + rand() % 6;
+        std::vector<Edge> edges = t % 10 == 0 ? sample : get_random_graph(n, 1 + rand() % 15, 8);
+        if (edges.empty()) continue;
+
+        IncrementalMaxFlowCalculator calculator(edges, n);
+        for (int i = rand() % 3; i > 0; i--) apply_random_edit(calculator, edges, 8);
+
+        int source = t % 10 == 0 ? 0 : rand() % n;
+        int sink = t % 10 == 0 ? 4 : (source + 1 + rand() % (n - 1)) % n;
+        if (calculator.get_max_flow(source, sink) != get_fresh_max_flow(edges, n, source, sink)) {
+            std::cout << "Wrong flow!" << std::endl;
+            return;
+        }
+
+        for (int i = 0; i < 30; i++)
+        {
+            if (rand() % 10 == 0) {
+                source = rand() % n;
+                sink = (source + 1 + rand() % (n - 1)) % n;
+                calculator.get_max_flow(source, sink);
+            }
+
+            int incremental = apply_random_edit(calculator, edges, 8);
+            if (incremental != get_fresh_max_flow(edges, n, source, sink)) {
+                std::cout << "Wrong flow!" << std::endl;
+                return;
+            }
+
+            // Drops an edge to 0 and brings it back.
+            if (rand() % 3 == 0) {
+                Edge& edge = edges[rand() % edges.size()];
+                int weight = edge.weight;
+                calculator.change_capacity(edge.from, edge.to, -weight);
+                calculator.change_capacity(edge.from, edge.to, weight);
+                if (calculator.get_max_flow(source, sink) != get_fresh_max_flow(edges, n, source, sink)) {
+                    std::cout << "Wrong flow!" << std::endl;
+                    return;
+                }
+            }
+
+            if (has_duplicate_flow_edges(calculator, n)) {
+                std::cout << "Wrong flow edges!" << std::endl;
+                return;
+            }
+        }
+    }
+}
+
+// Applies the same random edits to an incremental instance and to
+// fresh instances, checks that the results match, and times both.
+void time_test(int n, int m, int edits)
+{
+    std::vector<Edge> edges = get_random_graph(n, m, 100);
+    int source = 0;
+    int sink = n - 1;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    IncrementalMaxFlowCalculator calculator(edges, n);
+    calculator.get_max_flow(source, sink);
+    auto end = std::chrono::high_resolution_clock::now();
+    long long initial_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    long long incremental_us = 0;
+    long long recompute_us = 0;
+    bool correct = true;
+
+    for (int i = 0; i < edits; i++)
+    {
+        Edge& edge = edges[rand() % edges.size()];
+        int delta = rand() % 2 ? (rand() % 50) : -(rand() % 50);
+        if (edge.weight + delta < 0) delta = -edge.weight;
+        edge.weight += delta;
+
+        start = std::chrono::high_resolution_clock::now();
+        int incremental = calculator.change_capacity(edge.from, edge.to, delta);
+        end = std::chrono::high_resolution_clock::now();
+        incremental_us += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        int recomputed = IncrementalMaxFlowCalculator(edges, n).get_max_flow(source, sink);
+        end = std::chrono::high_resolution_clock::now();
+        recompute_us += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        if (incremental != recomputed) correct = false;
+    }
+
+    if (!correct)
+        std::cout << "Wrong flow!" << std::endl;
+
+    std::cout << "V = " << n << ", E = " << edges.size() << ", initial flow took " << initial_ms << " ms" << std::endl;
+    std::cout << edits << " edits: incremental took " << incremental_us << " micro-seconds, recomputing took "
+              << recompute_us << " micro-seconds." << std::endl << std::endl;
+}
+
+int main()
+{
+    sample_test();
+    random_test(10000);
+    time_test(100, 1000, 1000);
+    time_test(1000, 20000, 100);
+}
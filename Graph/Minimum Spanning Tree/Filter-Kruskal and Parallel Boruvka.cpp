@@ -0,0 +1,499 @@
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cstdint>
+
+struct Edge
+{
+    int from;
+    int to;
+    int weight;
+
+    bool operator<(const Edge& edge) const {
+        return weight < edge.weight;
+    }
+};
+
+struct Graph
+{
+    int nodes_count;
+    std::vector<Edge> edges;
+
+    Graph(int nodes_count) : nodes_count(nodes_count) {}
+
+    void add_edge(int from, int to, int weight) {
+        add_edge({from, to, weight});
+    }
+
+    void add_edge(const Edge& edge) {
+        edges.push_back(edge);
+    }
+};
+
+struct UnionFind
+{
+    // Optimization: sizes will be stored in the parents array.
+    //  if node x has a parent of -5, this means that x is a
+    //  root and the size of the component (forest) is 5.
+
+    // not using ranks here.
+
+    int node_count;
+    int components; // (forests)
+    std::vector<int> parent;
+
+    UnionFind(int size) : node_count(size), components(size), parent(size, -1) {}
+
+    int parent_of(int x)
+    {
+        if (parent[x] < 0) return x;
+        parent[x] = parent_of(parent[x]);
+        return parent[x];
+    }
+
+    int component_size(int x) {
+        return -parent[parent_of(x)];
+    }
+
+    bool are_connected(int a, int b) {
+        return parent_of(a) == parent_of(b);
+    }
+
+    void connect(int a, int b)
+    {
+        if (are_connected(a, b)) return;
+
+        components--;
+        parent[parent_of(a)] += -component_size(b);
+        parent[parent_of(b)] = parent_of(a);
+    }
+};
+
+struct ConcurrentUnionFind
+{
+    // A union-find that can be used by multiple threads at the same time.
+    // Every parent pointer is an atomic, and all the modifications are
+    // done using compare-and-swap:
+    //  - find uses path halving: each visited node is pointed to its
+    //    grandparent with a CAS. If the CAS fails, another thread already
+    //    moved the node higher, which is just as good.
+    //  - connect links the root with the smaller index under the root with
+    //    the larger index. The CAS only succeeds if the node is still a root,
+    //    otherwise the roots are looked up again. Since links always go from
+    //    smaller to larger indices, no cycles can be formed.
+
+    std::vector<std::atomic<int>> parent;
+
+    ConcurrentUnionFind(int size) : parent(size)
+    {
+        for (int i = 0; i < size; i++) {
+            parent[i].store(i, std::memory_order_relaxed);
+        }
+    }
+
+    int parent_of(int x)
+    {
+        while (true) {
+            int p = parent[x].load(std::memory_order_acquire);
+            if (p == x) return x;
+            int grandparent = parent[p].load(std::memory_order_acquire);
+            if (p != grandparent) {
+                parent[x].compare_exchange_weak(p, grandparent, std::memory_order_acq_rel);
+            }
+            x = grandparent;
+        }
+    }
+
+    bool are_connected(int a, int b)
+    {
+        while (true) {
+            a = parent_of(a);
+            b = parent_of(b);
+            if (a == b) return true;
+            // a is still a root, so they weren't connected at the moment it was read.
+            if (parent[a].load(std::memory_order_acquire) == a) return false;
+        }
+    }
+
+    // Returns whether this call is the one that connected the two components.
+    bool connect(int a, int b)
+    {
+        while (true) {
+            a = parent_of(a);
+            b = parent_of(b);
+            if (a == b) return false;
+            if (a > b) std::swap(a, b);
+            int expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) {
+                return true;
+            }
+        }
+    }
+};
+
+template <typename Function>
+void parallel_for(int threads_count, size_t count, Function function)
+{
+    // Splits [0, count) into contiguous chunks, and calls
+    // function(thread_index, begin, end) for each chunk.
+    if (threads_count == 1) {
+        function(0, (size_t)0, count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    size_t chunk = (count + threads_count - 1) / threads_count;
+    for (int t = 0; t < threads_count; t++) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        threads.emplace_back(function, t, begin, end);
+    }
+    for (auto& thread : threads) thread.join();
+}
+
+Graph get_MST(const Graph& graph)
+{
+    Graph result(graph.nodes_count);
+
+    UnionFind unionFind(graph.nodes_count);
+
+    std::vector<Edge> edges = graph.edges;
+    std::sort(edges.begin(), edges.end());
+
+    for (const Edge& edge : edges) {
+        if (unionFind.are_connected(edge.from, edge.to)) {
+            continue;
+        }
+        result.add_edge(edge);
+        unionFind.connect(edge.from, edge.to);
+    }
+
+    return result;
+}
+
+class FilterKruskal
+{
+    // Kruskal spends most of its time sorting edges that end up being
+    // skipped because their endpoints are already connected. Filter-Kruskal
+    // avoids sorting those edges, quicksort style:
+    //  - Partition the edges around a random pivot weight.
+    //  - Solve the light half first (recursively).
+    //  - Drop the heavy edges whose endpoints got connected by the light half.
+    //  - Solve what's left of the heavy half (recursively).
+    // Small ranges are sorted and processed as in the normal Kruskal.
+    // On dense graphs, most heavy edges get filtered before ever being
+    // sorted, making it close to O(E + V log V log(E / V)) in practice.
+
+    static const int SORT_THRESHOLD = 1024;
+
+    UnionFind unionFind;
+    Graph result;
+    std::mt19937 random;
+
+    void kruskal(std::vector<Edge>::iterator begin, std::vector<Edge>::iterator end)
+    {
+        std::sort(begin, end);
+        for (auto it = begin; it != end; it++) {
+            if (unionFind.are_connected(it->from, it->to)) continue;
+            result.add_edge(*it);
+            unionFind.connect(it->from, it->to);
+        }
+    }
+
+    void solve(std::vector<Edge>::iterator begin, std::vector<Edge>::iterator end)
+    {
+        if (end - begin <= SORT_THRESHOLD) {
+            kruskal(begin, end);
+            return;
+        }
+
+        int pivot = (begin + random() % (end - begin))->weight;
+        auto middle = std::partition(begin, end, [pivot](const Edge& edge) {
+            return edge.weight <= pivot;
+        });
+
+        // The pivot is the maximum weight, split
+        // the edges lighter than it from the rest.
+        if (middle == end) {
+            middle = std::partition(begin, end, [pivot](const Edge& edge) {
+                return edge.weight < pivot;
+            });
+        }
+
+        // All the edges have the same weight, nothing to split on.
+        if (middle == begin) {
+            kruskal(begin, end);
+            return;
+        }
+
+        solve(begin, middle);
+
+        // The tree is complete, the rest of the edges can't be used.
+        if (unionFind.components == 1) return;
+
+        auto heavy_end = std::remove_if(middle, end, [this](const Edge& edge) {
+            return unionFind.are_connected(edge.from, edge.to);
+        });
+        solve(middle, heavy_end);
+    }
+
+public:
+
+    FilterKruskal(int nodes_count) : unionFind(nodes_count), result(nodes_count), random(42) {}
+
+    Graph get_MST(std::vector<Edge> edges)
+    {
+        solve(edges.begin(), edges.end());
+        return result;
+    }
+};
+
+class ParallelBoruvka
+{
+    // In each round, every component picks its cheapest outgoing edge, and all
+    // of these edges are added to the tree at once. Each round at least halves
+    // the number of components, so there are at most log(V) rounds.
+    //
+    // Each round has 3 steps, each of them split across the threads:
+    //  1. For each edge connecting two components, try to set it as the cheapest
+    //     edge of both components using an atomic "fetch-min" (a CAS loop).
+    //  2. For each component, connect it with the other end of its cheapest
+    //     edge using the concurrent union-find. The edges are compared by
+    //     (weight, index), so the picked edges can't form a cycle, and the
+    //     connect call fails only for an edge that was picked by both of its
+    //     components. This way, each picked edge is added exactly once.
+    //  3. Drop the edges that now lie inside a single component.
+
+    const uint64_t NO_EDGE = UINT64_MAX;
+
+    int nodes_count;
+    int threads_count;
+    ConcurrentUnionFind unionFind;
+    std::vector<std::atomic<uint64_t>> cheapest;
+
+    struct ContractedEdge
+    {
+        int from;
+        int to;
+        int weight;
+        int index; // in the original edges
+    };
+
+    static uint64_t get_key(int weight, int index)
+    {
+        // Maps the signed weight to an unsigned value with the same order,
+        // and uses the index to break the ties. The index is stored in an int,
+        // so there can be at most 2^31 - 1 edges.
+        uint64_t key = (uint32_t)weight ^ 0x80000000u;
+        return (key << 32) | (uint32_t)index;
+    }
+
+    void set_cheapest(int component, uint64_t key)
+    {
+        uint64_t current = cheapest[component].load(std::memory_order_relaxed);
+        while (key < current && !cheapest[component].compare_exchange_weak(current, key, std::memory_order_relaxed));
+    }
+
+public:
+
+    ParallelBoruvka(int nodes_count, int threads_count)
+        : nodes_count(nodes_count), threads_count(threads_count),
+          unionFind(nodes_count), cheapest(nodes_count) {}
+
+    Graph get_MST(const std::vector<Edge>& edges)
+    {
+        Graph result(nodes_count);
+
+        std::vector<std::vector<Edge>> thread_results(threads_count);
+        std::vector<std::vector<ContractedEdge>> thread_edges(threads_count);
+
+        std::vector<ContractedEdge> remaining(edges.size());
+        parallel_for(threads_count, edges.size(), [&](int, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                remaining[i] = {edges[i].from, edges[i].to, edges[i].weight, (int)i};
+            }
+        });
+
+        while (!remaining.empty())
+        {
+            parallel_for(threads_count, nodes_count, [&](int, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) cheapest[i].store(NO_EDGE, std::memory_order_relaxed);
+            });
+
+            // The endpoints of the remaining edges are the roots of their components
+            // as of the end of the previous round, so these finds are short.
+            parallel_for(threads_count, remaining.size(), [&](int, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    const ContractedEdge& edge = remaining[i];
+                    uint64_t key = get_key(edge.weight, edge.index);
+                    set_cheapest(edge.from, key);
+                    set_cheapest(edge.to, key);
+                }
+            });
+
+            parallel_for(threads_count, nodes_count, [&](int thread, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    uint64_t key = cheapest[i].load(std::memory_order_relaxed);
+                    if (key == NO_EDGE) continue;
+                    const Edge& edge = edges[key & UINT32_MAX];
+                    if (unionFind.connect(edge.from, edge.to)) {
+                        thread_results[thread].push_back(edge);
+                    }
+                }
+            });
+
+            // Drops the edges inside a single component, and contracts the rest
+            // by replacing their endpoints with the roots of their components.
+            parallel_for(threads_count, remaining.size(), [&](int thread, size_t begin, size_t end) {
+                std::vector<ContractedEdge>& kept = thread_edges[thread];
+                kept.clear();
+                for (size_t i = begin; i < end; i++) {
+                    ContractedEdge edge = remaining[i];
+                    edge.from = unionFind.parent_of(edge.from);
+                    edge.to = unionFind.parent_of(edge.to);
+                    if (edge.from != edge.to) {
+                        kept.push_back(edge);
+                    }
+                }
+            });
+
+            remaining.clear();
+            for (auto& kept : thread_edges) {
+                remaining.insert(remaining.end(), kept.begin(), kept.end());
+            }
+        }
+
+        for (auto& edges_of_thread : thread_results) {
+            result.edges.insert(result.edges.end(), edges_of_thread.begin(), edges_of_thread.end());
+        }
+
+        return result;
+    }
+};
+
+Graph get_graph()
+{
+    Graph graph {6};
+
+    graph.add_edge(2, 1, 8);
+    graph.add_edge(4, 1, 5);
+    graph.add_edge(2, 3, 100);
+    graph.add_edge(5, 3, 3);
+    graph.add_edge(4, 5, 2);
+
+    return graph;
+}
+
+Graph get_random_graph(int n, long long m, int max_weight)
+{
+    std::mt19937 random(1);
+    Graph graph(n);
+    graph.edges.reserve(m + n - 1);
+
+    // A random spanning tree first to make sure the graph is connected.
+    for (int i = 1; i < n; i++) {
+        graph.add_edge(random() % i, i, random() % max_weight);
+    }
+    for (long long i = n - 1; i < m; i++) {
+        graph.add_edge(random() % n, random() % n, random() % max_weight);
+    }
+
+    return graph;
+}
+
+long long get_total_weight(const Graph& graph)
+{
+    long long total = 0;
+    for (const Edge& edge : graph.edges) total += edge.weight;
+    return total;
+}
+
+void print_graph_edges(const Graph& graph)
+{
+    for (const Edge& edge : graph.edges) {
+        std::cout << "From node " << edge.from << " to node "
+            << edge.to << " with weight " << edge.weight << std::endl;
+    }
+}
+
+// The MST isn't unique when weights repeat, so
+// the total weights and edge counts are compared.
+bool same_tree_weight(const Graph& a, const Graph& b)
+{
+    return a.edges.size() == b.edges.size() && get_total_weight(a) == get_total_weight(b);
+}
+
+void correctness_test(int tests)
+{
+    std::mt19937 random(7);
+    for (int i = 0; i < tests; i++)
+    {
+        int n = 1 + random() % 3000;
+        long long m = random() % (10 * n);
+        Graph graph = get_random_graph(n, m, 1 + random() % 100);
+
+        // Some disconnected nodes too.
+        graph.nodes_count += random() % 5;
+
+        Graph expected = get_MST(graph);
+
+        if (!same_tree_weight(expected, FilterKruskal(graph.nodes_count).get_MST(graph.edges)))
+            std::cout << "Wrong filter-Kruskal MST!" << std::endl;
+
+        for (int threads : {1, 4}) {
+            if (!same_tree_weight(expected, ParallelBoruvka(graph.nodes_count, threads).get_MST(graph.edges)))
+                std::cout << "Wrong Boruvka MST with " << threads << " threads!" << std::endl;
+        }
+    }
+}
+
+template <typename Function>
+long long time_ms(Function function)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    function();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+void time_test(int n, long long m)
+{
+    Graph graph = get_random_graph(n, m, 1'000'000'000);
+    std::cout << "V = " << n << ", E = " << graph.edges.size() << std::endl;
+
+    Graph expected(0), result(0);
+
+    long long ms = time_ms([&]() { expected = get_MST(graph); });
+    std::cout << "Kruskal: " << ms << " ms" << std::endl;
+
+    ms = time_ms([&]() { result = FilterKruskal(n).get_MST(graph.edges); });
+    std::cout << "Filter-Kruskal: " << ms << " ms" << std::endl;
+    if (!same_tree_weight(expected, result))
+        std::cout << "Wrong filter-Kruskal MST!" << std::endl;
+
+    int max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        ms = time_ms([&]() { result = ParallelBoruvka(n, threads).get_MST(graph.edges); });
+        std::cout << "Boruvka (" << threads << " threads): " << ms << " ms" << std::endl;
+        if (!same_tree_weight(expected, result))
+            std::cout << "Wrong Boruvka MST!" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    auto graph = get_graph();
+    print_graph_edges(ParallelBoruvka(graph.nodes_count, 2).get_MST(graph.edges));
+    std::cout << std::endl;
+
+    correctness_test(100);
+
+    time_test(100'000, 1'000'000);
+    time_test(1'000'000, 10'000'000);
+}
@@ -0,0 +1,693 @@
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <climits>
+
+struct Edge
+{
+    int from;
+    int to;
+    int weight;
+
+    bool operator<(const Edge& edge) const {
+        return weight < edge.weight;
+    }
+};
+
+struct Graph
+{
+    int nodes_count;
+    std::vector<Edge> edges;
+
+    Graph(int nodes_count) : nodes_count(nodes_count) {}
+
+    void add_edge(int from, int to, int weight) {
+        add_edge({from, to, weight});
+    }
+
+    void add_edge(const Edge& edge) {
+        edges.push_back(edge);
+    }
+};
+
+struct UnionFind
+{
+    // Optimization: sizes will be stored in the parents array.
+    //  if node x has a parent of -5, this means that x is a
+    //  root and the size of the component (forest) is 5.
+
+    // not using ranks here.
+
+    int node_count;
+    int components; // (forests)
+    std::vector<int> parent;
+
+    UnionFind(int size) : node_count(size), components(size), parent(size, -1) {}
+
+    int parent_of(int x)
+    {
+        if (parent[x] < 0) return x;
+        parent[x] = parent_of(parent[x]);
+        return parent[x];
+    }
+
+    int component_size(int x) {
+        return -parent[parent_of(x)];
+    }
+
+    bool are_connected(int a, int b) {
+        return parent_of(a) == parent_of(b);
+    }
+
+    void connect(int a, int b)
+    {
+        if (are_connected(a, b)) return;
+
+        components--;
+        parent[parent_of(a)] += -component_size(b);
+        parent[parent_of(b)] = parent_of(a);
+    }
+};
+
+struct RollbackUnionFind
+{
+    // Same representation as UnionFind, but without path compression, so
+    // that each connect changes exactly 2 entries, which can be saved and
+    // restored later. To keep the trees shallow without path compression,
+    // the smaller component is always linked under the bigger one, which
+    // makes parent_of O(log n).
+
+    struct Change
+    {
+        int child;  // -1 if connect didn't change anything
+        int root;
+        int old_child_value;
+    };
+
+    int node_count;
+    int components; // (forests)
+    std::vector<int> parent;
+    std::vector<Change> history;
+
+    RollbackUnionFind(int size) : node_count(size), components(size), parent(size, -1) {}
+
+    int parent_of(int x)
+    {
+        while (parent[x] >= 0) x = parent[x];
+        return x;
+    }
+
+    bool are_connected(int a, int b) {
+        return parent_of(a) == parent_of(b);
+    }
+
+    bool connect(int a, int b)
+    {
+        a = parent_of(a);
+        b = parent_of(b);
+
+        if (a == b) {
+            history.push_back({-1, -1, 0});
+            return false;
+        }
+
+        // parent holds the negated size
+        if (parent[a] > parent[b]) std::swap(a, b);
+
+        history.push_back({b, a, parent[b]});
+        components--;
+        parent[a] += parent[b];
+        parent[b] = a;
+        return true;
+    }
+
+    // Undoes the last connect call.
+    void rollback()
+    {
+        Change change = history.back();
+        history.pop_back();
+
+        if (change.child == -1) return;
+
+        components++;
+        parent[change.root] -= change.old_child_value;
+        parent[change.child] = change.old_child_value;
+    }
+};
+
+class LinkCutTree
+{
+    // Maintains a forest under link and cut, and answers path maximum queries
+    // in O(log n) amortized. Here, it's used to maintain the minimum spanning
+    // forest: every edge of the graph is represented as a node of its own,
+    // holding the weight of the edge, and connected to its 2 endpoints.
+
+    std::vector<int> parent;
+    std::vector<int> left, right;
+    std::vector<bool> reversed;
+    std::vector<int> value;
+    std::vector<int> max_node; // the node with the max value in the splay subtree
+
+    bool is_root(int x) const {
+        int p = parent[x];
+        return p == -1 || (left[p] != x && right[p] != x);
+    }
+
+    void pull(int x)
+    {
+        max_node[x] = x;
+        if (left[x] != -1 && value[max_node[left[x]]] > value[max_node[x]]) max_node[x] = max_node[left[x]];
+        if (right[x] != -1 && value[max_node[right[x]]] > value[max_node[x]]) max_node[x] = max_node[right[x]];
+    }
+
+    void push(int x)
+    {
+        if (!reversed[x]) return;
+        std::swap(left[x], right[x]);
+        if (left[x] != -1) reversed[left[x]] = !reversed[left[x]];
+        if (right[x] != -1) reversed[right[x]] = !reversed[right[x]];
+        reversed[x] = false;
+    }
+
+    void rotate(int x)
+    {
+        int p = parent[x];
+        int grandparent = parent[p];
+
+        if (!is_root(p)) {
+            if (left[grandparent] == p) left[grandparent] = x;
+            else right[grandparent] = x;
+        }
+        parent[x] = grandparent;
+
+        if (left[p] == x) {
+            left[p] = right[x];
+            if (right[x] != -1) parent[right[x]] = p;
+            right[x] = p;
+        } else {
+            right[p] = left[x];
+            if (left[x] != -1) parent[left[x]] = p;
+            left[x] = p;
+        }
+        parent[p] = x;
+
+        pull(p);
+        pull(x);
+    }
+
+    void splay(int x)
+    {
+        // Push the pending reversals from the root of the splay tree down to x first.
+        std::vector<int>& path = splay_path;
+        path.clear();
+        for (int y = x; ; y = parent[y]) {
+            path.push_back(y);
+            if (is_root(y)) break;
+        }
+        for (int i = path.size() - 1; i >= 0; i--) push(path[i]);
+
+        while (!is_root(x))
+        {
+            int p = parent[x];
+            if (!is_root(p)) {
+                int grandparent = parent[p];
+                bool zig_zig = (left[grandparent] == p) == (left[p] == x);
+                rotate(zig_zig ? p : x);
+            }
+            rotate(x);
+        }
+    }
+
+    // Makes the path from the root of the tree to x preferred.
+    void access(int x)
+    {
+        int last = -1;
+        for (int y = x; y != -1; y = parent[y]) {
+            splay(y);
+            right[y] = last;
+            pull(y);
+            last = y;
+        }
+        splay(x);
+    }
+
+    void make_root(int x)
+    {
+        access(x);
+        reversed[x] = !reversed[x];
+    }
+
+    std::vector<int> splay_path;
+
+public:
+
+    explicit LinkCutTree(const std::vector<int>& values)
+        : parent(values.size(), -1), left(values.size(), -1), right(values.size(), -1),
+          reversed(values.size(), false), value(values), max_node(values.size())
+    {
+        for (int i = 0; i < values.size(); i++) max_node[i] = i;
+    }
+
+    // a and b must be in different trees.
+    void link(int a, int b)
+    {
+        make_root(a);
+        parent[a] = b;
+    }
+
+    // a and b must be adjacent.
+    void cut(int a, int b)
+    {
+        make_root(a);
+        access(b);
+        // a is now the only node before b on the path.
+        left[b] = -1;
+        parent[a] = -1;
+        pull(b);
+    }
+
+    // a and b must be in the same tree.
+    int path_max_node(int a, int b)
+    {
+        make_root(a);
+        access(b);
+        return max_node[b];
+    }
+};
+
+class OfflineDynamicConnectivity
+{
+    // The operations (adding and removing edges) and the queries are first
+    // recorded, then answered all at once by solve(). Each operation and query
+    // gets a time. Each edge is alive during the interval [added, removed), and
+    // this interval is inserted into a segment tree over time, into O(log T) nodes.
+    //
+    // Traversing the segment tree with a DFS, the edges stored in a node are
+    // added when entering it, and removed (rolled back) when leaving it. When
+    // reaching the leaf of time t, exactly the edges alive at time t are added,
+    // and the query at time t can be answered. Since the edges are only removed
+    // in the reverse order of adding them, a union-find with rollback can be used
+    // instead of a fully dynamic structure.
+    //
+    // For the weight of the minimum spanning forest, a link-cut tree is kept along
+    // with the union-find. When adding an edge (u, v) whose endpoints are already
+    // connected, the heaviest edge on the path from u to v in the forest is found.
+    // If it's heavier than the new edge, it's replaced by the new edge, exactly as
+    // in the incremental MST. The links and cuts are recorded, and are undone with
+    // the opposite operation when rolling back.
+    //
+    // Complexity: O((T + E log T) log n) for connectivity, plus an O(log n) amortized
+    // link-cut tree operation per edge addition when there are MST weight queries.
+
+    enum class QueryType
+    {
+        Connected, Components, MSTWeight
+    };
+
+    struct Query
+    {
+        QueryType type;
+        int a;
+        int b;
+    };
+
+    struct ForestChange
+    {
+        bool linked; // false if cut
+        int edge;
+    };
+
+    int nodes_count;
+    int time;
+
+    std::vector<Edge> edges;
+    std::vector<int> added_at;
+    std::vector<int> removed_at;
+
+    std::vector<Query> queries;
+    std::vector<int> query_time;
+
+    std::vector<std::vector<int>> segment_tree;
+    std::vector<long long> answers;
+
+    bool track_mst;
+    RollbackUnionFind unionFind;
+    LinkCutTree* forest;
+    std::vector<ForestChange> forest_changes;
+    long long mst_weight;
+
+    void insert(int node, int start, int end, int from, int to, int edge)
+    {
+        if (to <= start || end <= from) return;
+        if (from <= start && end <= to) {
+            segment_tree[node].push_back(edge);
+            return;
+        }
+        int middle = (start + end) / 2;
+        insert(node * 2 + 1, start, middle, from, to, edge);
+        insert(node * 2 + 2, middle, end, from, to, edge);
+    }
+
+    // The node of the edge in the link-cut tree.
+    int forest_node(int edge) const {
+        return nodes_count + edge;
+    }
+
+    void link(int edge)
+    {
+        forest->link(edges[edge].from, forest_node(edge));
+        forest->link(forest_node(edge), edges[edge].to);
+        mst_weight += edges[edge].weight;
+    }
+
+    void cut(int edge)
+    {
+        forest->cut(edges[edge].from, forest_node(edge));
+        forest->cut(forest_node(edge), edges[edge].to);
+        mst_weight -= edges[edge].weight;
+    }
+
+    void add_edge_to_forest(int edge, bool merged_components)
+    {
+        if (merged_components) {
+            link(edge);
+            forest_changes.push_back({true, edge});
+            return;
+        }
+
+        const Edge& e = edges[edge];
+        if (e.from == e.to) return;
+
+        int heaviest = forest->path_max_node(e.from, e.to) - nodes_count;
+        if (edges[heaviest].weight <= e.weight) return;
+
+        cut(heaviest);
+        forest_changes.push_back({false, heaviest});
+        link(edge);
+        forest_changes.push_back({true, edge});
+    }
+
+    void rollback_forest(size_t size)
+    {
+        while (forest_changes.size() > size) {
+            ForestChange change = forest_changes.back();
+            forest_changes.pop_back();
+            if (change.linked) cut(change.edge);
+            else link(change.edge);
+        }
+    }
+
+    void answer(int query_index)
+    {
+        const Query& query = queries[query_index];
+        switch (query.type) {
+            case QueryType::Connected:
+                answers[query_index] = unionFind.are_connected(query.a, query.b);
+                break;
+            case QueryType::Components:
+                answers[query_index] = unionFind.components;
+                break;
+            case QueryType::MSTWeight:
+                answers[query_index] = mst_weight;
+                break;
+        }
+    }
+
+    void traverse(int node, int start, int end, const std::vector<int>& query_at)
+    {
+        size_t forest_size = forest_changes.size();
+
+        for (int edge : segment_tree[node]) {
+            bool merged = unionFind.connect(edges[edge].from, edges[edge].to);
+            if (track_mst) add_edge_to_forest(edge, merged);
+        }
+
+        if (end - start == 1) {
+            if (query_at[start] != -1) answer(query_at[start]);
+        } else {
+            int middle = (start + end) / 2;
+            traverse(node * 2 + 1, start, middle, query_at);
+            traverse(node * 2 + 2, middle, end, query_at);
+        }
+
+        for (int i = 0; i < segment_tree[node].size(); i++) {
+            unionFind.rollback();
+        }
+        if (track_mst) rollback_forest(forest_size);
+    }
+
+    int add_query(QueryType type, int a = 0, int b = 0)
+    {
+        queries.push_back({type, a, b});
+        query_time.push_back(time++);
+        return queries.size() - 1;
+    }
+
+public:
+
+    explicit OfflineDynamicConnectivity(int nodes_count)
+        : nodes_count(nodes_count), time(0), track_mst(false),
+          unionFind(nodes_count), forest(nullptr), mst_weight(0) {}
+
+    // Returns the id of the edge, which is used to remove it.
+    int add_edge(int from, int to, int weight = 0)
+    {
+        edges.push_back({from, to, weight});
+        added_at.push_back(time++);
+        removed_at.push_back(INT_MAX);
+        return edges.size() - 1;
+    }
+
+    void remove_edge(int id) {
+        removed_at[id] = time++;
+    }
+
+    // Each of these returns the index of
+    // the answer in the result of solve().
+    int query_connected(int a, int b) { return add_query(QueryType::Connected, a, b); }
+    int query_components() { return add_query(QueryType::Components); }
+    int query_mst_weight() { return add_query(QueryType::MSTWeight); }
+
+    std::vector<long long> solve()
+    {
+        int T = std::max(time, 1);
+        segment_tree.assign(4 * T, {});
+        answers.assign(queries.size(), 0);
+
+        for (int i = 0; i < edges.size(); i++) {
+            insert(0, 0, T, added_at[i], std::min(removed_at[i], T), i);
+        }
+
+        std::vector<int> query_at(T, -1);
+        for (int i = 0; i < queries.size(); i++) {
+            query_at[query_time[i]] = i;
+            if (queries[i].type == QueryType::MSTWeight) track_mst = true;
+        }
+
+        std::vector<int> values(nodes_count + edges.size(), INT_MIN);
+        for (int i = 0; i < edges.size(); i++) {
+            values[forest_node(i)] = edges[i].weight;
+        }
+        LinkCutTree tree(values);
+        forest = &tree;
+
+        traverse(0, 0, T, query_at);
+
+        forest = nullptr;
+        return answers;
+    }
+};
+
+// Recomputes everything from scratch on each query using Kruskal's algorithm.
+class RecomputingConnectivity
+{
+    int nodes_count;
+    std::vector<Edge> edges;
+    std::vector<bool> alive;
+
+    UnionFind get_union_find(long long* mst_weight = nullptr)
+    {
+        std::vector<Edge> alive_edges;
+        for (int i = 0; i < edges.size(); i++) {
+            if (alive[i]) alive_edges.push_back(edges[i]);
+        }
+
+        UnionFind unionFind(nodes_count);
+        if (mst_weight != nullptr) {
+            std::sort(alive_edges.begin(), alive_edges.end());
+            *mst_weight = 0;
+        }
+
+        for (const Edge& edge : alive_edges) {
+            if (unionFind.are_connected(edge.from, edge.to)) continue;
+            unionFind.connect(edge.from, edge.to);
+            if (mst_weight != nullptr) *mst_weight += edge.weight;
+        }
+
+        return unionFind;
+    }
+
+public:
+
+    explicit RecomputingConnectivity(int nodes_count) : nodes_count(nodes_count) {}
+
+    int add_edge(int from, int to, int weight = 0)
+    {
+        edges.push_back({from, to, weight});
+        alive.push_back(true);
+        return edges.size() - 1;
+    }
+
+    void remove_edge(int id) {
+        alive[id] = false;
+    }
+
+    long long query_connected(int a, int b) { return get_union_find().are_connected(a, b); }
+    long long query_components() { return get_union_find().components; }
+
+    long long query_mst_weight()
+    {
+        long long weight;
+        get_union_find(&weight);
+        return weight;
+    }
+};
+
+struct Operation
+{
+    // 0 = add, 1 = remove, 2 = connected
+    // query, 3 = components, 4 = MST weight
+    int type;
+    int a;
+    int b;
+    int weight;
+    int edge_index; // for removals, the index of the add operation
+};
+
+std::vector<Operation> get_random_operations(int n, int count, int query_percentage, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<Operation> operations;
+    std::vector<int> alive; // indices of the add operations
+
+    for (int i = 0; i < count; i++)
+    {
+        int roll = random() % 100;
+        if (roll < query_percentage) {
+            operations.push_back({2 + (int)(random() % 3), (int)(random() % n), (int)(random() % n), 0, -1});
+        } else if (roll < query_percentage + (100 - query_percentage) * 2 / 3 || alive.empty()) {
+            // Twice as many additions as removals, so that the graph grows.
+            alive.push_back(operations.size());
+            operations.push_back({0, (int)(random() % n), (int)(random() % n), (int)(random() % 1000), -1});
+        } else {
+            int j = random() % alive.size();
+            std::swap(alive[j], alive.back());
+            operations.push_back({1, 0, 0, 0, alive.back()});
+            alive.pop_back();
+        }
+    }
+
+    return operations;
+}
+
+std::vector<long long> run_offline(int n, const std::vector<Operation>& operations)
+{
+    OfflineDynamicConnectivity connectivity(n);
+    std::vector<int> ids(operations.size());
+
+    for (int i = 0; i < operations.size(); i++) {
+        const Operation& op = operations[i];
+        if (op.type == 0) ids[i] = connectivity.add_edge(op.a, op.b, op.weight);
+        else if (op.type == 1) connectivity.remove_edge(ids[op.edge_index]);
+        else if (op.type == 2) connectivity.query_connected(op.a, op.b);
+        else if (op.type == 3) connectivity.query_components();
+        else connectivity.query_mst_weight();
+    }
+
+    return connectivity.solve();
+}
+
+std::vector<long long> run_recomputing(int n, const std::vector<Operation>& operations)
+{
+    RecomputingConnectivity connectivity(n);
+    std::vector<int> ids(operations.size());
+    std::vector<long long> answers;
+
+    for (int i = 0; i < operations.size(); i++) {
+        const Operation& op = operations[i];
+        if (op.type == 0) ids[i] = connectivity.add_edge(op.a, op.b, op.weight);
+        else if (op.type == 1) connectivity.remove_edge(ids[op.edge_index]);
+        else if (op.type == 2) answers.push_back(connectivity.query_connected(op.a, op.b));
+        else if (op.type == 3) answers.push_back(connectivity.query_components());
+        else answers.push_back(connectivity.query_mst_weight());
+    }
+
+    return answers;
+}
+
+void sample_test()
+{
+    OfflineDynamicConnectivity connectivity(5);
+
+    int a = connectivity.add_edge(0, 1, 4);
+    int b = connectivity.add_edge(1, 2, 3);
+    connectivity.add_edge(0, 2, 1);
+    connectivity.query_connected(0, 2);       // 1
+    connectivity.query_mst_weight();          // 1 + 3 = 4
+    connectivity.remove_edge(b);
+    connectivity.query_mst_weight();          // 1 + 4 = 5
+    connectivity.add_edge(3, 4, 7);
+    connectivity.query_components();          // 2
+    connectivity.remove_edge(a);
+    connectivity.query_connected(1, 2);       // 0
+    connectivity.query_components();          // 3
+
+    for (long long answer : connectivity.solve()) {
+        std::cout << answer << ' ';
+    }
+    std::cout << std::endl << std::endl;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(3);
+    for (int i = 0; i < tests; i++)
+    {
+        int n = 1 + random() % 20;
+        auto operations = get_random_operations(n, 1 + random() % 200, 30, i);
+        if (run_offline(n, operations) != run_recomputing(n, operations))
+            std::cout << "Wrong answer!" << std::endl;
+    }
+}
+
+void time_test(int n, int operations_count, int query_percentage)
+{
+    auto operations = get_random_operations(n, operations_count, query_percentage, 99);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto offline = run_offline(n, operations);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto offline_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    auto recomputed = run_recomputing(n, operations);
+    end = std::chrono::high_resolution_clock::now();
+    auto recompute_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    if (offline != recomputed)
+        std::cout << "Wrong answer!" << std::endl;
+
+    std::cout << "V = " << n << ", " << operations_count << " operations (" << offline.size() << " queries)" << std::endl;
+    std::cout << "Offline: " << offline_ms << " ms, recomputing: " << recompute_ms << " ms" << std::endl << std::endl;
+}
+
+int main()
+{
+    sample_test();
+    random_test(500);
+
+    time_test(1000, 20000, 10);
+    time_test(5000, 50000, 30);
+}
@@ -0,0 +1,477 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+
+const int MAX_VAL = 1'000'000'000;
+
+// All the applications of Floyd-Warshall in this directory are the same
+// triple loop over a different pair of operations (a semiring):
+//  answers[i][j] = add(answers[i][j], multiply(answers[i][k], answers[k][j]))
+// where "add" picks or combines the alternatives, and "multiply" extends
+// a path by another. zero is the value of no path (add(x, zero) = x), and
+// one is the value of the empty path (multiply(x, one) = x).
+//
+// A semiring is idempotent if add(x, x) = x. For these, counting a path
+// twice doesn't matter, which allows the blocked order of the closure.
+
+struct MinPlus
+{
+    // Shortest paths ("GraphDiameter.cpp" and "Version 5").
+    typedef int T;
+    static const bool idempotent = true;
+    static T zero() { return MAX_VAL; }
+    static T one() { return 0; }
+    static T add(T a, T b) { return std::min(a, b); }
+    static T multiply(T a, T b) { return a + b; }
+};
+
+struct MinMax
+{
+    // The path with the minimum maximum value ("MiniMax and its variations.cpp").
+    typedef int T;
+    static const bool idempotent = true;
+    static T zero() { return MAX_VAL; }
+    static T one() { return -MAX_VAL; }
+    static T add(T a, T b) { return std::min(a, b); }
+    static T multiply(T a, T b) { return std::max(a, b); }
+};
+
+struct MaxMin
+{
+    // The path with the maximum minimum value (the widest path).
+    typedef int T;
+    static const bool idempotent = true;
+    static T zero() { return -MAX_VAL; }
+    static T one() { return MAX_VAL; }
+    static T add(T a, T b) { return std::max(a, b); }
+    static T multiply(T a, T b) { return std::min(a, b); }
+};
+
+struct PlusTimes
+{
+    // Counting paths ("CountPaths.cpp"). The counts are modulo 2^64.
+    typedef uint64_t T;
+    static const bool idempotent = false;
+    static T zero() { return 0; }
+    static T one() { return 1; }
+    static T add(T a, T b) { return a + b; }
+    static T multiply(T a, T b) { return a * b; }
+};
+
+struct OrAnd
+{
+    // Reachability ("TransitiveClosure.cpp").
+    typedef uint8_t T;
+    static const bool idempotent = true;
+    static T zero() { return 0; }
+    static T one() { return 1; }
+    static T add(T a, T b) { return a | b; }
+    static T multiply(T a, T b) { return a & b; }
+};
+
+template <typename Function>
+void parallel_for(int threads_count, size_t count, Function function)
+{
+    // Splits [0, count) into contiguous chunks, and calls
+    // function(thread_index, begin, end) for each chunk.
+    if (threads_count == 1 || count < 2) {
+        function(0, (size_t)0, count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    size_t chunk = (count + threads_count - 1) / threads_count;
+    for (int t = 0; t < threads_count; t++) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        threads.emplace_back(function, t, begin, end);
+    }
+    for (auto& thread : threads) thread.join();
+}
+
+template <typename Semiring>
+class SemiringMatrix
+{
+    // A square matrix, stored row by row in one array, and padded with
+    // zero() to a multiple of BLOCK. The padding nodes have no edges,
+    // so they don't change any result.
+    //
+    // Everything is done in BLOCK x BLOCK blocks, using one kernel:
+    //  C[I][J] = add(C[I][J], multiply(A[I][K], B[K][J]))
+    // going over k, then i, then j. The innermost loop goes over a row of
+    // C and a row of B with a fixed A[i][k], and has no dependency between
+    // the j's, so the compiler vectorizes it for all the semirings. The 3
+    // blocks stay in the cache during the BLOCK^3 operations.
+
+public:
+
+    typedef typename Semiring::T T;
+    static const int BLOCK = 64;
+
+private:
+
+    int n;
+    int padded_n;
+    std::vector<T> cells;
+
+    T* row(int i) { return cells.data() + (size_t)i * padded_n; }
+    const T* row(int i) const { return cells.data() + (size_t)i * padded_n; }
+
+    // C, A and B can be the same matrix (the closure does that).
+    static void multiply_add_block(SemiringMatrix& C, const SemiringMatrix& A, const SemiringMatrix& B, int I, int J, int K)
+    {
+        // The row of B is copied first, so the compiler knows
+        // the inner loop doesn't modify it, and can vectorize it.
+        T row_b[BLOCK];
+
+        for (int k = K * BLOCK; k < (K + 1) * BLOCK; k++)
+        {
+            std::copy(B.row(k) + J * BLOCK, B.row(k) + (J + 1) * BLOCK, row_b);
+            for (int i = I * BLOCK; i < (I + 1) * BLOCK; i++)
+            {
+                T a = A.row(i)[k];
+                if (a == Semiring::zero()) continue;
+                T* row_c = C.row(i) + J * BLOCK;
+                for (int j = 0; j < BLOCK; j++) {
+                    row_c[j] = Semiring::add(row_c[j], Semiring::multiply(a, row_b[j]));
+                }
+            }
+        }
+    }
+
+public:
+
+    explicit SemiringMatrix(int n)
+        : n(n), padded_n((n + BLOCK - 1) / BLOCK * BLOCK), cells((size_t)padded_n * padded_n, Semiring::zero()) {}
+
+    static SemiringMatrix identity(int n)
+    {
+        SemiringMatrix result(n);
+        for (int i = 0; i < n; i++) result.set(i, i, Semiring::one());
+        return result;
+    }
+
+    int size() const { return n; }
+
+    T get(int i, int j) const { return row(i)[j]; }
+    void set(int i, int j, T value) { row(i)[j] = value; }
+
+    // result[i][j] is the best (or the count) of the paths that go through
+    // a path of this matrix, then a path of other. The rows of blocks of the
+    // result are split between the threads.
+    SemiringMatrix multiply(const SemiringMatrix& other, int threads_count = 1) const
+    {
+        SemiringMatrix result(n);
+        int blocks = padded_n / BLOCK;
+        parallel_for(threads_count, blocks, [&](int, size_t begin, size_t end) {
+            for (int I = begin; I < (int)end; I++) {
+                for (int K = 0; K < blocks; K++) {
+                    for (int J = 0; J < blocks; J++) {
+                        multiply_add_block(result, *this, other, I, J, K);
+                    }
+                }
+            }
+        });
+        return result;
+    }
+
+    // The paths of exactly k edges, by repeated squaring (O(n^3 log k)).
+    // For example, with MinPlus, this gives the shortest paths of exactly
+    // k edges, which Floyd-Warshall can't limit.
+    SemiringMatrix power(long long k, int threads_count = 1) const
+    {
+        SemiringMatrix result = identity(n);
+        SemiringMatrix base = *this;
+        while (k) {
+            if (k & 1) result = result.multiply(base, threads_count);
+            k >>= 1;
+            if (k) base = base.multiply(base, threads_count);
+        }
+        return result;
+    }
+
+    // The same result as the triple loops of the applications: the paths
+    // of one edge or more. The diagonal has the best cycle through each node.
+    //
+    // For idempotent semirings, this is Floyd-Warshall done block by block
+    // (as in "Version 7"): the diagonal block, then its row and column, then
+    // all the other blocks, where only the last two steps are multithreaded.
+    // The block order uses some values from later k's early, which is fine
+    // only when counting a path twice doesn't matter.
+    //
+    // Otherwise (counting), it's the same order as the triple loop: for each
+    // k, every row i that reaches k gets row k added, multiplied by [i][k].
+    // Row k is copied first, which only differs from the triple loop when
+    // [k][k] isn't zero(), and counting paths only makes sense without cycles
+    // anyway (see "CountPaths.cpp"). The rows are split between the threads.
+    SemiringMatrix closure(int threads_count = 1) const
+    {
+        if (!Semiring::idempotent) {
+            SemiringMatrix result = *this;
+            std::vector<T> row_k(padded_n);
+            for (int k = 0; k < n; k++) {
+                std::copy(result.row(k), result.row(k) + padded_n, row_k.begin());
+                parallel_for(threads_count, n, [&](int, size_t begin, size_t end) {
+                    for (int i = begin; i < (int)end; i++) {
+                        T a = result.row(i)[k];
+                        if (a == Semiring::zero()) continue;
+                        T* row_i = result.row(i);
+                        for (int j = 0; j < padded_n; j++) {
+                            row_i[j] = Semiring::add(row_i[j], Semiring::multiply(a, row_k[j]));
+                        }
+                    }
+                });
+            }
+            return result;
+        }
+
+        SemiringMatrix result = *this;
+        int blocks = padded_n / BLOCK;
+
+        for (int K = 0; K < blocks; K++)
+        {
+            multiply_add_block(result, result, result, K, K, K);
+
+            // The blocks (K, x) are the first blocks - 1 items, and (x, K) are the rest.
+            parallel_for(threads_count, 2 * (blocks - 1), [&](int, size_t begin, size_t end) {
+                for (size_t index = begin; index < end; index++) {
+                    int x = index % (blocks - 1);
+                    if (x >= K) x++;
+                    if ((int)index < blocks - 1) multiply_add_block(result, result, result, K, x, K);
+                    else multiply_add_block(result, result, result, x, K, K);
+                }
+            });
+
+            parallel_for(threads_count, blocks, [&](int, size_t begin, size_t end) {
+                for (int I = begin; I < (int)end; I++) {
+                    if (I == K) continue;
+                    for (int J = 0; J < blocks; J++) {
+                        if (J != K) multiply_add_block(result, result, result, I, J, K);
+                    }
+                }
+            });
+        }
+
+        return result;
+    }
+};
+
+// The triple loop of the applications, with the operations of the
+// semiring. Used only to compare against, and it's exactly the loop of
+// "CountPaths.cpp" for PlusTimes, "MiniMax and its variations.cpp" for
+// MinMax, "GraphDiameter.cpp" for MinPlus and "TransitiveClosure.cpp" for OrAnd.
+template <typename Semiring>
+std::vector<typename Semiring::T> calc_closure_simple(std::vector<typename Semiring::T> answers, int n)
+{
+    for (int k = 0; k < n; k++) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                auto additional = Semiring::multiply(answers[i * n + k], answers[k * n + j]);
+                answers[i * n + j] = Semiring::add(answers[i * n + j], additional);
+            }
+        }
+    }
+    return answers;
+}
+
+// The applications, ported. They keep the 1-indexed nodes and the sample graphs of the original files.
+
+int mini_max_value(int i, int j)
+{
+    SemiringMatrix<MinMax> values(6);
+
+    values.set(1, 2, 8);
+    values.set(2, 1, 8);
+
+    values.set(1, 4, 5);
+    values.set(4, 1, 5);
+
+    values.set(2, 3, 100);
+    values.set(3, 2, 100);
+
+    values.set(3, 5, 3);
+    values.set(5, 3, 3);
+
+    values.set(4, 5, 2);
+    values.set(5, 4, 2);
+
+    // For the other variations, use MaxMin, or make a semiring with the other pair of min and max.
+    return values.closure().get(i, j);
+}
+
+uint64_t paths_count(int i, int j)
+{
+    // The diagonal must be zero(), it must be a DAG.
+    SemiringMatrix<PlusTimes> count(6);
+
+    count.set(1, 2, 1);
+    count.set(1, 4, 1);
+    count.set(2, 3, 1);
+    count.set(4, 5, 1);
+    count.set(5, 3, 1);
+
+    return count.closure().get(i, j);
+}
+
+void print_graph_diameter()
+{
+    SemiringMatrix<MinPlus> distances(6);
+
+    distances.set(1, 2, 8);
+    distances.set(2, 1, 8);
+
+    distances.set(1, 4, 5);
+    distances.set(4, 1, 5);
+
+    distances.set(2, 3, 100);
+    distances.set(3, 2, 100);
+
+    distances.set(3, 5, 3);
+    distances.set(5, 3, 3);
+
+    distances.set(4, 5, 2);
+    distances.set(5, 4, 2);
+
+    auto answers = distances.closure();
+
+    // The shortest path in the graph between two nodes with the most
+    // distance. Note that "GraphDiameter.cpp" looks at the distances
+    // (the edges) instead of the answers here, and reports the longest edge.
+    int max_val = 0;
+    int from = -1;
+    int to = -1;
+
+    for (int i = 1; i <= 5; i++) {
+        for (int j = 1; j <= 5; j++) {
+            if (i != j && answers.get(i, j) > max_val && answers.get(i, j) != MAX_VAL) {
+                max_val = answers.get(i, j);
+                from = i;
+                to = j;
+            }
+        }
+    }
+
+    std::cout << "Graph diameter is from node " << from << " to node "
+        << to << " with a distance of " << max_val << "." << std::endl;
+}
+
+// Random weights in [1, 1000). With acyclic = true, all the edges go
+// from a smaller node to a larger one, which is what counting needs.
+template <typename Semiring>
+std::vector<typename Semiring::T> get_random_matrix(int n, int m, bool acyclic, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<typename Semiring::T> matrix(n * n, Semiring::zero());
+    for (int e = 0; e < m; e++) {
+        int a = random() % n;
+        int b = random() % n;
+        if (acyclic) {
+            if (a == b) continue;
+            if (a > b) std::swap(a, b);
+        }
+        // For PlusTimes and OrAnd, any non zero value means an edge.
+        typename Semiring::T weight = 1 + random() % 999;
+        if (sizeof(weight) == 1 || !Semiring::idempotent) weight = 1;
+        matrix[a * n + b] = Semiring::add(matrix[a * n + b], weight);
+    }
+    return matrix;
+}
+
+template <typename Semiring>
+SemiringMatrix<Semiring> to_matrix(int n, const std::vector<typename Semiring::T>& cells)
+{
+    SemiringMatrix<Semiring> matrix(n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            matrix.set(i, j, cells[i * n + j]);
+        }
+    }
+    return matrix;
+}
+
+template <typename Semiring>
+bool is_equal(int n, const std::vector<typename Semiring::T>& expected, const SemiringMatrix<Semiring>& matrix)
+{
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (expected[i * n + j] != matrix.get(i, j)) return false;
+        }
+    }
+    return true;
+}
+
+template <typename Semiring>
+void random_test(const std::string& name, int tests, bool acyclic)
+{
+    std::mt19937 random(17);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 200;
+        auto cells = get_random_matrix<Semiring>(n, random() % (3 * n), acyclic, t);
+        auto matrix = to_matrix<Semiring>(n, cells);
+
+        if (!is_equal(n, calc_closure_simple<Semiring>(cells, n), matrix.closure(1 + t % 4)))
+            std::cout << "Wrong " << name << " closure!" << std::endl;
+
+        // The paths of exactly k edges, one edge at a time.
+        int k = random() % 6;
+        auto expected = SemiringMatrix<Semiring>::identity(n);
+        for (int i = 0; i < k; i++) expected = expected.multiply(matrix);
+        auto power = matrix.power(k, 2);
+        for (int i = 0; i < n * n; i++) {
+            if (expected.get(i / n, i % n) != power.get(i / n, i % n)) {
+                std::cout << "Wrong " << name << " power!" << std::endl;
+                break;
+            }
+        }
+    }
+}
+
+template <typename Semiring>
+void time_test(const std::string& name, int n, bool acyclic)
+{
+    auto cells = get_random_matrix<Semiring>(n, 4 * n, acyclic, n);
+    auto matrix = to_matrix<Semiring>(n, cells);
+    std::cout << name << ", V = " << n << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto expected = calc_closure_simple<Semiring>(cells, n);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Triple loop: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+
+    for (int threads : {1, 4}) {
+        start = std::chrono::high_resolution_clock::now();
+        auto result = matrix.closure(threads);
+        end = std::chrono::high_resolution_clock::now();
+        std::cout << "Engine, " << threads << " threads: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+        if (!is_equal(n, expected, result))
+            std::cout << "Wrong " << name << " closure!" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    std::cout << mini_max_value(2, 3) << std::endl;
+    std::cout << paths_count(1, 3) << std::endl;
+    print_graph_diameter();
+    std::cout << std::endl;
+
+    random_test<MinPlus>("min-plus", 50, false);
+    random_test<MinMax>("min-max", 50, false);
+    random_test<MaxMin>("max-min", 50, false);
+    random_test<PlusTimes>("plus-times", 50, true);
+    random_test<OrAnd>("or-and", 50, false);
+
+    time_test<MinPlus>("Min-plus", 1024, false);
+    time_test<MinMax>("Min-max", 1024, false);
+    time_test<MaxMin>("Max-min", 1024, false);
+    time_test<PlusTimes>("Plus-times", 1024, true);
+    time_test<OrAnd>("Or-and", 1024, false);
+}
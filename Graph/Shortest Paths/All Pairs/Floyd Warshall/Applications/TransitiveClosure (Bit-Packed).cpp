@@ -0,0 +1,238 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+template <typename Function>
+void parallel_for(int threads_count, size_t count, Function function)
+{
+    // Splits [0, count) into contiguous chunks, and calls
+    // function(thread_index, begin, end) for each chunk.
+    if (threads_count == 1 || count < 64) {
+        function(0, (size_t)0, count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    size_t chunk = (count + threads_count - 1) / threads_count;
+    for (int t = 0; t < threads_count; t++) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        threads.emplace_back(function, t, begin, end);
+    }
+    for (auto& thread : threads) thread.join();
+}
+
+class BitMatrix
+{
+    // Row i is stored in words [i * words_per_row, (i + 1) * words_per_row),
+    // and the bit j of the row is in the word j / 64, at the position j % 64.
+    // All the rows are in one contiguous array.
+
+    int n;
+    int words_per_row;
+    std::vector<uint64_t> words;
+
+public:
+
+    explicit BitMatrix(int n) : n(n), words_per_row((n + 63) / 64), words((size_t)n * words_per_row, 0) {}
+
+    int size() const { return n; }
+    int row_words() const { return words_per_row; }
+
+    uint64_t* row(int i) { return words.data() + (size_t)i * words_per_row; }
+    const uint64_t* row(int i) const { return words.data() + (size_t)i * words_per_row; }
+
+    bool get(int i, int j) const { return (row(i)[j >> 6] >> (j & 63)) & 1; }
+    void set(int i, int j) { row(i)[j >> 6] |= (uint64_t)1 << (j & 63); }
+};
+
+void calc_connected_nodes(BitMatrix& answers, int threads_count = 1)
+{
+    // The same recurrence as "TransitiveClosure.cpp":
+    //  answers[i][j] |= answers[i][k] && answers[k][j]
+    // For a fixed k and i, if answers[i][k] is false, nothing changes
+    // in row i. Otherwise, row i gets ORed with row k. So, instead of
+    // n^3 cell operations, this does at most n^3 / 64 word operations,
+    // and skips the rows that can't reach k entirely.
+    //
+    //
+    // To run this on multiple threads, the k's are taken in blocks of 64:
+    //  1. The 64 rows of the block are updated using each other, k by k,
+    //     on one thread.
+    //  2. Every other row i is updated by all the k's of the block, in order.
+    //     This only reads the rows of the block, so the other rows are split
+    //     between the threads, and the threads are started once per block.
+    // In 2, row k already went through the k's after it in the block. This
+    // is fine, since every bit it has is a real path, and it has at least the
+    // bits it would have had at iteration k, so the result is the same.
+
+    int n = answers.size();
+    int words = answers.row_words();
+
+    auto update_row = [&](int i, int k) {
+        if (i == k || !answers.get(i, k)) return;
+        uint64_t* row_i = answers.row(i);
+        const uint64_t* row_k = answers.row(k);
+        for (int w = 0; w < words; w++) {
+            row_i[w] |= row_k[w];
+        }
+    };
+
+    for (int block = 0; block < n; block += 64)
+    {
+        int block_end = std::min(n, block + 64);
+
+        for (int k = block; k < block_end; k++) {
+            for (int i = block; i < block_end; i++) {
+                update_row(i, k);
+            }
+        }
+
+        parallel_for(threads_count, n, [&](int, size_t begin, size_t end) {
+            for (int i = begin; i < (int)end; i++) {
+                if (block <= i && i < block_end) continue;
+                for (int k = block; k < block_end; k++) {
+                    update_row(i, k);
+                }
+            }
+        });
+    }
+}
+
+// A copy of "TransitiveClosure.cpp", with the global arrays replaced
+// by a flat array, so it can run on any n. Used only to compare against.
+void calc_connected_nodes_bool(bool* answers, int n)
+{
+    for (int k = 0; k < n; k++) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+
+                bool include_k_in_the_path = answers[i * n + k] && answers[k * n + j];
+                answers[i * n + j] |= include_k_in_the_path;
+
+            }
+        }
+    }
+}
+
+void set_connections(BitMatrix& connected)
+{
+    // The graph of "TransitiveClosure.cpp", 0-indexed.
+    connected.set(0, 1);
+    connected.set(1, 0);
+
+    connected.set(0, 3);
+    connected.set(3, 0);
+
+    connected.set(2, 4);
+    connected.set(4, 2);
+
+    connected.set(3, 4);
+    connected.set(4, 3);
+}
+
+// A sparse directed graph with a few strongly connected parts,
+// so the closure is neither empty nor all ones.
+std::vector<std::pair<int, int>> get_random_edges(int n, int m, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<std::pair<int, int>> edges(m);
+    for (auto& edge : edges) {
+        int a = random() % n;
+        int b = random() % n;
+        // Most of the edges go forward, which keeps the reachability sets of different sizes.
+        if (random() % 4 && a > b) std::swap(a, b);
+        edge = {a, b};
+    }
+    return edges;
+}
+
+void test()
+{
+    BitMatrix answers(5);
+    set_connections(answers);
+    calc_connected_nodes(answers);
+    std::cout << answers.get(1, 2) << std::endl;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(3);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 200;
+        auto edges = get_random_edges(n, random() % (2 * n), t);
+
+        BitMatrix answers(n);
+        std::unique_ptr<bool[]> expected(new bool[n * n]());
+        for (auto& edge : edges) {
+            answers.set(edge.first, edge.second);
+            expected[edge.first * n + edge.second] = true;
+        }
+
+        calc_connected_nodes(answers, 1 + t % 4);
+        calc_connected_nodes_bool(expected.get(), n);
+
+        for (int i = 0; i < n * n; i++) {
+            if (answers.get(i / n, i % n) != expected[i]) {
+                std::cout << "Wrong closure!" << std::endl;
+                break;
+            }
+        }
+    }
+}
+
+void time_test(int n, bool run_bool)
+{
+    auto edges = get_random_edges(n, 2 * n, n);
+    std::cout << "V = " << n << ", E = " << edges.size() << std::endl;
+
+    BitMatrix connected(n);
+    for (auto& edge : edges) connected.set(edge.first, edge.second);
+
+    BitMatrix first_result(n);
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        BitMatrix answers = connected;
+        auto start = std::chrono::high_resolution_clock::now();
+        calc_connected_nodes(answers, threads);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "Bit-packed, " << threads << " threads: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+        if (threads == 1) first_result = answers;
+    }
+
+    if (run_bool) {
+        std::unique_ptr<bool[]> expected(new bool[n * n]());
+        for (auto& edge : edges) expected[edge.first * n + edge.second] = true;
+        auto start = std::chrono::high_resolution_clock::now();
+        calc_connected_nodes_bool(expected.get(), n);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "bool per cell: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+
+        for (int i = 0; i < n * n; i++) {
+            if (first_result.get(i / n, i % n) != expected[i]) {
+                std::cout << "Wrong closure!" << std::endl;
+                break;
+            }
+        }
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test();
+    random_test(100);
+
+    time_test(1024, true);
+    time_test(2048, true);
+    time_test(4096, false);
+    time_test(8192, false);
+    time_test(16384, false);
+}
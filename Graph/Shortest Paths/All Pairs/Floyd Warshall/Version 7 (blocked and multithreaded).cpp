@@ -0,0 +1,267 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+const int MAX_VAL = 1'000'000'000;
+
+template <typename Function>
+void parallel_for(int threads_count, size_t count, Function function)
+{
+    // Splits [0, count) into contiguous chunks, and calls
+    // function(thread_index, begin, end) for each chunk.
+    if (threads_count == 1 || count < 2) {
+        function(0, (size_t)0, count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    size_t chunk = (count + threads_count - 1) / threads_count;
+    for (int t = 0; t < threads_count; t++) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        threads.emplace_back(function, t, begin, end);
+    }
+    for (auto& thread : threads) thread.join();
+}
+
+class BlockedFloydWarshall
+{
+    // The same relaxation as "Version 5", done block by block (Venkataraman,
+    // Sahni and Mukhopadhyaya). The matrix is split into BLOCK x BLOCK
+    // blocks, and for each block of k's (the blocks on the diagonal):
+    //  1. The diagonal block (K, K) is relaxed using itself.
+    //  2. The blocks of row K and column K are relaxed using the diagonal
+    //     block. Only the diagonal block is read, so they are independent.
+    //  3. Every other block (I, J) is relaxed using (I, K) and (K, J). They
+    //     only read blocks of row K and column K, so they are independent too.
+    // Each relaxation of a block goes through BLOCK^3 operations on 3 blocks
+    // that fit in the cache, instead of streaming the whole matrix n times.
+    // The independent blocks of steps 2 and 3 are split between the threads.
+    //
+    // As in "Version 5", mixing the values of different k's is fine here,
+    // since each value only ever decreases towards the correct one.
+    //
+    // MAX_VAL means there is no path. It's at most half the range of an int,
+    // so adding two of them doesn't overflow. The matrix is padded with MAX_VAL
+    // to a multiple of BLOCK, which means the padding nodes are unreachable.
+
+    static const int BLOCK = 64;
+
+    int n;
+    int padded_n;
+    int threads_count;
+    std::vector<int> answers;
+
+    int* row(int i) { return answers.data() + (size_t)i * padded_n; }
+
+    // Relaxes the block (I, J) through the k's of block K.
+    void relax_block(int I, int J, int K)
+    {
+        // Row k is copied first, so the compiler knows it's not
+        // modified by the inner loop, and can vectorize it.
+        int row_k[BLOCK];
+
+        for (int k = K * BLOCK; k < (K + 1) * BLOCK; k++)
+        {
+            std::copy(row(k) + J * BLOCK, row(k) + (J + 1) * BLOCK, row_k);
+            for (int i = I * BLOCK; i < (I + 1) * BLOCK; i++)
+            {
+                int* row_i = row(i);
+                int i_to_k = row_i[k];
+                row_i += J * BLOCK;
+                for (int j = 0; j < BLOCK; j++) {
+                    row_i[j] = std::min(row_i[j], i_to_k + row_k[j]);
+                }
+            }
+        }
+    }
+
+public:
+
+    BlockedFloydWarshall(int n, int threads_count = 1)
+        : n(n), padded_n((n + BLOCK - 1) / BLOCK * BLOCK), threads_count(threads_count),
+          answers((size_t)padded_n * padded_n, MAX_VAL) {}
+
+    void set_distance(int i, int j, int distance) {
+        row(i)[j] = distance;
+    }
+
+    int min_path(int i, int j) const {
+        return answers[(size_t)i * padded_n + j];
+    }
+
+    void calc_min_paths()
+    {
+        int blocks = padded_n / BLOCK;
+
+        for (int K = 0; K < blocks; K++)
+        {
+            relax_block(K, K, K);
+
+            // The blocks (K, x) are the first blocks - 1 items, and (x, K) are the rest.
+            parallel_for(threads_count, 2 * (blocks - 1), [&](int, size_t begin, size_t end) {
+                for (size_t index = begin; index < end; index++) {
+                    int x = index % (blocks - 1);
+                    if (x >= K) x++;
+                    if ((int)index < blocks - 1) relax_block(K, x, K);
+                    else relax_block(x, K, K);
+                }
+            });
+
+            parallel_for(threads_count, blocks, [&](int, size_t begin, size_t end) {
+                for (int I = begin; I < (int)end; I++) {
+                    if (I == K) continue;
+                    for (int J = 0; J < blocks; J++) {
+                        if (J != K) relax_block(I, J, K);
+                    }
+                }
+            });
+        }
+    }
+};
+
+// A copy of "Version 5", with the global arrays replaced by a
+// flat vector, so it can run on any n. Used only to compare against.
+void calc_min_paths(std::vector<int>& answers, int n)
+{
+    for (int k = 0; k < n; k++) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+
+                int include_k_in_the_path = answers[i * n + k] + answers[k * n + j];
+                int exclude_k_from_the_path = answers[i * n + j];
+
+                answers[i * n + j] = std::min(include_k_in_the_path, exclude_k_from_the_path);
+            }
+        }
+    }
+}
+
+struct Edge
+{
+    int from;
+    int to;
+    int weight;
+};
+
+void set_distances(BlockedFloydWarshall& calculator)
+{
+    // The graph of "Version 5", 0-indexed.
+    std::vector<Edge> edges = {{0, 1, 8}, {0, 3, 5}, {1, 2, 100}, {2, 4, 3}, {3, 4, 2}};
+    for (int i = 0; i < 5; i++) {
+        calculator.set_distance(i, i, 0);
+    }
+    for (auto& edge : edges) {
+        calculator.set_distance(edge.from, edge.to, edge.weight);
+        calculator.set_distance(edge.to, edge.from, edge.weight);
+    }
+}
+
+// Non negative weights, and the graph isn't always connected.
+std::vector<Edge> get_random_edges(int n, int m, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<Edge> edges(m);
+    for (auto& edge : edges) {
+        edge = {(int)(random() % n), (int)(random() % n), (int)(random() % 1000)};
+    }
+    return edges;
+}
+
+std::vector<int> get_matrix(int n, const std::vector<Edge>& edges)
+{
+    std::vector<int> matrix(n * n, MAX_VAL);
+    for (int i = 0; i < n; i++) matrix[i * n + i] = 0;
+    for (auto& edge : edges) {
+        int& cell = matrix[edge.from * n + edge.to];
+        cell = std::min(cell, edge.weight);
+    }
+    return matrix;
+}
+
+BlockedFloydWarshall get_calculator(int n, const std::vector<int>& matrix, int threads_count)
+{
+    BlockedFloydWarshall calculator(n, threads_count);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            calculator.set_distance(i, j, matrix[i * n + j]);
+        }
+    }
+    return calculator;
+}
+
+bool is_equal(int n, const std::vector<int>& expected, const BlockedFloydWarshall& calculator)
+{
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (expected[i * n + j] != calculator.min_path(i, j)) return false;
+        }
+    }
+    return true;
+}
+
+void test()
+{
+    BlockedFloydWarshall calculator(5);
+    set_distances(calculator);
+    calculator.calc_min_paths();
+    std::cout << calculator.min_path(1, 2) << std::endl;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(11);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 300;
+        auto matrix = get_matrix(n, get_random_edges(n, random() % (3 * n), t));
+
+        auto calculator = get_calculator(n, matrix, 1 + t % 4);
+        calculator.calc_min_paths();
+        calc_min_paths(matrix, n);
+
+        if (!is_equal(n, matrix, calculator))
+            std::cout << "Wrong distances!" << std::endl;
+    }
+}
+
+void time_test(int n, bool run_simple)
+{
+    auto matrix = get_matrix(n, get_random_edges(n, 4 * n, n));
+    std::cout << "V = " << n << ", E = " << 4 * n << std::endl;
+
+    std::vector<BlockedFloydWarshall> results;
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        auto calculator = get_calculator(n, matrix, threads);
+        auto start = std::chrono::high_resolution_clock::now();
+        calculator.calc_min_paths();
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "Blocked, " << threads << " threads: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+        if (threads == 1) results.push_back(calculator);
+    }
+
+    if (run_simple) {
+        auto start = std::chrono::high_resolution_clock::now();
+        calc_min_paths(matrix, n);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "Version 5: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+        if (!is_equal(n, matrix, results[0]))
+            std::cout << "Wrong distances!" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test();
+    random_test(100);
+
+    time_test(1024, true);
+    time_test(2048, true);
+    time_test(4096, false);
+}
@@ -0,0 +1,392 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <climits>
+#include <algorithm>
+#include <functional>
+
+const long long MAX_VAL = LLONG_MAX / 4;
+
+// The distance matrix uses 4 bytes per pair, and this means there is no path.
+const int NO_PATH = INT_MAX;
+
+struct NegativeCycleException : public std::exception
+{
+    const char* what() const noexcept {
+        return "The graph contains a negative cycle.";
+    }
+};
+
+struct Edge
+{
+    int from;
+    int to;
+    int weight;
+};
+
+struct Graph
+{
+    int nodes_count;
+    std::vector<Edge> edges;
+
+    void add_edge(int from, int to, int weight) {
+        edges.push_back({from, to, weight});
+    }
+};
+
+class JohnsonCalculator
+{
+    // All pairs shortest paths on sparse graphs with negative edges, in
+    // O(V * E * log(V)) instead of the O(V^3) of Floyd-Warshall.
+    //
+    // Dijkstra doesn't work with negative edges, so the edges are reweighted
+    // first: with a potential h(x) for each node, the new weight of u -> v is
+    //  w'(u, v) = w(u, v) + h(u) - h(v)
+    // On any path from s to t, the h's of the middle nodes cancel out, so
+    // every path from s to t changes by the same h(s) - h(t), and the shortest
+    // paths stay the same. If h(x) is the shortest distance to x from a new
+    // node connected to every node with a 0 edge, then h(v) <= h(u) + w(u, v),
+    // which means all the new weights are non-negative.
+    //
+    // The potentials are calculated once using Bellman-Ford (from the new node,
+    // which is the same as starting with all the distances at 0). If it's still
+    // relaxing after V rounds, there is a negative cycle. Then, Dijkstra runs
+    // from each source on the reweighted graph, and the distances are converted
+    // back using h. The sources are independent, so the threads take them one
+    // by one from a shared counter, each with its own distances and queue.
+    //
+    // The output is streamed: the callback gets each source with its row of
+    // distances (MAX_VAL means no path), so the V^2 distances don't have to be
+    // held at once. The callback is called from multiple threads at the same
+    // time, with the thread index, and the row is only valid during the call.
+
+    int n;
+    int threads_count;
+    std::vector<long long> potential;
+
+    // The reweighted graph, flat. The edges of x are [offsets[x], offsets[x + 1]).
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<long long> weights;
+
+    void calc_potentials(const Graph& graph)
+    {
+        potential.assign(n, 0);
+
+        for (int i = 0; i <= n; i++)
+        {
+            bool relaxed = false;
+
+            for (auto& edge : graph.edges) {
+                if (potential[edge.from] + edge.weight < potential[edge.to]) {
+                    potential[edge.to] = potential[edge.from] + edge.weight;
+                    relaxed = true;
+                }
+            }
+
+            if (!relaxed) return;
+        }
+
+        // The new node makes the graph V + 1 nodes, so V rounds are enough without a negative cycle.
+        throw NegativeCycleException();
+    }
+
+    void build_reweighted_graph(const Graph& graph)
+    {
+        offsets.assign(n + 1, 0);
+        for (auto& edge : graph.edges) offsets[edge.from + 1]++;
+        for (int i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+
+        targets.resize(graph.edges.size());
+        weights.resize(graph.edges.size());
+        std::vector<int> position(offsets.begin(), offsets.end() - 1);
+        for (auto& edge : graph.edges) {
+            int index = position[edge.from]++;
+            targets[index] = edge.to;
+            weights[index] = edge.weight + potential[edge.from] - potential[edge.to];
+        }
+    }
+
+    struct QueueFrame
+    {
+        long long weight;
+        int node;
+
+        bool operator>(const QueueFrame &other) const {
+            return weight > other.weight;
+        }
+    };
+
+    // Fills distance with the real (not reweighted) distances from source.
+    void dijkstra(int source, std::vector<long long>& distance, std::vector<QueueFrame>& heap) const
+    {
+        std::fill(distance.begin(), distance.end(), MAX_VAL);
+        distance[source] = 0;
+
+        // A binary heap over a reused vector, same as a priority_queue with std::greater.
+        heap.clear();
+        heap.push_back({0, source});
+
+        while (!heap.empty())
+        {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<QueueFrame>());
+            QueueFrame closest = heap.back();
+            heap.pop_back();
+
+            // An old entry, the node was reached with a smaller distance since then.
+            if (closest.weight > distance[closest.node]) continue;
+
+            for (int i = offsets[closest.node]; i < offsets[closest.node + 1]; i++) {
+                long long new_weight = closest.weight + weights[i];
+                if (new_weight < distance[targets[i]]) {
+                    distance[targets[i]] = new_weight;
+                    heap.push_back({new_weight, targets[i]});
+                    std::push_heap(heap.begin(), heap.end(), std::greater<QueueFrame>());
+                }
+            }
+        }
+
+        for (int x = 0; x < n; x++) {
+            if (distance[x] != MAX_VAL) {
+                distance[x] += potential[x] - potential[source];
+            }
+        }
+    }
+
+public:
+
+    // Throws NegativeCycleException if the graph has a negative cycle.
+    JohnsonCalculator(const Graph& graph, int threads_count = 1)
+        : n(graph.nodes_count), threads_count(threads_count)
+    {
+        calc_potentials(graph);
+        build_reweighted_graph(graph);
+    }
+
+    // callback(thread, source, distances) for each of the given sources.
+    template <typename Callback>
+    void solve(const std::vector<int>& sources, Callback callback) const
+    {
+        std::atomic<int> next_source(0);
+
+        auto work = [&](int thread) {
+            std::vector<long long> distance(n);
+            std::vector<QueueFrame> heap;
+            while (true) {
+                int index = next_source.fetch_add(1, std::memory_order_relaxed);
+                if (index >= (int)sources.size()) return;
+                dijkstra(sources[index], distance, heap);
+                callback(thread, sources[index], (const std::vector<long long>&)distance);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 1; t < threads_count; t++) threads.emplace_back(work, t);
+        work(0);
+        for (auto& thread : threads) thread.join();
+    }
+
+    // callback(thread, source, distances) for every source.
+    template <typename Callback>
+    void solve(Callback callback) const
+    {
+        std::vector<int> sources(n);
+        for (int i = 0; i < n; i++) sources[i] = i;
+        solve(sources, callback);
+    }
+
+    // The whole V x V matrix, row by row, with 4 bytes per pair. The
+    // distances must fit in an int. NO_PATH means there is no path.
+    std::vector<int> get_distance_matrix() const
+    {
+        std::vector<int> matrix((size_t)n * n);
+        solve([&](int, int source, const std::vector<long long>& distance) {
+            // Each source writes its own row, so the threads don't interfere.
+            int* row = matrix.data() + (size_t)source * n;
+            for (int x = 0; x < n; x++) {
+                row[x] = distance[x] == MAX_VAL ? NO_PATH : (int)distance[x];
+            }
+        });
+        return matrix;
+    }
+};
+
+// A copy of "Floyd Warshall/Version 5", with the global arrays replaced
+// by a flat vector, so it can run on any n. Used only to compare against.
+std::vector<long long> calc_min_paths(const Graph& graph)
+{
+    int n = graph.nodes_count;
+    std::vector<long long> answers((size_t)n * n, MAX_VAL);
+    for (int i = 0; i < n; i++) answers[i * n + i] = 0;
+    for (auto& edge : graph.edges) {
+        long long& cell = answers[edge.from * n + edge.to];
+        cell = std::min(cell, (long long)edge.weight);
+    }
+
+    for (int k = 0; k < n; k++) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+
+                long long include_k_in_the_path = answers[i * n + k] + answers[k * n + j];
+                long long exclude_k_from_the_path = answers[i * n + j];
+
+                answers[i * n + j] = std::min(include_k_in_the_path, exclude_k_from_the_path);
+            }
+        }
+    }
+
+    for (auto& answer : answers) {
+        // Unreachable pairs can get below MAX_VAL through negative edges.
+        if (answer > MAX_VAL / 2) answer = MAX_VAL;
+    }
+
+    return answers;
+}
+
+Graph get_sample_graph()
+{
+    // The graph of "Bellman-Ford.cpp", with two negative edges.
+    Graph graph {6};
+
+    graph.add_edge(2, 1, 8);
+
+    graph.add_edge(4, 1, 5);
+    graph.add_edge(1, 4, 5);
+
+    graph.add_edge(2, 3, 100);
+
+    graph.add_edge(5, 3, -3);
+
+    graph.add_edge(4, 5, 2);
+    graph.add_edge(5, 4, -2);
+
+    return graph;
+}
+
+// Many negative edges, but no negative cycles: each edge is a non-negative
+// weight plus p(u) - p(v) for random p's, and these cancel out on cycles.
+// With a negative_cycle, a random cycle of 3 nodes is added with a total of -1.
+Graph get_random_graph(int n, int m, bool negative_cycle, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<int> p(n);
+    for (int& value : p) value = random() % 1000;
+
+    Graph graph {n};
+    for (int i = 0; i < m; i++) {
+        int from = random() % n;
+        int to = random() % n;
+        graph.add_edge(from, to, random() % 100 + p[from] - p[to]);
+    }
+
+    if (negative_cycle && n >= 3) {
+        int a = random() % n, b = (a + 1) % n, c = (a + 2) % n;
+        graph.add_edge(a, b, 0);
+        graph.add_edge(b, c, 0);
+        graph.add_edge(c, a, -1);
+    }
+
+    return graph;
+}
+
+void test()
+{
+    auto matrix = JohnsonCalculator(get_sample_graph()).get_distance_matrix();
+    for (int target = 1; target <= 5; target++) {
+        int distance = matrix[2 * 6 + target];
+        if (distance == NO_PATH) {
+            std::cout << "There is no path from 2 to " << target << "." << std::endl;
+        } else {
+            std::cout << "Minimum distance from 2 to " << target << " is " << distance << "." << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(23);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 150;
+        bool negative_cycle = random() % 4 == 0;
+        Graph graph = get_random_graph(n, random() % (4 * n), negative_cycle, t);
+
+        try {
+            JohnsonCalculator calculator(graph, 1 + t % 4);
+            if (negative_cycle && n >= 3)
+                std::cout << "Negative cycle not detected!" << std::endl;
+
+            auto expected = calc_min_paths(graph);
+            std::atomic<bool> wrong(false);
+            calculator.solve([&](int, int source, const std::vector<long long>& distance) {
+                for (int x = 0; x < n; x++) {
+                    if (distance[x] != expected[source * n + x]) wrong = true;
+                }
+            });
+            if (wrong)
+                std::cout << "Wrong distances!" << std::endl;
+        } catch (NegativeCycleException&) {
+            if (!negative_cycle)
+                std::cout << "Wrong negative cycle!" << std::endl;
+        }
+    }
+}
+
+void time_test(int n, int m, int sources_count, bool run_floyd_warshall)
+{
+    Graph graph = get_random_graph(n, m, false, n);
+    std::cout << "V = " << n << ", E = " << m << ", " << sources_count << " sources" << std::endl;
+
+    std::vector<int> sources(sources_count);
+    for (int i = 0; i < sources_count; i++) sources[i] = (long long)i * n / sources_count;
+
+    for (int threads = 1; threads <= 8; threads *= 2)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        JohnsonCalculator calculator(graph, threads);
+        auto reweighted = std::chrono::high_resolution_clock::now();
+
+        // Streaming the rows, only keeping a checksum per thread.
+        std::vector<long long> checksum(threads, 0);
+        calculator.solve(sources, [&](int thread, int, const std::vector<long long>& distance) {
+            for (long long d : distance) if (d != MAX_VAL) checksum[thread] += d;
+        });
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "Johnson, " << threads << " threads: reweighting "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(reweighted - start).count() << " ms, Dijkstras "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - reweighted).count() << " ms" << std::endl;
+    }
+
+    if (run_floyd_warshall) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto expected = calc_min_paths(graph);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "Floyd-Warshall: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+
+        std::vector<int> expected_matrix(expected.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            expected_matrix[i] = expected[i] == MAX_VAL ? NO_PATH : (int)expected[i];
+        }
+        if (JohnsonCalculator(graph, 4).get_distance_matrix() != expected_matrix)
+            std::cout << "Wrong distances!" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test();
+    random_test(200);
+
+    time_test(1000, 4000, 1000, true);
+    time_test(2000, 8000, 2000, true);
+    // The full V x V takes a while on a single core, so only a part of the sources.
+    time_test(10'000, 40'000, 2000, false);
+    time_test(50'000, 200'000, 500, false);
+}
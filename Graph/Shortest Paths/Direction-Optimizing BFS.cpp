@@ -0,0 +1,487 @@
+#include <queue>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cstdint>
+
+const int UNVISITED = -1;
+const int NO_PARENT = -2;
+typedef std::vector<std::vector<int>> Graph;
+
+struct FlatGraph
+{
+    // The neighbours of the node x are targets[offsets[x]..offsets[x + 1]).
+    // The offsets are unsigned 32 bits, which allows for up to 2^32 - 1 edges.
+
+    int n;
+    std::vector<uint32_t> offsets;
+    std::vector<int> targets;
+
+    FlatGraph(int n, const std::vector<std::pair<int, int>>& edges, bool transpose = false)
+        : n(n), offsets(n + 1, 0), targets(edges.size())
+    {
+        for (auto& edge : edges) offsets[(transpose ? edge.second : edge.first) + 1]++;
+        for (int i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+
+        std::vector<uint32_t> position(offsets.begin(), offsets.end() - 1);
+        for (auto& edge : edges) {
+            if (transpose) targets[position[edge.second]++] = edge.first;
+            else targets[position[edge.first]++] = edge.second;
+        }
+    }
+
+    int degree(int x) const {
+        return offsets[x + 1] - offsets[x];
+    }
+};
+
+template <typename Function>
+void parallel_for(int threads_count, size_t count, Function function)
+{
+    // Splits [0, count) into contiguous chunks, and calls
+    // function(thread_index, begin, end) for each chunk.
+    if (threads_count == 1 || count < 1024) {
+        function(0, (size_t)0, count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    size_t chunk = (count + threads_count - 1) / threads_count;
+    for (int t = 0; t < threads_count; t++) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        threads.emplace_back(function, t, begin, end);
+    }
+    for (auto& thread : threads) thread.join();
+}
+
+struct BFSResult
+{
+    // distance[x] is UNVISITED if x is unreachable. parent[x] is
+    // UNVISITED if x is unreachable, and NO_PARENT if x is a source.
+    std::vector<int> distance;
+    std::vector<int> parent;
+};
+
+class DirectionOptimizingBFS
+{
+    // A level synchronous BFS that picks, for each level, one of two ways
+    // to compute the next frontier (Beamer, Asanovic and Patterson):
+    //  - Top-down: the usual way. Every node in the frontier tries to claim
+    //    its unvisited neighbours. This is cheap while the frontier is small.
+    //  - Bottom-up: every unvisited node looks for a parent in the frontier,
+    //    scanning its incoming edges, and stops at the first one it finds.
+    //    When the frontier is large (the middle levels of a low diameter
+    //    graph), most of the edges of the frontier lead to already visited
+    //    nodes, and the early exit skips most of them.
+    //
+    // The switch is decided using the number of edges each step would check:
+    //  - top-down -> bottom-up when edges_of_frontier > edges_of_unvisited / alpha.
+    //  - bottom-up -> top-down when the frontier gets smaller than n / beta.
+    // alpha = 0 never switches, which gives a plain top-down BFS.
+    //
+    // The top-down frontier is a list of nodes, and the bottom-up frontier is
+    // a bitmap, which is what each step needs to iterate or test quickly.
+    // Both steps run on multiple threads:
+    //  - Top-down: the frontier is split between the threads, and a node is
+    //    claimed by a CAS on its parent, so it's added to the next frontier once.
+    //  - Bottom-up: the nodes are split in chunks of whole 64 bit words, so
+    //    each node and each word of the next bitmap is written by one thread.
+    //
+    // For undirected graphs, pass the graph as its own transpose.
+
+    const FlatGraph& graph;
+    const FlatGraph& transpose;
+    int threads_count;
+
+    int alpha;
+    int beta;
+
+    std::vector<std::atomic<int>> parent;
+    std::vector<int> distance;
+
+    std::vector<uint64_t> frontier_bitmap;
+    std::vector<uint64_t> next_bitmap;
+
+    std::vector<std::vector<int>> thread_buffers;
+    std::vector<long long> thread_counters;
+
+    int levels;
+    int bottom_up_levels;
+
+    bool is_set(const std::vector<uint64_t>& bitmap, int x) const { return (bitmap[x >> 6] >> (x & 63)) & 1; }
+
+    std::vector<int> merge_buffers()
+    {
+        std::vector<int> result;
+        for (auto& buffer : thread_buffers) {
+            result.insert(result.end(), buffer.begin(), buffer.end());
+            buffer.clear();
+        }
+        return result;
+    }
+
+    long long sum_counters()
+    {
+        long long sum = 0;
+        for (auto& counter : thread_counters) {
+            sum += counter;
+            counter = 0;
+        }
+        return sum;
+    }
+
+    // Returns the next frontier. The sum of the degrees of
+    // its nodes is left in thread_counters.
+    std::vector<int> top_down_step(const std::vector<int>& frontier, int depth)
+    {
+        parallel_for(threads_count, frontier.size(), [&](int thread, size_t begin, size_t end) {
+            auto& buffer = thread_buffers[thread];
+            long long edges = 0;
+            for (size_t i = begin; i < end; i++) {
+                int x = frontier[i];
+                for (uint32_t j = graph.offsets[x]; j < graph.offsets[x + 1]; j++) {
+                    int neighbour = graph.targets[j];
+                    // Checking first avoids the CAS on most of the visited nodes.
+                    if (parent[neighbour].load(std::memory_order_relaxed) != UNVISITED) continue;
+                    int expected = UNVISITED;
+                    if (parent[neighbour].compare_exchange_strong(expected, x, std::memory_order_relaxed)) {
+                        distance[neighbour] = depth + 1;
+                        buffer.push_back(neighbour);
+                        edges += graph.degree(neighbour);
+                    }
+                }
+            }
+            thread_counters[thread] += edges;
+        });
+        return merge_buffers();
+    }
+
+    // Fills next_bitmap and returns the size of the next frontier.
+    // The sum of the degrees of its nodes is left in thread_counters.
+    long long bottom_up_step(int depth)
+    {
+        std::vector<long long> sizes(threads_count, 0);
+        parallel_for(threads_count, next_bitmap.size(), [&](int thread, size_t begin, size_t end) {
+            long long edges = 0;
+            for (size_t word = begin; word < end; word++) {
+                uint64_t bits = 0;
+                int last = std::min<long long>(graph.n, (word + 1) * 64);
+                for (int x = word * 64; x < last; x++) {
+                    if (parent[x].load(std::memory_order_relaxed) != UNVISITED) continue;
+                    for (uint32_t j = transpose.offsets[x]; j < transpose.offsets[x + 1]; j++) {
+                        int neighbour = transpose.targets[j];
+                        if (is_set(frontier_bitmap, neighbour)) {
+                            parent[x].store(neighbour, std::memory_order_relaxed);
+                            distance[x] = depth + 1;
+                            bits |= (uint64_t)1 << (x & 63);
+                            edges += graph.degree(x);
+                            break;
+                        }
+                    }
+                }
+                next_bitmap[word] = bits;
+                sizes[thread] += __builtin_popcountll(bits);
+            }
+            thread_counters[thread] += edges;
+        });
+
+        long long size = 0;
+        for (long long s : sizes) size += s;
+        return size;
+    }
+
+    void list_to_bitmap(const std::vector<int>& frontier)
+    {
+        std::fill(frontier_bitmap.begin(), frontier_bitmap.end(), 0);
+        for (int x : frontier) {
+            frontier_bitmap[x >> 6] |= (uint64_t)1 << (x & 63);
+        }
+    }
+
+    std::vector<int> bitmap_to_list()
+    {
+        parallel_for(threads_count, frontier_bitmap.size(), [&](int thread, size_t begin, size_t end) {
+            for (size_t word = begin; word < end; word++) {
+                for (uint64_t bits = frontier_bitmap[word]; bits; bits &= bits - 1) {
+                    thread_buffers[thread].push_back(word * 64 + __builtin_ctzll(bits));
+                }
+            }
+        });
+        return merge_buffers();
+    }
+
+public:
+
+    DirectionOptimizingBFS(const FlatGraph& graph, const FlatGraph& transpose, int threads_count = 1, int alpha = 14, int beta = 24)
+        : graph(graph), transpose(transpose), threads_count(threads_count), alpha(alpha), beta(beta),
+          parent(graph.n), distance(graph.n), frontier_bitmap((graph.n + 63) / 64), next_bitmap((graph.n + 63) / 64),
+          thread_buffers(threads_count), thread_counters(threads_count), levels(0), bottom_up_levels(0) {}
+
+    BFSResult solve(const std::vector<int>& sources)
+    {
+        parallel_for(threads_count, graph.n, [&](int, size_t begin, size_t end) {
+            for (size_t x = begin; x < end; x++) {
+                parent[x].store(UNVISITED, std::memory_order_relaxed);
+                distance[x] = UNVISITED;
+            }
+        });
+
+        std::vector<int> frontier;
+        long long edges_of_frontier = 0;
+        for (int source : sources) {
+            if (parent[source].load(std::memory_order_relaxed) != UNVISITED) continue;
+            parent[source].store(NO_PARENT, std::memory_order_relaxed);
+            distance[source] = 0;
+            frontier.push_back(source);
+            edges_of_frontier += graph.degree(source);
+        }
+
+        long long edges_of_unvisited = (long long)graph.targets.size() - edges_of_frontier;
+        levels = 0;
+        bottom_up_levels = 0;
+
+        for (int depth = 0; !frontier.empty(); depth++)
+        {
+            levels++;
+
+            if (edges_of_frontier * alpha > edges_of_unvisited)
+            {
+                // Keep going bottom-up while the frontier is large or still growing.
+                list_to_bitmap(frontier);
+                long long size = frontier.size();
+                long long previous_size;
+                do {
+                    previous_size = size;
+                    size = bottom_up_step(depth);
+                    edges_of_unvisited -= sum_counters();
+                    std::swap(frontier_bitmap, next_bitmap);
+                    depth++;
+                    levels++;
+                    bottom_up_levels++;
+                } while (size > 0 && (size >= previous_size || size > graph.n / beta));
+                depth--;
+                levels--;
+
+                frontier = bitmap_to_list();
+                edges_of_frontier = 0;
+                for (int x : frontier) edges_of_frontier += graph.degree(x);
+                continue;
+            }
+
+            frontier = top_down_step(frontier, depth);
+            edges_of_frontier = sum_counters();
+            edges_of_unvisited -= edges_of_frontier;
+        }
+
+        BFSResult result;
+        result.distance = distance;
+        result.parent.resize(graph.n);
+        for (int x = 0; x < graph.n; x++) {
+            result.parent[x] = parent[x].load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    BFSResult solve(int source) {
+        return solve(std::vector<int>{source});
+    }
+
+    // The number of levels processed in the last call, and how many of them were bottom-up.
+    int get_levels() const { return levels; }
+    int get_bottom_up_levels() const { return bottom_up_levels; }
+};
+
+// The path from the closest source to the node, or an empty path if it's unreachable.
+std::vector<int> get_path(const BFSResult& result, int node)
+{
+    std::vector<int> path;
+    if (result.parent[node] == UNVISITED) return path;
+    for (int current_node = node; current_node >= 0; current_node = result.parent[current_node]) {
+        path.push_back(current_node);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+// A plain multi-source std::queue BFS, used only to compare against. It
+// isn't a copy of "Single Source/Min depths.cpp", since that one sets the
+// depth when a node is popped, so a node can be pushed again by a node of
+// its own level, and get a larger depth (and the queue grows a lot).
+std::vector<int> get_distances(const Graph& graph, const std::vector<int>& sources)
+{
+    std::vector<int> distance(graph.size(), UNVISITED);
+    std::queue<int> queue;
+    for (int source : sources) {
+        if (distance[source] != UNVISITED) continue;
+        distance[source] = 0;
+        queue.push(source);
+    }
+    while (!queue.empty()) {
+        int node = queue.front();
+        queue.pop();
+        for (int child : graph[node]) {
+            if (distance[child] == UNVISITED) {
+                distance[child] = distance[node] + 1;
+                queue.push(child);
+            }
+        }
+    }
+    return distance;
+}
+
+// The parents may differ between the versions, since any node
+// of the previous level can be the parent, so only their validity
+// is checked: the parent is one level up, and the edge exists.
+bool is_valid(const Graph& graph, const std::vector<int>& expected_distance, const BFSResult& result)
+{
+    if (result.distance != expected_distance) return false;
+    for (int x = 0; x < (int)graph.size(); x++) {
+        int p = result.parent[x];
+        if (expected_distance[x] == UNVISITED) {
+            if (p != UNVISITED) return false;
+        } else if (expected_distance[x] == 0) {
+            if (p != NO_PARENT) return false;
+        } else {
+            if (p < 0 || expected_distance[p] != expected_distance[x] - 1) return false;
+            if (std::find(graph[p].begin(), graph[p].end(), x) == graph[p].end()) return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::pair<int, int>> get_sample_edges()
+{
+    return {{1, 2}, {1, 5}, {1, 8}, {2, 3}, {3, 4}, {4, 2}, {5, 6}, {6, 3}, {6, 7}, {6, 8}};
+}
+
+std::vector<std::pair<int, int>> get_random_edges(int n, long long m, unsigned seed, bool undirected)
+{
+    std::mt19937 random(seed);
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(undirected ? 2 * m : m);
+    for (long long i = 0; i < m; i++) {
+        int a = random() % n, b = random() % n;
+        edges.push_back({a, b});
+        if (undirected) edges.push_back({b, a});
+    }
+    return edges;
+}
+
+// A scale-free graph (R-MAT, as in Graph500), which has a few nodes with
+// huge degrees and a small diameter, like social graphs.
+std::vector<std::pair<int, int>> get_rmat_edges(int scale, long long m, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(2 * m);
+    for (long long i = 0; i < m; i++) {
+        int a = 0, b = 0;
+        for (int bit = 0; bit < scale; bit++) {
+            double r = uniform(random);
+            if (r < 0.57) {}
+            else if (r < 0.76) b |= 1 << bit;
+            else if (r < 0.95) a |= 1 << bit;
+            else a |= 1 << bit, b |= 1 << bit;
+        }
+        edges.push_back({a, b});
+        edges.push_back({b, a});
+    }
+    return edges;
+}
+
+Graph to_graph(int n, const std::vector<std::pair<int, int>>& edges)
+{
+    Graph graph(n);
+    for (auto& edge : edges) graph[edge.first].push_back(edge.second);
+    return graph;
+}
+
+void test()
+{
+    auto edges = get_sample_edges();
+    FlatGraph graph(9, edges), transpose(9, edges, true);
+
+    auto result = DirectionOptimizingBFS(graph, transpose).solve({1, 2, 5});
+    for (int node : {7, 4, 3}) {
+        std::cout << "Shortest path to " << node << ": ";
+        for (int x : get_path(result, node)) {
+            std::cout << x << ' ';
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(7);
+    for (int i = 0; i < tests; i++)
+    {
+        int n = 1 + random() % 300;
+        bool undirected = i & 1;
+        auto edges = get_random_edges(n, random() % (4 * n), i, undirected);
+        FlatGraph graph(n, edges), transpose(n, edges, true);
+        Graph list = to_graph(n, edges);
+
+        std::vector<int> sources(1 + random() % 3);
+        for (int& source : sources) source = random() % n;
+        auto expected = get_distances(list, sources);
+
+        // Large alpha values force the bottom-up steps.
+        for (int alpha : {0, 14, 1'000'000}) {
+            for (int threads : {1, 3}) {
+                if (!is_valid(list, expected, DirectionOptimizingBFS(graph, transpose, threads, alpha).solve(sources)))
+                    std::cout << "Wrong BFS!" << std::endl;
+            }
+        }
+    }
+}
+
+void time_test(const std::string& name, int n, const std::vector<std::pair<int, int>>& edges)
+{
+    FlatGraph graph(n, edges), transpose(n, edges, true);
+    Graph list = to_graph(n, edges);
+    std::cout << name << " (V = " << n << ", E = " << edges.size() << ")" << std::endl;
+
+    // The source with the maximum degree, to start in the giant component.
+    int source = 0;
+    for (int x = 0; x < n; x++) {
+        if (graph.degree(x) > graph.degree(source)) source = x;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto expected = get_distances(list, {source});
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "std::queue BFS: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+
+    for (int alpha : {0, 14}) {
+        for (int threads = 1; threads <= 8; threads *= 2) {
+            DirectionOptimizingBFS bfs(graph, transpose, threads, alpha);
+            start = std::chrono::high_resolution_clock::now();
+            auto result = bfs.solve(source);
+            end = std::chrono::high_resolution_clock::now();
+            std::cout << (alpha == 14 ? "Direction-optimizing" : "Top-down only") << ", " << threads << " threads: "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms ("
+                      << bfs.get_levels() << " levels, " << bfs.get_bottom_up_levels() << " bottom-up)" << std::endl;
+            if (result.distance != expected)
+                std::cout << "Wrong distances!" << std::endl;
+        }
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test();
+    random_test(300);
+
+    time_test("Random undirected", 1'000'000, get_random_edges(1'000'000, 8'000'000, 1, true));
+    time_test("R-MAT undirected", 1 << 20, get_rmat_edges(20, 8'000'000, 1));
+}
@@ -0,0 +1,374 @@
+#include <functional>
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <map>
+#include <chrono>
+#include <random>
+#include <string>
+
+const int MAX_VAL = 1'000'000'000;
+
+struct Edge
+{
+    int from;
+    int to;
+    int weight;
+};
+
+struct Graph
+{
+    int nodes_count = 0;
+    std::vector<Edge> edges;
+
+    void add_edge(int from, int to, int weight) {
+        edges.push_back({from, to, weight});
+    }
+};
+
+class IncrementalDifferenceConstraintsSolver
+{
+    // Same model as "DifferenceConstraints.cpp": the constraint x1 - x2 <= diff
+    // is the edge x2 -> x1 with a weight of diff, and the solution is the
+    // shortest distances from a node with 0 edges to all the variables.
+    //
+    // Instead of running Bellman-Ford from scratch, the current solution is kept,
+    // and it's always feasible: value[to] <= value[from] + weight on every edge.
+    // This means the reduced weights (value[from] + weight - value[to]) are all
+    // non-negative, which is what Dijkstra needs. When x2 -> x1 is added:
+    //  - If value[x1] <= value[x2] + diff, nothing changes.
+    //  - Otherwise, x1 has to go down by value[x1] - value[x2] - diff. Going down
+    //    may break the edges out of x1, and so on. Each node y reached from x
+    //    has to go down by decrease[x] - reduced_weight(x, y), which is never more
+    //    than decrease[x], so the nodes are taken in the order of the largest
+    //    decrease first (Dijkstra with a max-heap), and each is final once taken.
+    //  - If x2 itself has to go down, the new edge closes a negative cycle, and the
+    //    constraint is rejected, leaving everything as it was before it. This is
+    //    checked as soon as x2 is reached, without waiting for it to be taken.
+    // Only the nodes that actually change are visited.
+    //
+    // Starting from 0 and only decreasing as little as needed keeps the largest
+    // solution with all the values <= 0, which is exactly what Bellman-Ford gives
+    // from the extra node, so the solutions are the same as the original's.
+
+    struct Arc
+    {
+        int to;
+        int weight;
+    };
+
+    std::vector<std::vector<Arc>> graph;
+    std::vector<int> value;
+
+    int last_id = 0;
+    std::map<std::string, int> map;
+
+    // How much each node goes down in the current addition, 0 if it doesn't.
+    std::vector<int> decrease;
+    std::vector<int> touched;
+
+    long long visited_nodes = 0;
+
+    int get_id(const std::string &x)
+    {
+        auto it = map.find(x);
+
+        if (it == map.end())
+        {
+            map[x] = last_id;
+            return add_variable();
+        }
+
+        return it->second;
+    }
+
+    void clear_decreases()
+    {
+        for (int x : touched) decrease[x] = 0;
+        touched.clear();
+    }
+
+public:
+
+    int add_variable()
+    {
+        graph.emplace_back();
+        value.push_back(0);
+        decrease.push_back(0);
+        return last_id++;
+    }
+
+    // Adds x1 - x2 <= diff, using the ids of add_variable. Returns false, without
+    // adding the constraint, if it contradicts the previous constraints.
+    bool add_constraint(int x1, int x2, int diff)
+    {
+        // x1 - x1 <= diff is a cycle of its own, and never changes the values.
+        if (x1 == x2) {
+            if (diff < 0) return false;
+            graph[x2].push_back({x1, diff});
+            return true;
+        }
+
+        int needed = value[x1] - (value[x2] + diff);
+        if (needed <= 0) {
+            graph[x2].push_back({x1, diff});
+            return true;
+        }
+
+        struct QueueFrame
+        {
+            int decrease;
+            int node;
+
+            bool operator<(const QueueFrame &other) const {
+                return decrease < other.decrease;
+            }
+        };
+
+        std::priority_queue<QueueFrame> queue;
+        decrease[x1] = needed;
+        touched.push_back(x1);
+        queue.push({needed, x1});
+
+        while (!queue.empty())
+        {
+            auto frame = queue.top();
+            queue.pop();
+
+            int x = frame.node;
+            if (frame.decrease != decrease[x]) continue;
+            visited_nodes++;
+
+            for (auto& arc : graph[x]) {
+                int reduced_weight = value[x] + arc.weight - value[arc.to];
+                int new_decrease = decrease[x] - reduced_weight;
+                if (new_decrease > decrease[arc.to]) {
+                    if (arc.to == x2) {
+                        // x2 -> x1 -> ... -> x -> x2 is a negative cycle.
+                        clear_decreases();
+                        return false;
+                    }
+                    if (decrease[arc.to] == 0) touched.push_back(arc.to);
+                    decrease[arc.to] = new_decrease;
+                    queue.push({new_decrease, arc.to});
+                }
+            }
+        }
+
+        for (int x : touched) value[x] -= decrease[x];
+        clear_decreases();
+        graph[x2].push_back({x1, diff});
+        return true;
+    }
+
+    bool add_constraint(const std::string &x1, const std::string &x2, int diff)
+    {
+        int id1 = get_id(x1);
+        int id2 = get_id(x2);
+        return add_constraint(id1, id2, diff);
+    }
+
+    int get_value(int x) const {
+        return value[x];
+    }
+
+    std::map<std::string, int> get_solution() const
+    {
+        std::map<std::string, int> result;
+
+        for (auto &x : map) {
+            result[x.first] = value[x.second];
+        }
+
+        return result;
+    }
+
+    // The number of nodes that went down so far, over all the additions.
+    long long get_visited_nodes() const {
+        return visited_nodes;
+    }
+};
+
+// A copy of the one in "DifferenceConstraints.cpp", used only to compare against.
+std::vector<int> bellman_ford(const Graph &graph, int source)
+{
+    int V = graph.nodes_count;
+    std::vector<int> minimum_distances(V);
+
+    minimum_distances[source] = 0;
+
+    for (int x = 1; x <= 2; x++) {
+        for (int i = 0; i < V - 1; i++)
+        {
+            bool relaxed = false;
+
+            for (auto &edge : graph.edges)
+            {
+                int old_weight = minimum_distances[edge.to];
+                int new_weight = minimum_distances[edge.from] + edge.weight;
+
+                if (new_weight < old_weight)
+                {
+                    minimum_distances[edge.to] =
+                            (x == 1) ? new_weight : -MAX_VAL;
+
+                    relaxed = true;
+                }
+            }
+
+            if (!relaxed) {
+                break;
+            }
+        }
+    }
+
+    return minimum_distances;
+}
+
+struct Constraint
+{
+    int x1;
+    int x2;
+    int diff;
+};
+
+// Node 0 has a 0 edge to every variable, and variable i is node i + 1, as in "DifferenceConstraints.cpp".
+Graph get_graph(int variables, const std::vector<Constraint>& constraints)
+{
+    Graph graph;
+    graph.nodes_count = variables + 1;
+    for (int i = 1; i <= variables; i++) graph.add_edge(0, i, 0);
+    for (auto& constraint : constraints) graph.add_edge(constraint.x2 + 1, constraint.x1 + 1, constraint.diff);
+    return graph;
+}
+
+// Mostly satisfied by a hidden schedule with some slack, so most of the stream
+// is feasible. The rest are a bit tighter than the schedule, so some of them
+// push the values down, and some of them close negative cycles.
+std::vector<Constraint> get_random_stream(int variables, int count, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<int> x(variables);
+    for (int& value : x) value = random() % 10'000;
+
+    std::vector<Constraint> stream(count);
+    for (auto& constraint : stream) {
+        int x1 = random() % variables;
+        int x2 = random() % variables;
+        int slack = (random() % 20) ? (int)(random() % 100) : -(int)(random() % 100);
+        constraint = {x1, x2, x[x1] - x[x2] + slack};
+    }
+    return stream;
+}
+
+void print_solution(IncrementalDifferenceConstraintsSolver &solver)
+{
+    for (auto &solution : solver.get_solution()) {
+        std::cout << solution.first << ": " << solution.second << std::endl;
+    }
+}
+
+void test()
+{
+    IncrementalDifferenceConstraintsSolver solver;
+
+    // The systems of "DifferenceConstraints.cpp".
+    solver.add_constraint("x1", "x2", 3);
+    solver.add_constraint("x2", "x3", -5);
+    solver.add_constraint("x1", "x3", 2);
+    print_solution(solver);
+    std::cout << std::endl;
+
+    IncrementalDifferenceConstraintsSolver unsolvable;
+    std::cout << unsolvable.add_constraint("x1", "x2", -2) << std::endl;
+    std::cout << unsolvable.add_constraint("x2", "x3", -5) << std::endl;
+    std::cout << unsolvable.add_constraint("x3", "x1", -3) << " (rejected)" << std::endl;
+    print_solution(unsolvable);
+    std::cout << std::endl;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(31);
+    for (int t = 0; t < tests; t++)
+    {
+        int variables = 1 + random() % 30;
+        auto stream = get_random_stream(variables, random() % 100, t);
+
+        IncrementalDifferenceConstraintsSolver solver;
+        for (int i = 0; i < variables; i++) solver.add_variable();
+
+        std::vector<Constraint> accepted;
+        for (auto& constraint : stream)
+        {
+            accepted.push_back(constraint);
+            auto expected = bellman_ford(get_graph(variables, accepted), 0);
+            bool feasible = true;
+            for (int value : expected) if (value == -MAX_VAL) feasible = false;
+            if (!feasible) accepted.pop_back();
+
+            if (solver.add_constraint(constraint.x1, constraint.x2, constraint.diff) != feasible) {
+                std::cout << "Wrong feasibility!" << std::endl;
+                break;
+            }
+
+            if (feasible) {
+                for (int i = 0; i < variables; i++) {
+                    if (solver.get_value(i) != expected[i + 1]) {
+                        std::cout << "Wrong solution!" << std::endl;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void time_test(int variables, int count)
+{
+    auto stream = get_random_stream(variables, count, variables);
+    std::cout << variables << " variables, a stream of " << count << " constraints" << std::endl;
+
+    IncrementalDifferenceConstraintsSolver solver;
+    for (int i = 0; i < variables; i++) solver.add_variable();
+
+    std::vector<Constraint> accepted;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto& constraint : stream) {
+        if (solver.add_constraint(constraint.x1, constraint.x2, constraint.diff))
+            accepted.push_back(constraint);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << "Incremental: " << us << " us, " << (double)us / count << " us per constraint, "
+              << count - accepted.size() << " rejected, "
+              << (double)solver.get_visited_nodes() / count << " nodes visited per constraint" << std::endl;
+
+    // Solving from scratch after every constraint costs at least one solve of the
+    // accepted constraints so far, so a single solve of all of them is a lower bound
+    // on the cost per constraint towards the end of the stream.
+    auto graph = get_graph(variables, accepted);
+    start = std::chrono::high_resolution_clock::now();
+    auto expected = bellman_ford(graph, 0);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "From scratch: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+              << " us for one solve of the " << accepted.size() << " accepted constraints" << std::endl;
+
+    for (int i = 0; i < variables; i++) {
+        if (solver.get_value(i) != expected[i + 1]) {
+            std::cout << "Wrong solution!" << std::endl;
+            break;
+        }
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test();
+    random_test(200);
+
+    time_test(1000, 100'000);
+    time_test(10'000, 100'000);
+}
@@ -0,0 +1,555 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+const int MAX_VAL = 1'000'000'000;
+
+struct Edge
+{
+    int from;
+    int to;
+    int weight;
+};
+
+struct Graph
+{
+    int nodes_count;
+    std::vector<Edge> edges;
+
+    void add_edge(int from, int to, int weight) {
+        edges.push_back({from, to, weight});
+    }
+};
+
+class SPFACalculator
+{
+    // Bellman-Ford with a worklist instead of rounds over all the edges: only
+    // the nodes whose distance changed since their last scan are in the queue,
+    // and it stops as soon as the queue is empty.
+    //
+    // The order of the queue doesn't affect the correctness, only the speed:
+    //  - SLF (Small Label First): a node is pushed to the front instead of the
+    //    back if its distance is smaller than the distance of the front.
+    //  - LLL (Large Label Last): while the front has a distance larger than
+    //    the average of the queue, it's moved to the back.
+    // Both are off by default: with the subtree disassembly, they do more scans
+    // than the plain FIFO order on all the graphs in the tests below.
+    //
+    // Negative cycles are detected using Tarjan's subtree disassembly. The
+    // parents form a shortest path tree, kept as a list of nodes in preorder
+    // with their depths, so the subtree of x is x followed by the nodes after
+    // it with a larger depth. When the distance of v decreases through u:
+    //  - The nodes in the subtree of v have distances through the old distance
+    //    of v, so they are removed from the tree. They will get better distances
+    //    through v anyway, so scanning them now would be a waste, and they're
+    //    skipped when they get out of the queue.
+    //  - If u is in this subtree, then the tree path v -> ... -> u plus the edge
+    //    u -> v is a negative cycle: every tree edge is tight (a node is removed
+    //    from the tree whenever the distance of its parent changes), so the path
+    //    costs distance[u] - distance[v], and the edge costs less than
+    //    distance[v] - distance[u].
+    //  - v is inserted back right after u, as its child.
+    // This finds a cycle as soon as it's in the tree, instead of after V rounds,
+    // and removing the subtrees reduces the number of scans in general.
+    //
+    // The node n is a virtual root, which is the parent of the source, or of all
+    // the nodes in solve_from_all (the same as an extra node with 0 edges to all).
+
+    int n;
+    bool use_slf;
+    bool use_lll;
+
+    // The graph, flat. The edges of x are [offsets[x], offsets[x + 1]).
+    struct Arc
+    {
+        int to;
+        int weight;
+    };
+
+    std::vector<int> offsets;
+    std::vector<Arc> arcs;
+
+    // Everything about a node is together, since the nodes are visited
+    // in no particular order, and each visit touches most of these.
+    // next and previous link the tree in preorder, as a circular doubly
+    // linked list starting at n.
+    struct Node
+    {
+        int distance;
+        int parent;
+        int next;
+        int previous;
+        int depth;
+        bool in_tree;
+        bool in_queue;
+    };
+
+    std::vector<Node> nodes;
+
+    std::deque<int> queue;
+    long long queue_sum;
+
+    std::vector<int> negative_cycle;
+
+    long long scans;
+    long long relaxations;
+
+    void reset()
+    {
+        nodes.assign(n + 1, {MAX_VAL, -1, n, n, 0, false, false});
+        nodes[n].distance = 0;
+        nodes[n].in_tree = true;
+        queue.clear();
+        queue_sum = 0;
+        negative_cycle.clear();
+        scans = 0;
+        relaxations = 0;
+    }
+
+    void insert_after(int u, int v)
+    {
+        Node& node = nodes[v];
+        node.depth = nodes[u].depth + 1;
+        node.parent = u;
+        node.in_tree = true;
+        node.next = nodes[u].next;
+        node.previous = u;
+        nodes[nodes[u].next].previous = v;
+        nodes[u].next = v;
+    }
+
+    // Removes the subtree of v from the tree. Returns
+    // false if u is in it (a negative cycle).
+    bool remove_subtree(int v, int u)
+    {
+        if (!nodes[v].in_tree) return true;
+
+        int before = nodes[v].previous;
+        int x = v;
+        do {
+            if (x == u) return false;
+            nodes[x].in_tree = false;
+            x = nodes[x].next;
+        } while (x != n && nodes[x].depth > nodes[v].depth);
+
+        nodes[before].next = x;
+        nodes[x].previous = before;
+        return true;
+    }
+
+    void push(int v)
+    {
+        nodes[v].in_queue = true;
+        queue_sum += nodes[v].distance;
+        if (use_slf && !queue.empty() && nodes[v].distance < nodes[queue.front()].distance) {
+            queue.push_front(v);
+        } else {
+            queue.push_back(v);
+        }
+    }
+
+    int pop()
+    {
+        if (use_lll) {
+            // Some node has at most the average, so this stops.
+            while ((long long)nodes[queue.front()].distance * (long long)queue.size() > queue_sum) {
+                queue.push_back(queue.front());
+                queue.pop_front();
+            }
+        }
+        int x = queue.front();
+        queue.pop_front();
+        nodes[x].in_queue = false;
+        queue_sum -= nodes[x].distance;
+        return x;
+    }
+
+    void save_cycle(int u, int v)
+    {
+        for (int x = u; x != v; x = nodes[x].parent) {
+            negative_cycle.push_back(x);
+        }
+        negative_cycle.push_back(v);
+        std::reverse(negative_cycle.begin(), negative_cycle.end());
+    }
+
+    bool run()
+    {
+        while (!queue.empty())
+        {
+            int u = pop();
+            if (!nodes[u].in_tree) continue;
+            scans++;
+
+            for (int i = offsets[u]; i < offsets[u + 1]; i++)
+            {
+                int v = arcs[i].to;
+                int new_distance = nodes[u].distance + arcs[i].weight;
+                if (new_distance >= nodes[v].distance) continue;
+
+                relaxations++;
+                if (!remove_subtree(v, u)) {
+                    save_cycle(u, v);
+                    return false;
+                }
+
+                if (nodes[v].in_queue) queue_sum -= nodes[v].distance - new_distance;
+                nodes[v].distance = new_distance;
+                insert_after(u, v);
+                if (!nodes[v].in_queue) push(v);
+            }
+        }
+        return true;
+    }
+
+public:
+
+    explicit SPFACalculator(const Graph& graph, bool use_slf = false, bool use_lll = false)
+        : n(graph.nodes_count), use_slf(use_slf), use_lll(use_lll), offsets(n + 2, 0)
+    {
+        for (auto& edge : graph.edges) offsets[edge.from + 1]++;
+        for (int i = 0; i <= n; i++) offsets[i + 1] += offsets[i];
+
+        arcs.resize(graph.edges.size());
+        std::vector<int> position(offsets.begin(), offsets.end() - 1);
+        for (auto& edge : graph.edges) {
+            arcs[position[edge.from]++] = {edge.to, edge.weight};
+        }
+    }
+
+    // Returns false if a negative cycle is reachable from the source.
+    bool solve(int source)
+    {
+        reset();
+        nodes[source].distance = 0;
+        insert_after(n, source);
+        push(source);
+        return run();
+    }
+
+    // All the nodes start at 0, as if there is a source with 0 edges to all
+    // of them. This is what difference constraints need. Returns false if the
+    // graph has a negative cycle anywhere.
+    bool solve_from_all()
+    {
+        reset();
+        for (int x = n - 1; x >= 0; x--) {
+            nodes[x].distance = 0;
+            insert_after(n, x);
+            push(x);
+        }
+        return run();
+    }
+
+    // MAX_VAL means there is no path. Not valid after a negative cycle.
+    int get_distance(int x) const { return nodes[x].distance; }
+
+    // The parent in the shortest path tree, or -1 for the source and the unreachable nodes.
+    int get_parent(int x) const { return nodes[x].parent == n ? -1 : nodes[x].parent; }
+
+    // The nodes of the cycle found, in order, the last one has an edge to the first one.
+    const std::vector<int>& get_negative_cycle() const { return negative_cycle; }
+
+    long long get_scans() const { return scans; }
+    long long get_relaxations() const { return relaxations; }
+};
+
+// A copy of "Bellman-Ford.cpp", used only to compare against. It counts the
+// checked edges, and it skips the unreachable nodes, which the original
+// doesn't do (MAX_VAL plus a negative edge is less than MAX_VAL there).
+std::vector<int> bellman_ford(const Graph &graph, int source, long long& edge_checks)
+{
+    int V = graph.nodes_count;
+    std::vector<int> minimum_distances(V, MAX_VAL);
+
+    minimum_distances[source] = 0;
+
+    for (int i = 0; i < V - 1; i++) {
+
+        bool relaxed = false;
+
+        for (auto &edge : graph.edges)
+        {
+            edge_checks++;
+            if (minimum_distances[edge.from] == MAX_VAL) continue;
+
+            int old_weight = minimum_distances[edge.to];
+            int new_weight = minimum_distances[edge.from] + edge.weight;
+
+            if (new_weight < old_weight) {
+                minimum_distances[edge.to] = new_weight;
+                relaxed = true;
+            }
+        }
+
+        if (!relaxed) {
+            break;
+        }
+    }
+
+    return minimum_distances;
+}
+
+// A copy of the one in "DifferenceConstraints.cpp" (and "IsPathAffectedByNegativeCycle.cpp"),
+// used only to compare against. It counts the checked edges.
+std::vector<int> bellman_ford_twice(const Graph &graph, int source, long long& edge_checks)
+{
+    int V = graph.nodes_count;
+    std::vector<int> minimum_distances(V);
+
+    minimum_distances[source] = 0;
+
+    for (int x = 1; x <= 2; x++) {
+        for (int i = 0; i < V - 1; i++)
+        {
+            bool relaxed = false;
+
+            for (auto &edge : graph.edges)
+            {
+                edge_checks++;
+                int old_weight = minimum_distances[edge.to];
+                int new_weight = minimum_distances[edge.from] + edge.weight;
+
+                if (new_weight < old_weight)
+                {
+                    minimum_distances[edge.to] =
+                            (x == 1) ? new_weight : -MAX_VAL;
+
+                    relaxed = true;
+                }
+            }
+
+            if (!relaxed) {
+                break;
+            }
+        }
+    }
+
+    return minimum_distances;
+}
+
+Graph get_sample_graph()
+{
+    // The graph of "IsPathAffectedByNegativeCycle.cpp".
+    Graph graph {6};
+
+    graph.add_edge(1, 2, 5);
+    graph.add_edge(2, 1, -10);
+
+    graph.add_edge(4, 5, 2);
+
+    graph.add_edge(5, 2, 3);
+
+    graph.add_edge(5, 3, 4);
+
+    return graph;
+}
+
+// Many negative edges, but no negative cycles: each edge is a non-negative
+// weight plus p(u) - p(v) for random p's, and these cancel out on cycles.
+// With a negative_cycle, a random cycle of 3 nodes is added with a total of -1.
+Graph get_random_graph(int n, int m, bool negative_cycle, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<int> p(n);
+    for (int& value : p) value = random() % 1000;
+
+    Graph graph {n};
+    for (int i = 0; i < m; i++) {
+        int from = random() % n;
+        int to = random() % n;
+        graph.add_edge(from, to, random() % 100 + p[from] - p[to]);
+    }
+
+    if (negative_cycle && n >= 3) {
+        int a = random() % n, b = random() % n, c = random() % n;
+        graph.add_edge(a, b, 0);
+        graph.add_edge(b, c, 0);
+        graph.add_edge(c, a, -1);
+    }
+
+    return graph;
+}
+
+// A side x side grid with edges between neighbours in both directions, in a
+// random order, with negative edges as in get_random_graph. The shortest
+// paths are long, so Bellman-Ford needs many rounds.
+Graph get_grid_graph(int side, unsigned seed)
+{
+    std::mt19937 random(seed);
+    int n = side * side;
+    std::vector<int> p(n);
+    for (int& value : p) value = random() % 1000;
+
+    Graph graph {n};
+    for (int x = 0; x < n; x++) {
+        for (int neighbour : {x + 1, x + side}) {
+            if (neighbour >= n || (neighbour == x + 1 && neighbour % side == 0)) continue;
+            graph.add_edge(x, neighbour, random() % 100 + p[x] - p[neighbour]);
+            graph.add_edge(neighbour, x, random() % 100 + p[neighbour] - p[x]);
+        }
+    }
+    std::shuffle(graph.edges.begin(), graph.edges.end(), random);
+    return graph;
+}
+
+// A system of difference constraints x_a - x_b <= c, as built by
+// "DifferenceConstraints.cpp": node 0 has a 0 edge to every variable.
+Graph get_random_system(int variables, int constraints, bool feasible, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<int> x(variables + 1);
+    for (int& value : x) value = random() % 1000;
+
+    Graph graph {variables + 1};
+    for (int i = 1; i <= variables; i++) graph.add_edge(0, i, 0);
+    for (int i = 0; i < constraints; i++) {
+        int a = 1 + random() % variables;
+        int b = 1 + random() % variables;
+        // Satisfied by x, so the system is feasible.
+        graph.add_edge(b, a, x[a] - x[b] + random() % 50);
+    }
+    if (!feasible && variables >= 2) {
+        graph.add_edge(1, 2, -1000);
+        graph.add_edge(2, 1, 999);
+    }
+    return graph;
+}
+
+bool is_cycle_negative(const Graph& graph, const std::vector<int>& cycle)
+{
+    if (cycle.empty()) return false;
+    long long total = 0;
+    for (int i = 0; i < (int)cycle.size(); i++) {
+        int from = cycle[i], to = cycle[(i + 1) % cycle.size()];
+        int best = MAX_VAL;
+        for (auto& edge : graph.edges) {
+            if (edge.from == from && edge.to == to) best = std::min(best, edge.weight);
+        }
+        if (best == MAX_VAL) return false;
+        total += best;
+    }
+    return total < 0;
+}
+
+void test()
+{
+    Graph graph = get_sample_graph();
+    SPFACalculator calculator(graph);
+    if (calculator.solve(4)) {
+        std::cout << "No negative cycle." << std::endl;
+    } else {
+        std::cout << "Negative cycle:";
+        for (int x : calculator.get_negative_cycle()) std::cout << ' ' << x;
+        std::cout << std::endl;
+    }
+
+    graph.edges.erase(graph.edges.begin() + 1);
+    calculator = SPFACalculator(graph);
+    calculator.solve(4);
+    for (int i = 0; i < 6; i++) {
+        if (i == 4) continue;
+        int distance = calculator.get_distance(i);
+        if (distance == MAX_VAL) {
+            std::cout << "There is no path from 4 to " << i << "." << std::endl;
+        } else {
+            std::cout << "Minimum distance from 4 to " << i << " is " << distance << "." << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(29);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 100;
+        bool negative_cycle = random() % 3 == 0;
+        Graph graph = get_random_graph(n, random() % (4 * n), negative_cycle, t);
+        int source = random() % n;
+
+        long long edge_checks = 0;
+        auto expected = bellman_ford(graph, source, edge_checks);
+
+        // A reachable negative cycle still relaxes in round V.
+        bool expected_cycle = false;
+        for (auto& edge : graph.edges) {
+            if (expected[edge.from] != MAX_VAL && expected[edge.from] + edge.weight < expected[edge.to]) expected_cycle = true;
+        }
+
+        for (int heuristics = 0; heuristics < 4; heuristics++)
+        {
+            SPFACalculator calculator(graph, heuristics & 1, heuristics & 2);
+            bool ok = calculator.solve(source);
+            if (ok == expected_cycle) {
+                std::cout << "Wrong negative cycle detection!" << std::endl;
+            } else if (!ok) {
+                if (!is_cycle_negative(graph, calculator.get_negative_cycle()))
+                    std::cout << "Wrong negative cycle!" << std::endl;
+            } else {
+                for (int x = 0; x < n; x++) {
+                    if (calculator.get_distance(x) != expected[x]) {
+                        std::cout << "Wrong distances!" << std::endl;
+                        break;
+                    }
+                }
+            }
+
+            // Anywhere in the graph.
+            bool any_cycle = !SPFACalculator(graph, heuristics & 1, heuristics & 2).solve_from_all();
+            if (any_cycle != (negative_cycle && n >= 3))
+                std::cout << "Wrong negative cycle detection!" << std::endl;
+        }
+    }
+}
+
+void time_test(const std::string& name, const Graph& graph, int source, int repetitions, bool difference_constraints)
+{
+    std::cout << name << " (V = " << graph.nodes_count << ", E = " << graph.edges.size() << ")" << std::endl;
+
+    long long edge_checks = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < repetitions; i++) {
+        if (difference_constraints) bellman_ford_twice(graph, source, edge_checks);
+        else bellman_ford(graph, source, edge_checks);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << (difference_constraints ? "DifferenceConstraints.cpp" : "Bellman-Ford.cpp") << ": "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / repetitions << " us, "
+              << edge_checks / repetitions << " edge checks" << std::endl;
+
+    const char* names[] = {"SPFA", "SPFA + SLF", "SPFA + LLL", "SPFA + SLF + LLL"};
+    for (int heuristics = 0; heuristics < 4; heuristics++)
+    {
+        SPFACalculator calculator(graph, heuristics & 1, heuristics & 2);
+        bool ok = true;
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < repetitions; i++) ok = calculator.solve(source);
+        end = std::chrono::high_resolution_clock::now();
+
+        // Each scan checks the edges of one node, E / V on average.
+        std::cout << names[heuristics] << ": "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / repetitions << " us, "
+                  << calculator.get_scans() << " scans, " << calculator.get_relaxations() << " relaxations"
+                  << (ok ? "" : ", negative cycle found") << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test();
+    random_test(300);
+
+    time_test("Random, negative edges", get_random_graph(100'000, 400'000, false, 1), 0, 10, false);
+    time_test("Grid, negative edges", get_grid_graph(300, 2), 0, 1, false);
+    time_test("Difference constraints, feasible", get_random_system(200, 1000, true, 3), 0, 1000, true);
+    time_test("Difference constraints, infeasible", get_random_system(200, 1000, false, 4), 0, 1000, true);
+    time_test("Difference constraints, feasible", get_random_system(20'000, 100'000, true, 5), 0, 1, true);
+    time_test("Difference constraints, infeasible", get_random_system(20'000, 100'000, false, 6), 0, 1, true);
+}
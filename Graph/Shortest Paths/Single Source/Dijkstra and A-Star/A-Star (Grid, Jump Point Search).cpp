@@ -0,0 +1,785 @@
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <stack>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <algorithm>
+#include <climits>
+#include <string>
+
+const int MAX_VALUE = INT_MAX;
+
+struct Coord
+{
+    int x = 0;
+    int y = 0;
+};
+
+// The moves are the 8 directions, with a cost of 2 for the straight ones
+// and 3 for the diagonal ones (3 / 2 is close enough to sqrt(2), and keeps
+// everything in integers). A diagonal move can't cut a corner: both of the
+// cells next to it have to be free.
+const int STRAIGHT_COST = 2;
+const int DIAGONAL_COST = 3;
+
+class BitGrid
+{
+    // One bit per cell, set if the cell is free, row by row.
+    // There is a blocked border of one cell around the cells,
+    // and the bits after the end of each row are blocked too,
+    // so the scans below never need to check the bounds.
+
+    int words;
+    std::vector<uint64_t> bits;
+
+public:
+
+    BitGrid(int width, int height) : words((width + 2 + 63) / 64), bits((size_t)words * (height + 2)) {}
+
+    const uint64_t* row(int y) const { return bits.data() + (size_t)y * words; }
+
+    int words_per_row() const { return words; }
+
+    // The coordinates here include the border.
+    bool is_free(int x, int y) const {
+        return row(y)[x >> 6] >> (x & 63) & 1;
+    }
+
+    void set_free(int x, int y, bool free)
+    {
+        uint64_t& word = bits[(size_t)y * words + (x >> 6)];
+        uint64_t bit = 1ULL << (x & 63);
+        word = free ? (word | bit) : (word & ~bit);
+    }
+};
+
+class GridMap
+{
+    // The cells are kept twice: by rows, and by columns (the transpose),
+    // so that both the horizontal and the vertical scans of the jump
+    // point search go through 64 cells at a time.
+
+    int width;
+    int height;
+    BitGrid rows;
+    BitGrid columns;
+
+public:
+
+    // All the cells are blocked at first.
+    GridMap(int width, int height) : width(width), height(height), rows(width, height), columns(height, width) {}
+
+    int get_width() const { return width; }
+    int get_height() const { return height; }
+
+    void set_free(int x, int y, bool free)
+    {
+        rows.set_free(x + 1, y + 1, free);
+        columns.set_free(y + 1, x + 1, free);
+    }
+
+    bool is_free(int x, int y) const {
+        return rows.is_free(x + 1, y + 1);
+    }
+
+    const BitGrid& get_rows() const { return rows; }
+    const BitGrid& get_columns() const { return columns; }
+};
+
+class GridAStar
+{
+    // A* specialized for GridMap. The nodes are the cells themselves,
+    // so there's no graph to build, and the heuristic is the octile
+    // distance (the cost of the shortest path without the obstacles),
+    // which only takes a few integer operations per node.
+    //
+    // The open list is a binary heap that knows the position of each
+    // node in it, so when a shorter path to a node is found, its key is
+    // decreased in place instead of pushing the node again.
+    //
+    // With use_jump_points, it's Jump Point Search (Harabor and Grastien),
+    // in its version that doesn't cut corners. On a uniform cost grid, most
+    // of the shortest paths are symmetric to each other, so instead of adding
+    // all the neighbours of a node, it moves in a straight line (or a diagonal)
+    // until it reaches a node where the path could have to turn (a jump point),
+    // and only that node goes to the open list:
+    //  - A straight move stops at the target, at a blocked cell (no jump point
+    //    here), or at a cell with a free cell on a side that was blocked one
+    //    step behind (a "forced" neighbour).
+    //  - A diagonal move stops at the target, or at a cell from which either
+    //    of the straight moves that make up the diagonal stops at a jump point.
+    // The straight moves are done on a whole word of 64 cells at a time: the
+    // forced neighbours of a line are (side & ~side shifted by one cell),
+    // so the first stop is the first set bit of (~line | forced neighbours).
+    //
+    // The per node state isn't cleared between the queries. Each query has
+    // its own id, and a node that wasn't touched by the current query is
+    // treated as unvisited.
+
+    struct Node
+    {
+        int distance;
+        int parent;
+        int heap_position;
+        unsigned query;
+    };
+
+    struct HeapItem
+    {
+        int f;
+        int h;
+        int node;
+
+        bool operator<(const HeapItem& other) const {
+            return f < other.f || (f == other.f && h < other.h);
+        }
+    };
+
+    static const int CLOSED = -1;
+
+    const GridMap& map;
+    bool use_jump_points;
+
+    // The ids of the nodes include the border of the map.
+    int stride;
+    std::vector<Node> nodes;
+    std::vector<HeapItem> heap;
+    unsigned query = 0;
+
+    int target_x = 0;
+    int target_y = 0;
+    int target = -1;
+    long long expanded = 0;
+
+    int id(int x, int y) const { return y * stride + x; }
+
+    bool is_free(int x, int y) const { return map.get_rows().is_free(x, y); }
+
+    int heuristic(int x, int y) const
+    {
+        int dx = std::abs(x - target_x);
+        int dy = std::abs(y - target_y);
+        return STRAIGHT_COST * std::max(dx, dy) + (DIAGONAL_COST - STRAIGHT_COST) * std::min(dx, dy);
+    }
+
+    void move_to(int position, HeapItem item)
+    {
+        heap[position] = item;
+        nodes[item.node].heap_position = position;
+    }
+
+    void sift_up(int position)
+    {
+        HeapItem item = heap[position];
+        while (position > 0) {
+            int parent = (position - 1) / 2;
+            if (!(item < heap[parent])) break;
+            move_to(position, heap[parent]);
+            position = parent;
+        }
+        move_to(position, item);
+    }
+
+    void sift_down(int position)
+    {
+        HeapItem item = heap[position];
+        int size = heap.size();
+        while (true) {
+            int child = 2 * position + 1;
+            if (child >= size) break;
+            if (child + 1 < size && heap[child + 1] < heap[child]) child++;
+            if (!(heap[child] < item)) break;
+            move_to(position, heap[child]);
+            position = child;
+        }
+        move_to(position, item);
+    }
+
+    int pop()
+    {
+        int node = heap[0].node;
+        nodes[node].heap_position = CLOSED;
+        HeapItem last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            sift_down(0);
+        }
+        return node;
+    }
+
+    // Adds the node to the open list, or decreases its key
+    // if it's already there, unless it's already closed.
+    void relax(int x, int y, int parent, int distance)
+    {
+        int node = id(x, y);
+        Node& info = nodes[node];
+        if (info.query != query) {
+            info = {MAX_VALUE, -1, -2, query};
+        }
+        if (info.heap_position == CLOSED || distance >= info.distance) return;
+
+        info.distance = distance;
+        info.parent = parent;
+        int h = heuristic(x, y);
+        if (info.heap_position < 0) {
+            heap.push_back({distance + h, h, node});
+            sift_up(heap.size() - 1);
+        } else {
+            heap[info.heap_position].f = distance + h;
+            sift_up(info.heap_position);
+        }
+    }
+
+    // The first position from start, in the direction (1 or -1), along the
+    // given line of the grid, that's either blocked or has a forced neighbour.
+    static int scan(const BitGrid& grid, int line, int start, int direction)
+    {
+        const uint64_t* current = grid.row(line);
+        const uint64_t* before = grid.row(line - 1);
+        const uint64_t* after = grid.row(line + 1);
+        int words = grid.words_per_row();
+        int w = start >> 6;
+
+        if (direction == 1)
+        {
+            uint64_t mask = ~0ULL << (start & 63);
+            while (true)
+            {
+                // The cell one step behind each cell is the previous bit.
+                uint64_t before_carry = w ? before[w - 1] >> 63 : 0;
+                uint64_t after_carry = w ? after[w - 1] >> 63 : 0;
+                uint64_t stops = ~current[w] |
+                                 (before[w] & ~(before[w] << 1 | before_carry)) |
+                                 (after[w] & ~(after[w] << 1 | after_carry));
+                stops &= mask;
+                if (stops) return w * 64 + __builtin_ctzll(stops);
+                mask = ~0ULL;
+                w++;
+            }
+        }
+
+        uint64_t mask = ~0ULL >> (63 - (start & 63));
+        while (true)
+        {
+            // The cell one step behind each cell is the next bit.
+            uint64_t before_carry = w + 1 < words ? before[w + 1] << 63 : 0;
+            uint64_t after_carry = w + 1 < words ? after[w + 1] << 63 : 0;
+            uint64_t stops = ~current[w] |
+                             (before[w] & ~(before[w] >> 1 | before_carry)) |
+                             (after[w] & ~(after[w] >> 1 | after_carry));
+            stops &= mask;
+            if (stops) return w * 64 + 63 - __builtin_clzll(stops);
+            mask = ~0ULL;
+            w--;
+        }
+    }
+
+    // The jump point of a straight move that starts at (x, y), -1 if there's none.
+    int jump_straight(int x, int y, int dx, int dy)
+    {
+        if (dy == 0)
+        {
+            int stop = scan(map.get_rows(), y, x, dx);
+            if (y == target_y && (target_x - x) * dx >= 0 && (stop - target_x) * dx >= 0) return target;
+            return is_free(stop, y) ? id(stop, y) : -1;
+        }
+
+        int stop = scan(map.get_columns(), x, y, dy);
+        if (x == target_x && (target_y - y) * dy >= 0 && (stop - target_y) * dy >= 0) return target;
+        return is_free(x, stop) ? id(x, stop) : -1;
+    }
+
+    // The jump point of a diagonal move that starts at (x, y), -1 if there's none.
+    // The caller already checked that the move into (x, y) doesn't cut a corner.
+    int jump_diagonal(int x, int y, int dx, int dy)
+    {
+        while (is_free(x, y))
+        {
+            if (x == target_x && y == target_y) return target;
+            if (jump_straight(x + dx, y, dx, 0) != -1 || jump_straight(x, y + dy, 0, dy) != -1) return id(x, y);
+            if (!is_free(x + dx, y) || !is_free(x, y + dy)) return -1;
+            x += dx;
+            y += dy;
+        }
+        return -1;
+    }
+
+    void add_successor(int node, int x, int y, int dx, int dy)
+    {
+        int distance = nodes[node].distance;
+
+        if (!use_jump_points) {
+            relax(x + dx, y + dy, node, distance + (dx && dy ? DIAGONAL_COST : STRAIGHT_COST));
+            return;
+        }
+
+        int jump_point = (dx && dy) ? jump_diagonal(x + dx, y + dy, dx, dy) : jump_straight(x + dx, y + dy, dx, dy);
+        if (jump_point == -1) return;
+
+        int jx = jump_point % stride;
+        int jy = jump_point / stride;
+        int steps = std::max(std::abs(jx - x), std::abs(jy - y));
+        relax(jx, jy, node, distance + steps * (dx && dy ? DIAGONAL_COST : STRAIGHT_COST));
+    }
+
+    void add_successors(int node)
+    {
+        int x = node % stride;
+        int y = node / stride;
+
+        bool has_direction = use_jump_points && nodes[node].parent != -1;
+        int dx = 0, dy = 0;
+        if (has_direction) {
+            int parent = nodes[node].parent;
+            dx = (x > parent % stride) - (x < parent % stride);
+            dy = (y > parent / stride) - (y < parent / stride);
+        }
+
+        if (!has_direction)
+        {
+            // All the 8 directions.
+            for (int i = -1; i <= 1; i++) {
+                for (int j = -1; j <= 1; j++) {
+                    if (i == 0 && j == 0) continue;
+                    if (!is_free(x + i, y + j)) continue;
+                    if (i && j && (!is_free(x + i, y) || !is_free(x, y + j))) continue;
+                    add_successor(node, x, y, i, j);
+                }
+            }
+        }
+        else if (dx && dy)
+        {
+            bool horizontal = is_free(x + dx, y);
+            bool vertical = is_free(x, y + dy);
+            if (horizontal) add_successor(node, x, y, dx, 0);
+            if (vertical) add_successor(node, x, y, 0, dy);
+            if (horizontal && vertical) add_successor(node, x, y, dx, dy);
+        }
+        else
+        {
+            // The same for both straight directions: (along_x, along_y) is the
+            // direction of the move, and (side_x, side_y) is perpendicular to it.
+            int side_x = dy, side_y = dx;
+            bool ahead = is_free(x + dx, y + dy);
+            for (int side : {-1, 1}) {
+                if (!is_free(x + side * side_x, y + side * side_y)) continue;
+                add_successor(node, x, y, side * side_x, side * side_y);
+                if (ahead) add_successor(node, x, y, dx + side * side_x, dy + side * side_y);
+            }
+            if (ahead) add_successor(node, x, y, dx, dy);
+        }
+    }
+
+public:
+
+    GridAStar(const GridMap& map, bool use_jump_points = true)
+        : map(map), use_jump_points(use_jump_points), stride(map.get_width() + 2),
+          nodes((size_t)stride * (map.get_height() + 2), {MAX_VALUE, -1, -2, 0}) {}
+
+    // Returns the cost of the shortest path, or MAX_VALUE if there's none.
+    int solve(Coord source, Coord target_coord)
+    {
+        query++;
+        heap.clear();
+
+        target_x = target_coord.x + 1;
+        target_y = target_coord.y + 1;
+        target = id(target_x, target_y);
+        if (!is_free(source.x + 1, source.y + 1) || !is_free(target_x, target_y)) return MAX_VALUE;
+
+        relax(source.x + 1, source.y + 1, -1, 0);
+        while (!heap.empty())
+        {
+            int node = pop();
+            expanded++;
+            if (node == target) return nodes[node].distance;
+            add_successors(node);
+        }
+
+        return MAX_VALUE;
+    }
+
+    // The cells of the path found by the last call to solve, including the source and the target.
+    std::vector<Coord> get_path() const
+    {
+        std::vector<Coord> path;
+        if (nodes[target].query != query || nodes[target].heap_position != CLOSED) return path;
+
+        // The consecutive jump points are on a straight line or a diagonal.
+        for (int node = target; node != -1; node = nodes[node].parent)
+        {
+            int x = node % stride, y = node / stride;
+            int parent = nodes[node].parent;
+            if (parent == -1) {
+                path.push_back({x - 1, y - 1});
+                break;
+            }
+            int px = parent % stride, py = parent / stride;
+            int dx = (px > x) - (px < x), dy = (py > y) - (py < y);
+            for (; x != px || y != py; x += dx, y += dy) path.push_back({x - 1, y - 1});
+        }
+
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // The number of nodes taken out of the open list, over all the queries.
+    long long get_expanded() const { return expanded; }
+};
+
+struct Edge
+{
+    int to;
+    int weight;
+};
+
+typedef std::vector<std::vector<Edge>> Graph;
+
+struct NodeInfo
+{
+    Coord coord;
+};
+
+struct ShortestPathsInfo
+{
+    std::vector<int> shortest_distances;
+    std::vector<int> parent_of;
+
+    ShortestPathsInfo(int n) {
+        shortest_distances.resize(n, MAX_VALUE);
+        parent_of.resize(n, -1);
+    }
+};
+
+struct QueueFrame
+{
+    int node;
+    int parent;
+    int weight;
+    int additional_weight;
+
+    int total_weight() const {
+        return weight + additional_weight;
+    }
+
+    bool operator>(const QueueFrame &other) const {
+        return total_weight() > other.total_weight();
+    }
+};
+
+int euclidean_distance(const Coord &a, const Coord &b)
+{
+    int x_diff = a.x - b.x;
+    int y_diff = a.y - b.y;
+
+    return ceil(sqrt(x_diff * x_diff + y_diff * y_diff));
+}
+
+// A copy of the one in "A-Star.cpp", used only to compare against. The heuristic
+// is taken towards the target, and it stops once the target is taken, which is
+// how A* is meant to run. The coordinates are scaled by STRAIGHT_COST, so the
+// Euclidean distance never overestimates. expanded counts the nodes taken.
+ShortestPathsInfo A_Star(const Graph &graph, const std::vector<NodeInfo> &info, int source, int target, long long& expanded)
+{
+    ShortestPathsInfo result(graph.size());
+    auto &shortest_distances = result.shortest_distances;
+    auto &parent_of = result.parent_of;
+
+    std::priority_queue<QueueFrame, std::vector<QueueFrame>, std::greater<QueueFrame>> queue;
+
+    queue.push({.node=source, .parent=-1, .weight=0, .additional_weight=0});
+
+    while (!queue.empty())
+    {
+        auto closest = queue.top();
+        queue.pop();
+
+        int node = closest.node;
+
+        if (closest.weight >= shortest_distances[node]) {
+            continue;
+        }
+
+        shortest_distances[node] = closest.weight;
+        parent_of[node] = closest.parent;
+        expanded++;
+
+        if (node == target) {
+            break;
+        }
+
+        for (auto& edge : graph[node]) {
+
+            int additional_heuristics = euclidean_distance(info[edge.to].coord, info[target].coord);
+
+            if (closest.weight + edge.weight < shortest_distances[edge.to]) {
+                queue.push({
+                    .node = edge.to,
+                    .parent = node,
+                    .weight = closest.weight + edge.weight,
+                    .additional_weight = additional_heuristics
+                });
+            }
+        }
+    }
+
+    return result;
+}
+
+// The same grid as a general graph, with the same moves.
+std::pair<Graph, std::vector<NodeInfo>> get_graph(const GridMap& map)
+{
+    int width = map.get_width(), height = map.get_height();
+    Graph graph(width * height);
+    std::vector<NodeInfo> info(width * height);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            info[y * width + x].coord = {x * STRAIGHT_COST, y * STRAIGHT_COST};
+            if (!map.is_free(x, y)) continue;
+            for (int i = -1; i <= 1; i++) {
+                for (int j = -1; j <= 1; j++) {
+                    int nx = x + i, ny = y + j;
+                    if ((i == 0 && j == 0) || nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+                    if (!map.is_free(nx, ny)) continue;
+                    if (i && j && (!map.is_free(nx, y) || !map.is_free(x, ny))) continue;
+                    graph[y * width + x].push_back({ny * width + nx, i && j ? DIAGONAL_COST : STRAIGHT_COST});
+                }
+            }
+        }
+    }
+
+    return {graph, info};
+}
+
+// Random rectangles of walls, then random single blocked cells.
+GridMap get_random_map(int width, int height, int rectangles, double noise, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<char> blocked(width * height, 0);
+
+    for (int i = 0; i < rectangles; i++) {
+        int w = 1 + random() % (width / 8 + 1), h = 1 + random() % (height / 8 + 1);
+        int x = random() % width, y = random() % height;
+        for (int j = y; j < std::min(height, y + h); j++) {
+            for (int k = x; k < std::min(width, x + w); k++) {
+                blocked[j * width + k] = 1;
+            }
+        }
+    }
+
+    std::uniform_real_distribution<double> distribution(0, 1);
+    for (auto& cell : blocked) {
+        if (distribution(random) < noise) cell = 1;
+    }
+
+    GridMap map(width, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            map.set_free(x, y, !blocked[y * width + x]);
+        }
+    }
+    return map;
+}
+
+std::vector<std::pair<Coord, Coord>> get_random_queries(const GridMap& map, int count, unsigned seed)
+{
+    std::mt19937 random(seed);
+    auto random_free = [&]() {
+        while (true) {
+            Coord coord = {(int)(random() % map.get_width()), (int)(random() % map.get_height())};
+            if (map.is_free(coord.x, coord.y)) return coord;
+        }
+    };
+
+    std::vector<std::pair<Coord, Coord>> queries(count);
+    for (auto& query : queries) query = {random_free(), random_free()};
+    return queries;
+}
+
+bool is_valid_path(const GridMap& map, const std::vector<Coord>& path, Coord source, Coord target, int distance)
+{
+    if (path.empty() || path.front().x != source.x || path.front().y != source.y ||
+        path.back().x != target.x || path.back().y != target.y) return false;
+
+    int cost = 0;
+    for (int i = 0; i < (int)path.size(); i++) {
+        if (!map.is_free(path[i].x, path[i].y)) return false;
+        if (i == 0) continue;
+        int dx = path[i].x - path[i - 1].x, dy = path[i].y - path[i - 1].y;
+        if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0)) return false;
+        if (dx && dy && (!map.is_free(path[i - 1].x + dx, path[i - 1].y) || !map.is_free(path[i - 1].x, path[i - 1].y + dy))) return false;
+        cost += (dx && dy) ? DIAGONAL_COST : STRAIGHT_COST;
+    }
+    return cost == distance;
+}
+
+void print_map(const GridMap& map, const std::vector<Coord>& path)
+{
+    std::vector<std::string> lines(map.get_height(), std::string(map.get_width(), '.'));
+    for (int y = 0; y < map.get_height(); y++) {
+        for (int x = 0; x < map.get_width(); x++) {
+            if (!map.is_free(x, y)) lines[y][x] = '#';
+        }
+    }
+    for (auto& coord : path) lines[coord.y][coord.x] = '*';
+    for (auto& line : lines) std::cout << line << std::endl;
+}
+
+void test()
+{
+    std::vector<std::string> rows = {
+        "..........",
+        "....#.....",
+        "....#.....",
+        "....#.###.",
+        "....#...#.",
+        "........#.",
+    };
+
+    GridMap map(rows[0].size(), rows.size());
+    for (int y = 0; y < (int)rows.size(); y++) {
+        for (int x = 0; x < (int)rows[y].size(); x++) {
+            map.set_free(x, y, rows[y][x] == '.');
+        }
+    }
+
+    GridAStar search(map);
+    std::cout << "Distance: " << search.solve({0, 2}, {9, 5}) << std::endl;
+    print_map(map, search.get_path());
+    std::cout << std::endl;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(17);
+    for (int t = 0; t < tests; t++)
+    {
+        int width = 1 + random() % 150, height = 1 + random() % 150;
+        auto map = get_random_map(width, height, random() % 30, (random() % 40) / 100.0, t);
+        auto graph = get_graph(map);
+
+        GridAStar plain(map, false);
+        GridAStar jump(map, true);
+
+        for (auto& query : get_random_queries(map, 20, t))
+        {
+            int source = query.first.y * width + query.first.x;
+            int target = query.second.y * width + query.second.x;
+
+            long long expanded = 0;
+            int expected = A_Star(graph.first, graph.second, source, target, expanded).shortest_distances[target];
+
+            int plain_distance = plain.solve(query.first, query.second);
+            int jump_distance = jump.solve(query.first, query.second);
+            if (plain_distance != expected || jump_distance != expected) {
+                std::cout << "Wrong distance!" << std::endl;
+                continue;
+            }
+
+            if (expected != MAX_VALUE) {
+                if (!is_valid_path(map, plain.get_path(), query.first, query.second, expected) ||
+                    !is_valid_path(map, jump.get_path(), query.first, query.second, expected))
+                    std::cout << "Wrong path!" << std::endl;
+            }
+        }
+    }
+}
+
+// A single corridor that goes back and forth over the rows of the map, so the
+// path between its two ends goes through all the free cells, and costs more
+// than the number of cells in the map.
+void corridor_test(int size)
+{
+    GridMap map(size, size);
+    int free_cells = 0;
+    for (int y = 0; y < size; y += 2) {
+        for (int x = 0; x < size; x++) map.set_free(x, y, true);
+        free_cells += size;
+        if (y + 1 < size) {
+            map.set_free((y / 2) % 2 ? 0 : size - 1, y + 1, true);
+            free_cells++;
+        }
+    }
+
+    Coord source = {0, 0};
+    int last_row = (size - 1) / 2 * 2;
+    Coord target = {(last_row / 2) % 2 ? 0 : size - 1, last_row};
+    if (last_row + 1 < size) target = {(last_row / 2) % 2 ? 0 : size - 1, last_row + 1};
+    int expected = (free_cells - 1) * STRAIGHT_COST;
+
+    for (bool use_jump_points : {false, true})
+    {
+        GridAStar search(map, use_jump_points);
+        int distance = search.solve(source, target);
+        if (distance != expected || !is_valid_path(map, search.get_path(), source, target, expected))
+            std::cout << "Wrong corridor distance!" << std::endl;
+    }
+}
+
+void time_test(int size, int rectangles, double noise, int queries_count, bool run_general)
+{
+    auto map = get_random_map(size, size, rectangles, noise, size);
+    auto queries = get_random_queries(map, queries_count, size);
+    std::cout << size << "x" << size << ", " << rectangles << " rectangles, " << noise * 100
+              << "% noise, " << queries_count << " queries" << std::endl;
+
+    std::vector<int> distances;
+    for (bool use_jump_points : {false, true})
+    {
+        GridAStar search(map, use_jump_points);
+        std::vector<int> results;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto& query : queries) results.push_back(search.solve(query.first, query.second));
+        auto end = std::chrono::high_resolution_clock::now();
+
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << (use_jump_points ? "Jump point search: " : "Grid A*: ") << (double)us / queries_count << " us, "
+                  << (double)search.get_expanded() / queries_count << " nodes expanded per query" << std::endl;
+
+        if (distances.empty()) distances = results;
+        else if (distances != results) std::cout << "Wrong distance!" << std::endl;
+    }
+
+    if (run_general)
+    {
+        auto graph = get_graph(map);
+        long long expanded = 0;
+        std::vector<int> results;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto& query : queries) {
+            int source = query.first.y * size + query.first.x;
+            int target = query.second.y * size + query.second.x;
+            results.push_back(A_Star(graph.first, graph.second, source, target, expanded).shortest_distances[target]);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << "General A*: " << (double)us / queries_count << " us, "
+                  << (double)expanded / queries_count << " nodes expanded per query" << std::endl;
+
+        if (distances != results) std::cout << "Wrong distance!" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test();
+    random_test(300);
+    corridor_test(1024);
+    corridor_test(4095);
+
+    time_test(1024, 100, 0.0, 100, true);
+    time_test(1024, 100, 0.2, 100, true);
+    // The general version would need a few GBs for the graph here.
+    time_test(4096, 400, 0.0, 100, false);
+    time_test(4096, 400, 0.2, 100, false);
+}
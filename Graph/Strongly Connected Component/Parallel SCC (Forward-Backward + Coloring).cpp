@@ -0,0 +1,530 @@
+#include <iostream>
+#include <functional>
+#include <vector>
+#include <stack>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+const int UNVISITED = -1;
+const int UNASSIGNED = -1;
+typedef std::vector<std::vector<int>> Graph;
+
+struct FlatGraph
+{
+    // The neighbours of the node x are targets[offsets[x]..offsets[x + 1]).
+    // The offsets are unsigned 32 bits, which allows for up to 2^32 - 1 edges.
+
+    int n;
+    std::vector<uint32_t> offsets;
+    std::vector<int> targets;
+
+    FlatGraph(int n, const std::vector<std::pair<int, int>>& edges, bool transpose = false)
+        : n(n), offsets(n + 1, 0), targets(edges.size())
+    {
+        for (auto& edge : edges) offsets[(transpose ? edge.second : edge.first) + 1]++;
+        for (int i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+
+        std::vector<uint32_t> position(offsets.begin(), offsets.end() - 1);
+        for (auto& edge : edges) {
+            if (transpose) targets[position[edge.second]++] = edge.first;
+            else targets[position[edge.first]++] = edge.second;
+        }
+    }
+
+    int degree(int x) const {
+        return offsets[x + 1] - offsets[x];
+    }
+};
+
+template <typename Function>
+void parallel_for(int threads_count, size_t count, Function function)
+{
+    // Splits [0, count) into contiguous chunks, and calls
+    // function(thread_index, begin, end) for each chunk.
+    if (threads_count == 1 || count < 1024) {
+        function(0, (size_t)0, count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    size_t chunk = (count + threads_count - 1) / threads_count;
+    for (int t = 0; t < threads_count; t++) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        threads.emplace_back(function, t, begin, end);
+    }
+    for (auto& thread : threads) thread.join();
+}
+
+class ParallelSCCCalculator
+{
+    // The "Multistep" approach (Slota, Rajamanickam and Madduri):
+    //  1. Trimming: a node with no incoming or no outgoing edges (among the
+    //     nodes that are still unassigned) is a component on its own. This is
+    //     repeated a few times, since removing nodes exposes more such nodes.
+    //  2. Forward-backward: real graphs usually have one giant component. Pick
+    //     a pivot likely to be in it (max in-degree * out-degree), and find the
+    //     nodes reachable from it (forward) and the nodes that reach it
+    //     (backward) using parallel BFS. The intersection is the component of
+    //     the pivot.
+    //  3. Coloring: each remaining node starts with its own index as a color,
+    //     and the max color is propagated forward along the edges until nothing
+    //     changes. Each node whose color is its own index (a root) belongs to a
+    //     different component, which consists of the nodes of its color that
+    //     can reach it. These are found with a backward BFS restricted to that
+    //     color. The backward searches of different roots are independent, so
+    //     they're split across the threads. This is repeated until all the
+    //     nodes are assigned.
+    //
+    // The algorithm finds the components in no particular order. To be usable
+    // in place of get_SCCs (as in the 2-SAT solver, which relies on the order),
+    // the components are finally renumbered in a reverse topological order of
+    // the condensation graph, which is done sequentially in O(V + E).
+
+    const FlatGraph& graph;
+    const FlatGraph& transpose;
+    int threads_count;
+
+    std::vector<std::atomic<int>> component_of;
+    std::atomic<int> components_count;
+
+    std::vector<std::atomic<int>> color;
+    std::vector<std::atomic<uint8_t>> mark;
+    std::vector<std::vector<int>> thread_buffers;
+
+    bool is_unassigned(int x) const {
+        return component_of[x].load(std::memory_order_relaxed) == UNASSIGNED;
+    }
+
+    // Collects the nodes in [0, n) satisfying the predicate, in parallel.
+    template <typename Predicate>
+    std::vector<int> collect(Predicate predicate)
+    {
+        parallel_for(threads_count, graph.n, [&](int thread, size_t begin, size_t end) {
+            thread_buffers[thread].clear();
+            for (size_t x = begin; x < end; x++) {
+                if (predicate(x)) thread_buffers[thread].push_back(x);
+            }
+        });
+        return merge_buffers();
+    }
+
+    std::vector<int> merge_buffers()
+    {
+        std::vector<int> result;
+        for (auto& buffer : thread_buffers) {
+            result.insert(result.end(), buffer.begin(), buffer.end());
+            buffer.clear();
+        }
+        return result;
+    }
+
+    bool has_unassigned_neighbour(const FlatGraph& g, int x) const
+    {
+        for (uint32_t i = g.offsets[x]; i < g.offsets[x + 1]; i++) {
+            int neighbour = g.targets[i];
+            if (neighbour != x && is_unassigned(neighbour)) return true;
+        }
+        return false;
+    }
+
+    void trim()
+    {
+        std::vector<int> nodes = collect([&](int x) { return is_unassigned(x); });
+
+        for (int round = 0; round < 3 && !nodes.empty(); round++)
+        {
+            // Decided against the unassigned nodes of the previous round, and
+            // assigned afterwards, so that all threads see the same state.
+            parallel_for(threads_count, nodes.size(), [&](int thread, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    int x = nodes[i];
+                    if (!has_unassigned_neighbour(graph, x) || !has_unassigned_neighbour(transpose, x)) {
+                        thread_buffers[thread].push_back(x);
+                    }
+                }
+            });
+
+            std::vector<int> trimmed = merge_buffers();
+            if (trimmed.empty()) break;
+
+            int first = components_count.fetch_add(trimmed.size());
+            parallel_for(threads_count, trimmed.size(), [&](int, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) component_of[trimmed[i]].store(first + i, std::memory_order_relaxed);
+            });
+
+            nodes = collect([&](int x) { return is_unassigned(x); });
+        }
+    }
+
+    // Sets the given bit in the mark of every unassigned node reachable from the
+    // source (or reaching it, using the transpose), using a level synchronous BFS.
+    void parallel_bfs(const FlatGraph& g, int source, uint8_t bit)
+    {
+        std::vector<int> frontier = {source};
+        mark[source].fetch_or(bit);
+
+        while (!frontier.empty())
+        {
+            parallel_for(threads_count, frontier.size(), [&](int thread, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    int x = frontier[i];
+                    for (uint32_t j = g.offsets[x]; j < g.offsets[x + 1]; j++) {
+                        int neighbour = g.targets[j];
+                        if (!is_unassigned(neighbour)) continue;
+                        if (mark[neighbour].load(std::memory_order_relaxed) & bit) continue;
+                        if (!(mark[neighbour].fetch_or(bit) & bit)) {
+                            thread_buffers[thread].push_back(neighbour);
+                        }
+                    }
+                }
+            });
+            frontier = merge_buffers();
+        }
+    }
+
+    void forward_backward()
+    {
+        int pivot = -1;
+        long long best = -1;
+        for (int x = 0; x < graph.n; x++) {
+            if (!is_unassigned(x)) continue;
+            long long score = (long long)graph.degree(x) * transpose.degree(x);
+            if (score > best) {
+                best = score;
+                pivot = x;
+            }
+        }
+        if (pivot == -1) return;
+
+        parallel_for(threads_count, graph.n, [&](int, size_t begin, size_t end) {
+            for (size_t x = begin; x < end; x++) mark[x].store(0, std::memory_order_relaxed);
+        });
+
+        parallel_bfs(graph, pivot, 1);
+        parallel_bfs(transpose, pivot, 2);
+
+        int component = components_count++;
+        parallel_for(threads_count, graph.n, [&](int, size_t begin, size_t end) {
+            for (size_t x = begin; x < end; x++) {
+                if (mark[x].load(std::memory_order_relaxed) == 3) {
+                    component_of[x].store(component, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    void propagate_colors(std::vector<int> active)
+    {
+        while (!active.empty())
+        {
+            parallel_for(threads_count, active.size(), [&](int thread, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    int x = active[i];
+                    mark[x].store(0, std::memory_order_relaxed);
+                    int c = color[x].load(std::memory_order_relaxed);
+                    for (uint32_t j = graph.offsets[x]; j < graph.offsets[x + 1]; j++) {
+                        int neighbour = graph.targets[j];
+                        if (!is_unassigned(neighbour)) continue;
+                        int current = color[neighbour].load(std::memory_order_relaxed);
+                        while (c > current) {
+                            if (color[neighbour].compare_exchange_weak(current, c, std::memory_order_relaxed)) {
+                                // Add it to the next round only once.
+                                if (mark[neighbour].exchange(1) == 0) {
+                                    thread_buffers[thread].push_back(neighbour);
+                                }
+                                break;
+                            }
+                        }
+                    }
+                }
+            });
+            active = merge_buffers();
+        }
+    }
+
+    void collect_root_components(const std::vector<int>& roots)
+    {
+        std::vector<int> first_component(roots.size());
+        int first = components_count.fetch_add(roots.size());
+
+        parallel_for(threads_count, roots.size(), [&](int, size_t begin, size_t end) {
+            std::vector<int> queue;
+            for (size_t i = begin; i < end; i++) {
+                int root = roots[i];
+                int component = first + i;
+
+                queue.clear();
+                queue.push_back(root);
+                component_of[root].store(component, std::memory_order_relaxed);
+
+                for (size_t head = 0; head < queue.size(); head++) {
+                    int x = queue[head];
+                    for (uint32_t j = transpose.offsets[x]; j < transpose.offsets[x + 1]; j++) {
+                        int neighbour = transpose.targets[j];
+                        // Only this thread works on this color, so there is no contention here.
+                        if (color[neighbour].load(std::memory_order_relaxed) != root) continue;
+                        if (!is_unassigned(neighbour)) continue;
+                        component_of[neighbour].store(component, std::memory_order_relaxed);
+                        queue.push_back(neighbour);
+                    }
+                }
+            }
+        });
+    }
+
+    void coloring()
+    {
+        while (true)
+        {
+            std::vector<int> remaining = collect([&](int x) { return is_unassigned(x); });
+            if (remaining.empty()) break;
+
+            parallel_for(threads_count, remaining.size(), [&](int, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    color[remaining[i]].store(remaining[i], std::memory_order_relaxed);
+                    mark[remaining[i]].store(0, std::memory_order_relaxed);
+                }
+            });
+
+            propagate_colors(remaining);
+
+            std::vector<int> roots;
+            for (int x : remaining) {
+                if (color[x].load(std::memory_order_relaxed) == x) roots.push_back(x);
+            }
+
+            collect_root_components(roots);
+        }
+    }
+
+    std::vector<int> renumber_in_reverse_topological_order()
+    {
+        int count = components_count;
+        std::vector<int> result(graph.n);
+        for (int x = 0; x < graph.n; x++) result[x] = component_of[x].load(std::memory_order_relaxed);
+
+        // Kahn's algorithm over the condensation graph.
+        std::vector<int> in_degree(count, 0);
+        for (int x = 0; x < graph.n; x++) {
+            for (uint32_t j = graph.offsets[x]; j < graph.offsets[x + 1]; j++) {
+                if (result[x] != result[graph.targets[j]]) in_degree[result[graph.targets[j]]]++;
+            }
+        }
+
+        std::vector<std::vector<int>> members(count);
+        for (int x = 0; x < graph.n; x++) members[result[x]].push_back(x);
+
+        std::vector<int> queue;
+        for (int c = 0; c < count; c++) {
+            if (in_degree[c] == 0) queue.push_back(c);
+        }
+
+        std::vector<int> new_number(count);
+        for (size_t head = 0; head < queue.size(); head++) {
+            int c = queue[head];
+            // The sources of the condensation get the largest numbers.
+            new_number[c] = count - 1 - head;
+            for (int x : members[c]) {
+                for (uint32_t j = graph.offsets[x]; j < graph.offsets[x + 1]; j++) {
+                    int d = result[graph.targets[j]];
+                    if (d != c && --in_degree[d] == 0) queue.push_back(d);
+                }
+            }
+        }
+
+        for (int x = 0; x < graph.n; x++) result[x] = new_number[result[x]];
+        return result;
+    }
+
+public:
+
+    ParallelSCCCalculator(const FlatGraph& graph, const FlatGraph& transpose, int threads_count)
+        : graph(graph), transpose(transpose), threads_count(threads_count),
+          component_of(graph.n), components_count(0), color(graph.n), mark(graph.n),
+          thread_buffers(threads_count) {}
+
+    // Same output as get_SCCs in "2-Satisfiability.cpp": the component
+    // of each node, numbered in a reverse topological order.
+    std::vector<int> solve()
+    {
+        for (int x = 0; x < graph.n; x++) component_of[x].store(UNASSIGNED, std::memory_order_relaxed);
+        components_count = 0;
+
+        trim();
+        forward_backward();
+        trim();
+        coloring();
+
+        return renumber_in_reverse_topological_order();
+    }
+
+    int get_components_count() const {
+        return components_count;
+    }
+};
+
+// A copy of the recursive version in "2-Satisfiability.cpp", used only to compare against.
+std::vector<int> get_SCCs(const Graph& graph)
+{
+    int n = graph.size();
+
+    std::vector<int> result(n);
+
+    int last_id = 0;
+    int last_component_number = 0;
+    std::vector<int> id(n, UNVISITED);
+    std::vector<int> low_link(n);
+    std::vector<bool> on_stack(n, false);
+    std::stack<int> stack;
+
+    std::function<void(int)> dfs = [&](int x)
+    {
+        id[x] = low_link[x] = last_id++;
+        stack.push(x);
+        on_stack[x] = true;
+
+        for (int neighbour : graph[x])
+        {
+            if (id[neighbour] == UNVISITED) {
+                dfs(neighbour);
+                low_link[x] = std::min(low_link[x], low_link[neighbour]);
+            } else if (on_stack[neighbour]) {
+                low_link[x] = std::min(low_link[x], low_link[neighbour]);
+            }
+        }
+
+        if (low_link[x] == id[x]) {
+            while (stack.top() != x) {
+                int node = stack.top();
+                stack.pop();
+                on_stack[node] = false;
+                result[node] = last_component_number;
+            }
+            stack.pop();
+            on_stack[x] = false;
+            result[x] = last_component_number;
+            last_component_number++;
+        }
+    };
+
+    for (int i = 0; i < n; i++) {
+        if (id[i] == UNVISITED) {
+            dfs(i);
+        }
+    }
+
+    return result;
+}
+
+// Checks that both assign the nodes to the same components,
+// and that every edge goes to a component with a smaller number.
+bool is_compatible(const std::vector<std::pair<int, int>>& edges,
+                   const std::vector<int>& expected, const std::vector<int>& result)
+{
+    int n = expected.size();
+    std::vector<int> mapping(n, -1);
+    std::vector<int> reverse_mapping(n, -1);
+    for (int x = 0; x < n; x++) {
+        int& a = mapping[expected[x]];
+        int& b = reverse_mapping[result[x]];
+        if (a == -1) a = result[x];
+        if (b == -1) b = expected[x];
+        if (a != result[x] || b != expected[x]) return false;
+    }
+
+    for (auto& edge : edges) {
+        if (result[edge.first] < result[edge.second]) return false;
+    }
+
+    return true;
+}
+
+std::vector<std::pair<int, int>> get_random_edges(int n, long long m, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<std::pair<int, int>> edges(m);
+    for (auto& edge : edges) edge = {(int)(random() % n), (int)(random() % n)};
+    return edges;
+}
+
+// The implication graph of a random 2-SAT instance with
+// the given number of variables and (a or b) clauses.
+std::vector<std::pair<int, int>> get_random_implication_graph(int variables, long long clauses, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<std::pair<int, int>> edges;
+    for (long long i = 0; i < clauses; i++) {
+        int p = random() % (2 * variables);
+        int q = random() % (2 * variables);
+        edges.push_back({p ^ 1, q});
+        edges.push_back({q ^ 1, p});
+    }
+    return edges;
+}
+
+Graph to_graph(int n, const std::vector<std::pair<int, int>>& edges)
+{
+    Graph graph(n);
+    for (auto& edge : edges) graph[edge.first].push_back(edge.second);
+    return graph;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(11);
+    for (int i = 0; i < tests; i++)
+    {
+        int n = 1 + random() % 3000;
+        auto edges = get_random_edges(n, random() % (3 * n), i);
+        FlatGraph graph(n, edges), transpose(n, edges, true);
+
+        auto expected = get_SCCs(to_graph(n, edges));
+        for (int threads : {1, 4}) {
+            if (!is_compatible(edges, expected, ParallelSCCCalculator(graph, transpose, threads).solve()))
+                std::cout << "Wrong components!" << std::endl;
+        }
+    }
+}
+
+void time_test(const std::string& name, int n, const std::vector<std::pair<int, int>>& edges)
+{
+    FlatGraph graph(n, edges), transpose(n, edges, true);
+    std::cout << name << " (V = " << n << ", E = " << edges.size() << ")" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto expected = get_SCCs(to_graph(n, edges));
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Recursive Tarjan: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+
+    for (int threads = 1; threads <= 32; threads *= 2)
+    {
+        ParallelSCCCalculator calculator(graph, transpose, threads);
+
+        start = std::chrono::high_resolution_clock::now();
+        auto result = calculator.solve();
+        end = std::chrono::high_resolution_clock::now();
+
+        std::cout << threads << " threads: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+                  << " ms (" << calculator.get_components_count() << " components)" << std::endl;
+
+        if (!is_compatible(edges, expected, result))
+            std::cout << "Wrong components!" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    random_test(100);
+
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl << std::endl;
+
+    time_test("Random", 100'000, get_random_edges(100'000, 400'000, 1));
+    time_test("2-SAT implication graph", 200'000, get_random_implication_graph(100'000, 100'000, 1));
+}
@@ -0,0 +1,332 @@
+#include <iostream>
+#include <functional>
+#include <vector>
+#include <stack>
+#include <chrono>
+#include <random>
+#include <cstdint>
+
+const int UNVISITED = -1;
+typedef std::vector<std::vector<int>> Graph;
+
+struct FlatGraph
+{
+    // The neighbours of the node x are targets[offsets[x]..offsets[x + 1]).
+    // The offsets are unsigned 32 bits, which allows for up to 2^32 - 1 edges.
+
+    int n;
+    std::vector<uint32_t> offsets;
+    std::vector<int> targets;
+
+    FlatGraph(int n, const std::vector<std::pair<int, int>>& edges) : n(n), offsets(n + 1, 0), targets(edges.size())
+    {
+        for (auto& edge : edges) offsets[edge.first + 1]++;
+        for (int i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+
+        std::vector<uint32_t> position(offsets.begin(), offsets.end() - 1);
+        for (auto& edge : edges) targets[position[edge.first]++] = edge.second;
+    }
+
+    explicit FlatGraph(const Graph& graph) : n(graph.size()), offsets(graph.size() + 1, 0)
+    {
+        for (int i = 0; i < n; i++) {
+            offsets[i + 1] = offsets[i] + graph[i].size();
+            targets.insert(targets.end(), graph[i].begin(), graph[i].end());
+        }
+    }
+};
+
+class SCCCalculator
+{
+    // Tarjan's algorithm without recursion. The recursion is replaced by an
+    // explicit call stack of nodes, and next_edge[x] remembers where the loop
+    // over the neighbours of x stopped when it "called" a child, so it can
+    // continue from there when the child returns. This way, the depth of the
+    // DFS is only limited by memory, which matters for long chains.
+    //
+    // All the arrays are allocated once, and on_stack is a bitset. Other than
+    // the graph, it uses 4 ints per node (id, low_link, next_edge and
+    // component_of) and at most 2 more on the stacks, so 10^8 nodes need
+    // about 2.4 GB on top of the graph.
+
+    const FlatGraph& graph;
+
+    std::vector<int> id;
+    std::vector<int> low_link;
+    std::vector<uint32_t> next_edge;
+    std::vector<uint64_t> on_stack;
+    std::vector<int> component_of;
+
+    std::vector<int> call_stack;
+    std::vector<int> component_stack;
+
+    int last_id;
+    int components_count;
+
+    bool is_on_stack(int x) const { return (on_stack[x >> 6] >> (x & 63)) & 1; }
+    void set_on_stack(int x) { on_stack[x >> 6] |= (uint64_t)1 << (x & 63); }
+    void clear_on_stack(int x) { on_stack[x >> 6] &= ~((uint64_t)1 << (x & 63)); }
+
+    void visit(int x)
+    {
+        id[x] = low_link[x] = last_id++;
+        next_edge[x] = graph.offsets[x];
+        call_stack.push_back(x);
+        component_stack.push_back(x);
+        set_on_stack(x);
+    }
+
+    void dfs(int root)
+    {
+        visit(root);
+
+        while (!call_stack.empty())
+        {
+            int x = call_stack.back();
+
+            if (next_edge[x] < graph.offsets[x + 1]) {
+                int neighbour = graph.targets[next_edge[x]++];
+                if (id[neighbour] == UNVISITED) {
+                    visit(neighbour);
+                } else if (is_on_stack(neighbour)) {
+                    low_link[x] = std::min(low_link[x], id[neighbour]);
+                }
+                continue;
+            }
+
+            // All the neighbours are done, return from x.
+            call_stack.pop_back();
+
+            if (low_link[x] == id[x]) {
+                int node;
+                do {
+                    node = component_stack.back();
+                    component_stack.pop_back();
+                    clear_on_stack(node);
+                    component_of[node] = components_count;
+                } while (node != x);
+                components_count++;
+            }
+
+            if (!call_stack.empty()) {
+                int parent = call_stack.back();
+                low_link[parent] = std::min(low_link[parent], low_link[x]);
+            }
+        }
+    }
+
+public:
+
+    explicit SCCCalculator(const FlatGraph& graph)
+        : graph(graph), id(graph.n), low_link(graph.n), next_edge(graph.n),
+          on_stack((graph.n + 63) / 64), component_of(graph.n), last_id(0), components_count(0) {}
+
+    // Same output as get_SCCs in "2-Satisfiability.cpp": the component
+    // of each node, numbered in a reverse topological order.
+    const std::vector<int>& solve()
+    {
+        std::fill(id.begin(), id.end(), UNVISITED);
+        std::fill(on_stack.begin(), on_stack.end(), 0);
+        last_id = 0;
+        components_count = 0;
+
+        for (int i = 0; i < graph.n; i++) {
+            if (id[i] == UNVISITED) {
+                dfs(i);
+            }
+        }
+
+        return component_of;
+    }
+
+    int get_components_count() const {
+        return components_count;
+    }
+
+    // Same output as get_SCCs in "Tarjan.cpp".
+    std::vector<std::vector<int>> get_components()
+    {
+        solve();
+        std::vector<std::vector<int>> result(components_count);
+        for (int i = 0; i < graph.n; i++) {
+            result[component_of[i]].push_back(i);
+        }
+        return result;
+    }
+};
+
+// A copy of the recursive version in "2-Satisfiability.cpp", used only to compare against.
+std::vector<int> get_SCCs(const Graph& graph)
+{
+    int n = graph.size();
+
+    std::vector<int> result(n);
+
+    int last_id = 0;
+    int last_component_number = 0;
+    std::vector<int> id(n, UNVISITED);
+    std::vector<int> low_link(n);
+    std::vector<bool> on_stack(n, false);
+    std::stack<int> stack;
+
+    std::function<void(int)> dfs = [&](int x)
+    {
+        id[x] = low_link[x] = last_id++;
+        stack.push(x);
+        on_stack[x] = true;
+
+        for (int neighbour : graph[x])
+        {
+            if (id[neighbour] == UNVISITED) {
+                dfs(neighbour);
+                low_link[x] = std::min(low_link[x], low_link[neighbour]);
+            } else if (on_stack[neighbour]) {
+                low_link[x] = std::min(low_link[x], low_link[neighbour]);
+            }
+        }
+
+        if (low_link[x] == id[x]) {
+            while (stack.top() != x) {
+                int node = stack.top();
+                stack.pop();
+                on_stack[node] = false;
+                result[node] = last_component_number;
+            }
+            stack.pop();
+            on_stack[x] = false;
+            result[x] = last_component_number;
+            last_component_number++;
+        }
+    };
+
+    for (int i = 0; i < n; i++) {
+        if (id[i] == UNVISITED) {
+            dfs(i);
+        }
+    }
+
+    return result;
+}
+
+Graph get_sample_graph()
+{
+    Graph result(10);
+
+    result[1].push_back(2);
+    result[2].push_back(1);
+    result[1].push_back(3);
+    result[3].push_back(1);
+    result[4].push_back(5);
+    result[5].push_back(4);
+    result[6].push_back(2);
+    result[2].push_back(4);
+    result[6].push_back(5);
+    result[6].push_back(8);
+    result[7].push_back(6);
+    result[8].push_back(7);
+    result[9].push_back(7);
+    result[9].push_back(8);
+    result[9].push_back(9);
+
+    return result;
+}
+
+// A single path 0 -> 1 -> ... -> n - 1, closed into a cycle if
+// requested. This makes the DFS n nodes deep.
+std::vector<std::pair<int, int>> get_chain(int n, bool cycle)
+{
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(n);
+    for (int i = 0; i + 1 < n; i++) edges.push_back({i, i + 1});
+    if (cycle) edges.push_back({n - 1, 0});
+    return edges;
+}
+
+std::vector<std::pair<int, int>> get_random_edges(int n, long long m, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<std::pair<int, int>> edges(m);
+    for (auto& edge : edges) edge = {(int)(random() % n), (int)(random() % n)};
+    return edges;
+}
+
+Graph to_graph(int n, const std::vector<std::pair<int, int>>& edges)
+{
+    Graph graph(n);
+    for (auto& edge : edges) graph[edge.first].push_back(edge.second);
+    return graph;
+}
+
+void test(const Graph& graph)
+{
+    FlatGraph flat(graph);
+    auto components = SCCCalculator(flat).get_components();
+    std::cout << "Components sorted in a reverse topological order:" << std::endl;
+    for (int i = 0; i < components.size(); i++) {
+        std::cout << "Component " << i+1 << ": ";
+        for (int node : components[i]) {
+            std::cout << node << ' ';
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(5);
+    for (int i = 0; i < tests; i++)
+    {
+        int n = 1 + random() % 200;
+        auto edges = get_random_edges(n, random() % (3 * n), i);
+        Graph graph = to_graph(n, edges);
+
+        // Both number the components in the same order, so the results must be equal.
+        if (SCCCalculator(FlatGraph(graph)).solve() != get_SCCs(graph))
+            std::cout << "Wrong components!" << std::endl;
+    }
+}
+
+void time_test(const std::string& name, int n, const std::vector<std::pair<int, int>>& edges, bool run_recursive)
+{
+    FlatGraph flat(n, edges);
+    SCCCalculator calculator(flat);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    calculator.solve();
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    std::cout << name << " (V = " << n << ", E = " << edges.size() << "): "
+              << calculator.get_components_count() << " components" << std::endl;
+    std::cout << "Iterative: " << ms << " ms" << std::endl;
+
+    if (run_recursive) {
+        Graph graph = to_graph(n, edges);
+        start = std::chrono::high_resolution_clock::now();
+        auto components = get_SCCs(graph);
+        end = std::chrono::high_resolution_clock::now();
+        ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        std::cout << "Recursive: " << ms << " ms" << std::endl;
+        if (components != calculator.solve())
+            std::cout << "Wrong components!" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test(get_sample_graph());
+    random_test(200);
+
+    // The recursive version overflows the stack on deep
+    // DFS trees, so it only runs on the short chains.
+    time_test("Chain", 10'000, get_chain(10'000, false), true);
+    time_test("Cycle", 10'000, get_chain(10'000, true), true);
+    time_test("Chain", 10'000'000, get_chain(10'000'000, false), false);
+    time_test("Cycle", 10'000'000, get_chain(10'000'000, true), false);
+    time_test("Random", 100'000, get_random_edges(100'000, 400'000, 1), true);
+    time_test("Random", 1'000'000, get_random_edges(1'000'000, 4'000'000, 1), false);
+    time_test("Random", 10'000'000, get_random_edges(10'000'000, 40'000'000, 1), false);
+}
@@ -5,6 +5,9 @@
 #include <iostream>
 #include <functional>
 #include <algorithm>
+#include <unordered_map>
+#include <random>
+#include <chrono>
 
 // TODO The code for finding the centers is improved (in
 //  its own file), but this code is not. Improve this code.
@@ -129,6 +132,229 @@ std::pair<std::string, std::string> get_canonical_form_by_shrinking_tree(Tree tr
     return {res1, res2};
 }
 
+class IntegerCanonicalForm
+{
+    // The same canonical form as get_canonical_form_by_shrinking_tree, but
+    //  each subtree is an integer instead of a string (AHU). A subtree is
+    //  described by the weight of the edge to its parent, and the sorted
+    //  integers of its children, and this description gets an integer:
+    //  - In the interning mode, it's looked up in a hash map, and new
+    //    descriptions get the next id. Two subtrees have the same id
+    //    iff they have the same string in the original.
+    //  - In the hashing mode, it's a random polynomial hash of the
+    //    description (mod 2^61 - 1), which doesn't need the map, but two
+    //    different subtrees have the same hash with a tiny probability.
+    //    Each element is mixed (with a random seed) before it goes into the
+    //    polynomial. Otherwise, the hashes of the children are polynomials
+    //    in the same base, and different trees can give the same polynomial,
+    //    which collides for any base.
+    // The results are only comparable between trees of the same object.
+    //
+    // The centers are found by removing the leaves round by round, like in
+    //  the original, but the tree isn't copied or changed, and the children
+    //  of each node are put in a flat array, in the order they were removed,
+    //  which is also the order their integers are computed in.
+
+public:
+
+    enum Mode { interning, hashing };
+
+private:
+
+    struct VectorHash
+    {
+        size_t operator()(const std::vector<long long>& vector) const
+        {
+            size_t result = vector.size();
+            for (long long x : vector)
+                result ^= std::hash<long long>()(x) + 0x9e3779b97f4a7c15 + (result << 6) + (result >> 2);
+            return result;
+        }
+    };
+
+    static const unsigned long long MOD = (1ULL << 61) - 1;
+
+    Mode mode;
+    std::unordered_map<std::vector<long long>, long long, VectorHash> ids;
+    unsigned long long base;
+    unsigned long long mix_seed;
+
+    // Reused between the calls.
+    std::vector<int> degree;
+    std::vector<int> parent;
+    std::vector<int> parent_weight;
+    std::vector<int> order;
+    std::vector<int> offsets;
+    std::vector<long long> children;
+    std::vector<long long> value;
+    std::vector<long long> key;
+
+    static unsigned long long multiply(unsigned long long a, unsigned long long b)
+    {
+        unsigned __int128 product = (unsigned __int128)a * b;
+        unsigned long long result = (product & MOD) + (unsigned long long)(product >> 61);
+        return result >= MOD ? result - MOD : result;
+    }
+
+    // splitmix64.
+    unsigned long long mix(unsigned long long x) const
+    {
+        x += mix_seed;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return (x ^ (x >> 31)) % MOD;
+    }
+
+    static unsigned long long add(unsigned long long a, unsigned long long b)
+    {
+        unsigned long long result = a + b;
+        return result >= MOD ? result - MOD : result;
+    }
+
+    // The key is {has_weight, weight, the sorted children...}, where
+    //  has_weight is 0 only for the single center.
+    long long get_value()
+    {
+        std::sort(key.begin() + 2, key.end());
+
+        if (mode == interning) {
+            auto it = ids.try_emplace(key, ids.size()).first;
+            return it->second;
+        }
+
+        unsigned long long result = 0;
+        for (long long x : key)
+            result = add(multiply(result, base), mix(x));
+        return result;
+    }
+
+    void start_key(bool has_weight, int weight)
+    {
+        key.clear();
+        key.push_back(has_weight);
+        key.push_back(weight);
+    }
+
+    void add_children(int node) {
+        key.insert(key.end(), children.begin() + offsets[node], children.begin() + offsets[node + 1]);
+    }
+
+public:
+
+    explicit IntegerCanonicalForm(Mode mode = interning, unsigned seed = 5489) : mode(mode)
+    {
+        std::mt19937_64 random(seed);
+        base = (1 << 20) + random() % (MOD - (1 << 21));
+        mix_seed = random();
+    }
+
+    // Returns the same pairs as get_canonical_form_by_shrinking_tree, with
+    //  integers instead of strings, and -1 instead of an empty second string.
+    //  Like there, tree[0] is not used.
+    std::pair<long long, long long> get_canonical_form(const Tree& tree)
+    {
+        int n = tree.size();
+        degree.resize(n);
+        parent.resize(n);
+        parent_weight.resize(n);
+        order.clear();
+
+        for (int i = 1; i < n; i++)
+            degree[i] = tree[i].size();
+
+        // The order of removal is a queue, like in the original.
+        for (int i = 1; i < n; i++)
+            if (degree[i] == 1) order.push_back(i);
+
+        int tree_size = n - 1;
+        int round_start = 0;
+        while (tree_size > 2)
+        {
+            int round_end = order.size();
+            for (int i = round_start; i < round_end; i++)
+            {
+                int node = order[i];
+                // The only neighbour that isn't removed yet.
+                for (auto& edge : tree[node]) {
+                    if (degree[edge.to] > 0) {
+                        parent[node] = edge.to;
+                        parent_weight[node] = edge.weight;
+                        break;
+                    }
+                }
+                degree[node] = 0;
+                if (--degree[parent[node]] == 1)
+                    order.push_back(parent[node]);
+                tree_size--;
+            }
+            round_start = round_end;
+        }
+
+        // The centers are the rest of the queue.
+        int center1 = round_start < (int)order.size() ? order[round_start] : 1;
+        int removed_count = round_start;
+        Edge center_edge = {0, 0};
+        if (tree_size == 2) {
+            for (auto& edge : tree[center1])
+                if (degree[edge.to] > 0) center_edge = edge;
+        }
+
+        offsets.assign(n + 1, 0);
+        for (int i = 0; i < removed_count; i++)
+            offsets[parent[order[i]] + 1]++;
+        for (int i = 0; i < n; i++)
+            offsets[i + 1] += offsets[i];
+        children.resize(removed_count);
+        value.resize(n);
+
+        std::vector<int>& position = degree; // Not needed anymore.
+        for (int i = 0; i < n; i++)
+            position[i] = offsets[i];
+        for (int i = 0; i < removed_count; i++)
+        {
+            int node = order[i];
+            start_key(true, parent_weight[node]);
+            add_children(node);
+            value[node] = get_value();
+            children[position[parent[node]]++] = value[node];
+        }
+
+        if (tree_size == 1) {
+            start_key(false, 0);
+            add_children(center1);
+            return {get_value(), -1};
+        }
+
+        int center2 = center_edge.to;
+        int weight = center_edge.weight;
+
+        // Each center as a child of the other.
+        start_key(true, weight);
+        add_children(center2);
+        long long value2 = get_value();
+        start_key(true, weight);
+        add_children(center1);
+        long long value1 = get_value();
+
+        start_key(true, weight);
+        add_children(center1);
+        key.push_back(value2);
+        long long result1 = get_value();
+
+        start_key(true, weight);
+        add_children(center2);
+        key.push_back(value1);
+        long long result2 = get_value();
+
+        return {result1, result2};
+    }
+
+    // The number of different subtrees seen so far, in the interning mode.
+    int get_ids_count() const {
+        return ids.size();
+    }
+};
+
 void add_child(Tree &tree, int parent, int child, int weight)
 {
     tree[parent].insert({child, weight});
@@ -196,6 +422,15 @@ bool is_isomorphic(const std::pair<std::string, std::string> &a, const std::pair
             );
 }
 
+bool is_isomorphic(const std::pair<long long, long long> &a, const std::pair<long long, long long> &b)
+{
+    return a.first == b.first ||
+            (
+                (a.second != -1 && b.second != -1) &&
+                (a.second == b.first || a.first == b.second || a.second == b.second)
+            );
+}
+
 void print(const std::vector<Tree> &trees)
 {
     std::vector<std::pair<std::string, std::string>> canonical_representation(trees.size());
@@ -214,6 +449,123 @@ void print(const std::vector<Tree> &trees)
             }
         }
     }
+
+    std::cout << std::endl;
+
+    for (auto mode : {IntegerCanonicalForm::interning, IntegerCanonicalForm::hashing})
+    {
+        IntegerCanonicalForm canonical_form(mode);
+        std::vector<std::pair<long long, long long>> forms(trees.size());
+        for (int i = 0; i < trees.size(); i++) {
+            forms[i] = canonical_form.get_canonical_form(trees[i]);
+            std::cout << forms[i].first << " - " << forms[i].second << std::endl;
+        }
+        for (int i = 0; i < trees.size(); i++) {
+            for (int j = i + 1; j < trees.size(); j++) {
+                if (is_isomorphic(forms[i], forms[j])) {
+                    std::cout << "Trees " << i + 1 << " and " << j + 1 << " are isomorphic." << std::endl;
+                }
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+// A random tree on the nodes 1 to n, with weights from 1 to max_weight. Its
+//  shape is one of shapes_count shapes, and its labels are shuffled, so
+//  many of the trees are isomorphic.
+Tree get_random_tree(int n, int max_weight, int shapes_count, std::mt19937& random)
+{
+    std::mt19937 shape_random(random() % shapes_count);
+    std::vector<int> label(n + 1);
+    for (int i = 0; i <= n; i++) label[i] = i;
+    std::shuffle(label.begin() + 1, label.end(), random);
+
+    Tree tree(n + 1);
+    for (int i = 2; i <= n; i++) {
+        int parent = 1 + shape_random() % (i - 1);
+        add_child(tree, label[parent], label[i], 1 + shape_random() % max_weight);
+    }
+    return tree;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(3);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 2 + random() % 12; // The original doesn't handle a single node.
+        std::vector<Tree> trees;
+        for (int i = 0; i < 20; i++)
+            trees.push_back(get_random_tree(n, 1 + random() % 2, 1 + random() % 10, random));
+
+        std::vector<std::pair<std::string, std::string>> expected;
+        for (auto& tree : trees)
+            expected.push_back(get_canonical_form_by_shrinking_tree(tree));
+
+        for (auto mode : {IntegerCanonicalForm::interning, IntegerCanonicalForm::hashing})
+        {
+            IntegerCanonicalForm canonical_form(mode, t);
+            std::vector<std::pair<long long, long long>> forms;
+            for (auto& tree : trees)
+                forms.push_back(canonical_form.get_canonical_form(tree));
+
+            for (int i = 0; i < trees.size(); i++) {
+                for (int j = 0; j < trees.size(); j++) {
+                    if (is_isomorphic(forms[i], forms[j]) != is_isomorphic(expected[i], expected[j]) ||
+                        (forms[i].first == forms[j].first) != (expected[i].first == expected[j].first)) {
+                        std::cout << "Wrong canonical form!" << std::endl;
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Isomorphic trees have the same set of forms (a single
+//  form for one center, and two forms for two centers).
+template <typename T>
+std::pair<T, T> get_key(std::pair<T, T> form)
+{
+    if (form.first > form.second) std::swap(form.first, form.second);
+    return form;
+}
+
+void time_test(int trees_count, int n, int shapes_count)
+{
+    std::mt19937 random(trees_count);
+    std::vector<Tree> trees;
+    for (int i = 0; i < trees_count; i++)
+        trees.push_back(get_random_tree(n, 3, shapes_count, random));
+    std::cout << trees_count << " trees of " << n << " nodes, out of " << shapes_count << " shapes" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::set<std::pair<std::string, std::string>> strings;
+    for (auto& tree : trees)
+        strings.insert(get_key(get_canonical_form_by_shrinking_tree(tree)));
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Strings: " << ms << " ms, " << (long long)trees_count * 1000 / std::max<long long>(ms, 1)
+              << " trees per second, " << strings.size() << " different trees" << std::endl;
+
+    for (auto mode : {IntegerCanonicalForm::interning, IntegerCanonicalForm::hashing})
+    {
+        start = std::chrono::high_resolution_clock::now();
+        IntegerCanonicalForm canonical_form(mode);
+        std::set<std::pair<long long, long long>> forms;
+        for (auto& tree : trees)
+            forms.insert(get_key(canonical_form.get_canonical_form(tree)));
+        end = std::chrono::high_resolution_clock::now();
+        ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        std::cout << (mode == IntegerCanonicalForm::interning ? "Interning: " : "Hashing: ") << ms << " ms, "
+                  << (long long)trees_count * 1000 / std::max<long long>(ms, 1) << " trees per second, "
+                  << forms.size() << " different trees" << std::endl;
+
+        if (forms.size() != strings.size()) std::cout << "Wrong canonical form!" << std::endl;
+    }
+
+    std::cout << std::endl;
 }
 
 int main()
@@ -225,4 +577,9 @@ int main()
     };
 
     print(trees);
+    random_test(300);
+
+    time_test(100'000, 20, 1000);
+    time_test(100'000, 20, 1'000'000);
+    time_test(10, 100'000, 10);
 }
@@ -1,8 +1,18 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <chrono>
+#include <random>
 
 typedef std::vector<std::vector<int>> Tree;
 
+int log2_floor(int x)
+{
+    int result = 0;
+    while (x >>= 1) result++;
+    return result;
+}
+
 struct RootedTree
 {
     int root;
@@ -125,6 +135,151 @@ public:
     }
 };
 
+// The centroid decomposition as flat arrays, which is
+// what most of the distance-based queries need.
+struct FlatCentroidDecomposition
+{
+    int root;
+    // The levels are at most log2(n), so each node has a
+    //  row of levels_count distances.
+    int levels_count;
+    std::vector<int> parent_of;
+    std::vector<int> level;
+    // distances[node * levels_count + k] = the distance in the original
+    //  tree between the node and its ancestor at level k in the centroid
+    //  decomposition tree, for all k <= level[node].
+    std::vector<int> distances;
+
+    int distance_to_ancestor(int node, int ancestor_level) const {
+        return distances[(size_t)node * levels_count + ancestor_level];
+    }
+};
+
+class IterativeCentroidDecomposition
+{
+    // Builds the same decomposition as CentroidDecomposition (the same
+    //  centroids, and the same parents), but without recursion, so path-like
+    //  trees don't overflow the stack, and without building a Tree for it.
+    //
+    // Each component is explored with a BFS from its centroid, which gives
+    //  the distances from the centroid to the whole component. The same BFS
+    //  also gives the subtree sizes of each of the components that are left
+    //  after removing the centroid, rooted at the neighbour of the centroid,
+    //  which is where CentroidDecomposition would start looking for their
+    //  centroids. This way, each node is visited once per level.
+
+    const Tree& tree;
+
+    std::vector<char> is_blocked;
+    std::vector<int> subtree_size;
+
+    struct QueueFrame
+    {
+        int node;
+        int parent;
+        int distance;
+    };
+    std::vector<QueueFrame> queue;
+
+    // Puts the component of the node in the queue, in BFS order,
+    //  and sets the subtree sizes, rooted at the node.
+    void explore_component(int node)
+    {
+        queue.clear();
+        queue.push_back({node, -1, 0});
+        for (int i = 0; i < (int)queue.size(); i++)
+        {
+            auto frame = queue[i];
+            subtree_size[frame.node] = 1;
+            for (int child : tree[frame.node]) {
+                if (!is_blocked[child] && child != frame.parent)
+                    queue.push_back({child, frame.node, frame.distance + 1});
+            }
+        }
+
+        for (int i = queue.size() - 1; i > 0; i--)
+            subtree_size[queue[i].parent] += subtree_size[queue[i].node];
+    }
+
+    int find_centroid(int node)
+    {
+        int tree_size = subtree_size[node];
+        int parent = -1;
+
+        while (true)
+        {
+            int next = -1;
+            for (int child : tree[node])
+            {
+                if (is_blocked[child] || child == parent)
+                    continue;
+
+                if (subtree_size[child] > tree_size / 2) {
+                    next = child;
+                    break;
+                }
+            }
+
+            if (next == -1) return node;
+            parent = node;
+            node = next;
+        }
+    }
+
+public:
+
+    explicit IterativeCentroidDecomposition(const Tree& tree) :
+        tree(tree),
+        is_blocked(tree.size(), false),
+        subtree_size(tree.size())
+    {}
+
+    FlatCentroidDecomposition get_centroid_decomposition()
+    {
+        int n = tree.size();
+
+        FlatCentroidDecomposition result;
+        result.levels_count = log2_floor(n) + 1;
+        result.parent_of.resize(n);
+        result.level.resize(n);
+        result.distances.resize((size_t)n * result.levels_count);
+
+        struct Component
+        {
+            int start;
+            int parent_centroid;
+        };
+
+        int node = 0; // The node here doesn't matter.
+        explore_component(node);
+        std::vector<Component> stack = {{node, -1}};
+
+        while (!stack.empty())
+        {
+            auto component = stack.back();
+            stack.pop_back();
+
+            int centroid = find_centroid(component.start);
+            int parent = component.parent_centroid;
+            int level = parent == -1 ? 0 : result.level[parent] + 1;
+            result.parent_of[centroid] = parent;
+            result.level[centroid] = level;
+            if (parent == -1) result.root = centroid;
+
+            explore_component(centroid);
+            for (auto& frame : queue)
+                result.distances[(size_t)frame.node * result.levels_count + level] = frame.distance;
+            is_blocked[centroid] = true;
+
+            for (int child : tree[centroid])
+                if (!is_blocked[child])
+                    stack.push_back({child, centroid});
+        }
+
+        return result;
+    }
+};
+
 Tree get_sample_tree_1()
 {
     // Centroid = 0
@@ -203,6 +358,124 @@ void test(const Tree& tree)
     std::cout << max_depth(tree, cd.root) << std::endl;
     std::cout << "Max Depth for the centroid decomposition rooted at " << cd.root << " = ";
     std::cout << max_depth(cd.tree, cd.root) << std::endl;
+
+    auto flat = IterativeCentroidDecomposition(tree).get_centroid_decomposition();
+    for (int node = 0; node < tree.size(); node++)
+    {
+        std::cout << "Node " << node << ": level " << flat.level[node] << ", distances to the centroid ancestors:";
+        for (int k = 0; k <= flat.level[node]; k++)
+            std::cout << ' ' << flat.distance_to_ancestor(node, k);
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// The parent of each node is one of the max_back nodes before it
+// (in a random order), so max_back = 1 gives a path.
+Tree get_random_tree(int n, int max_back, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<int> label(n);
+    for (int i = 0; i < n; i++) label[i] = i;
+    std::shuffle(label.begin(), label.end(), random);
+
+    Tree tree(n);
+    for (int i = 1; i < n; i++) {
+        int parent = i - 1 - random() % std::min(i, max_back);
+        add_edge(tree, label[parent], label[i]);
+    }
+    return tree;
+}
+
+std::vector<int> get_distances(const Tree& tree, int source)
+{
+    std::vector<int> distances(tree.size(), -1);
+    std::vector<int> queue = {source};
+    distances[source] = 0;
+    for (int i = 0; i < (int)queue.size(); i++) {
+        for (int child : tree[queue[i]]) {
+            if (distances[child] == -1) {
+                distances[child] = distances[queue[i]] + 1;
+                queue.push_back(child);
+            }
+        }
+    }
+    return distances;
+}
+
+void set_parents(const Tree& tree, int node, std::vector<int>& parent_of, int parent = -1)
+{
+    parent_of[node] = parent;
+    for (int child : tree[node])
+        if (child != parent)
+            set_parents(tree, child, parent_of, node);
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(17);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 200;
+        auto tree = get_random_tree(n, 1 + random() % n, t);
+
+        auto cd = CentroidDecomposition(tree).get_centroid_decomposition();
+        std::vector<int> expected_parents(n);
+        set_parents(cd.tree, cd.root, expected_parents);
+
+        auto flat = IterativeCentroidDecomposition(tree).get_centroid_decomposition();
+        if (flat.root != cd.root || flat.parent_of != expected_parents) {
+            std::cout << "Wrong centroid decomposition!" << std::endl;
+            return;
+        }
+
+        for (int node = 0; node < n; node++)
+        {
+            auto distances = get_distances(tree, node);
+            int ancestor = node;
+            for (int k = flat.level[node]; k >= 0; k--, ancestor = flat.parent_of[ancestor])
+            {
+                if (flat.level[ancestor] != k || flat.distance_to_ancestor(node, k) != distances[ancestor]) {
+                    std::cout << "Wrong distance!" << std::endl;
+                    return;
+                }
+            }
+            if (ancestor != -1) {
+                std::cout << "Wrong level!" << std::endl;
+                return;
+            }
+        }
+    }
+}
+
+void time_test(int n, int max_back, bool run_recursive)
+{
+    auto tree = get_random_tree(n, max_back, n);
+    std::cout << "n = " << n << ", parents up to " << max_back << " nodes back" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto flat = IterativeCentroidDecomposition(tree).get_centroid_decomposition();
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    int max_level = *std::max_element(flat.level.begin(), flat.level.end());
+    std::cout << "Iterative, with the distances: " << ms << " ms, "
+              << max_level + 1 << " levels" << std::endl;
+
+    if (run_recursive)
+    {
+        start = std::chrono::high_resolution_clock::now();
+        auto cd = CentroidDecomposition(tree).get_centroid_decomposition();
+        end = std::chrono::high_resolution_clock::now();
+        ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        std::cout << "Recursive, without the distances: " << ms << " ms" << std::endl;
+        if (cd.root != flat.root) std::cout << "Wrong centroid decomposition!" << std::endl;
+    }
+    else
+    {
+        // A path this long overflows the default stack with the recursive version.
+        std::cout << "Recursive: skipped" << std::endl;
+    }
+
     std::cout << std::endl;
 }
 
@@ -210,4 +483,9 @@ int main()
 {
     test(get_sample_tree_1());
     test(get_sample_tree_2());
+    random_test(300);
+
+    time_test(1'000'000, 1'000'000, true);
+    time_test(1'000'000, 100, true);
+    time_test(1'000'000, 1, false);
 }
\ No newline at end of file
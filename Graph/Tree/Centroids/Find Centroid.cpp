@@ -1,8 +1,15 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <chrono>
+#include <random>
 
 typedef std::vector<std::vector<int>> Tree;
 
+int get_to(int node) {
+    return node;
+}
+
 class CentroidFinder
 {
     int root;
@@ -94,6 +101,120 @@ public:
     }
 };
 
+// The rerooting DP of "../Rerooting DP.cpp": the answer of a tree DP
+//  for every node as the root, with two passes over a BFS order.
+template <typename Policy>
+std::vector<typename Policy::Value> get_rerooted_answers(const Tree& tree, int root = 0)
+{
+    typedef typename Policy::Value Value;
+    typedef typename Tree::value_type::value_type TreeEdge;
+
+    int n = tree.size();
+    std::vector<Value> answers(n, Policy::identity());
+
+    // The BFS order, the position of the parent of each position, the edge
+    //  from it, and where the children of each position start.
+    std::vector<int> order = {root};
+    std::vector<int> parent = {-1};
+    std::vector<TreeEdge> parent_edge(1);
+    std::vector<int> children_start;
+    order.reserve(n);
+    parent.reserve(n);
+    parent_edge.reserve(n);
+    children_start.reserve(n + 1);
+    for (int i = 0; i < (int)order.size(); i++)
+    {
+        int node = order[i];
+        int parent_node = parent[i] == -1 ? -1 : order[parent[i]];
+        children_start.push_back(order.size());
+        for (auto& edge : tree[node]) {
+            int child = get_to(edge);
+            if (child != parent_node) {
+                order.push_back(child);
+                parent.push_back(i);
+                parent_edge.push_back(edge);
+            }
+        }
+    }
+    int count = order.size();
+    children_start.push_back(count);
+
+    // down[i] is first the merge of the children of i so far, then its value.
+    std::vector<Value> down(count, Policy::identity());
+    for (int i = count - 1; i >= 0; i--)
+    {
+        down[i] = Policy::finalize(down[i], order[i]);
+        if (i != 0) down[parent[i]] = Policy::merge(down[parent[i]], Policy::extend(down[i], parent_edge[i]));
+    }
+
+    // up[i] is what the rest of the tree adds to i, through its parent.
+    std::vector<Value> up(count, Policy::identity());
+    std::vector<Value> contributions;
+    std::vector<Value> prefix;
+    for (int i = 0; i < count; i++)
+    {
+        int first = children_start[i];
+        int children_count = children_start[i + 1] - first;
+
+        contributions.resize(children_count);
+        prefix.resize(children_count + 1);
+        prefix[0] = up[i];
+        for (int j = 0; j < children_count; j++) {
+            contributions[j] = Policy::extend(down[first + j], parent_edge[first + j]);
+            prefix[j + 1] = Policy::merge(prefix[j], contributions[j]);
+        }
+
+        answers[order[i]] = Policy::finalize(prefix[children_count], order[i]);
+
+        Value suffix = Policy::identity();
+        for (int j = children_count - 1; j >= 0; j--) {
+            Value without = Policy::finalize(Policy::merge(prefix[j], suffix), order[i]);
+            up[first + j] = Policy::extend(without, parent_edge[first + j]);
+            suffix = Policy::merge(contributions[j], suffix);
+        }
+    }
+
+    return answers;
+}
+
+// The size of the largest component left after removing each node.
+struct LargestComponent
+{
+    struct Value
+    {
+        int size;
+        int largest;
+    };
+
+    static Value identity() {
+        return {0, 0};
+    }
+
+    static Value merge(const Value& a, const Value& b) {
+        return {a.size + b.size, std::max(a.largest, b.largest)};
+    }
+
+    static Value extend(const Value& value, int /*edge*/) {
+        return {value.size, value.size};
+    }
+
+    static Value finalize(const Value& value, int /*node*/) {
+        return {value.size + 1, value.largest};
+    }
+};
+
+// All the centroids (one or two), without recursion. A node is a centroid
+//  iff all the components left after removing it are <= tree.size() / 2.
+std::vector<int> find_centroids(const Tree& tree)
+{
+    auto components = get_rerooted_answers<LargestComponent>(tree);
+    std::vector<int> result;
+    for (int node = 0; node < tree.size(); node++)
+        if (components[node].largest <= tree.size() / 2)
+            result.push_back(node);
+    return result;
+}
+
 void add_edge(Tree& tree, int parent, int child)
 {
     tree[parent].push_back(child);
@@ -158,10 +279,92 @@ void test(const Tree& tree)
             std::cout << "Fail..." << std::endl;
 
     std::cout << "Centroid is node " << centroid << "." << std::endl;
+
+    if (find_centroids(tree) != std::vector<int>{centroid})
+        std::cout << "Fail..." << std::endl;
+}
+
+// The parent of each node is one of the max_back nodes before it
+// (in a random order), so max_back = 1 gives a path.
+Tree get_random_tree(int n, int max_back, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<int> label(n);
+    for (int i = 0; i < n; i++) label[i] = i;
+    std::shuffle(label.begin(), label.end(), random);
+
+    Tree tree(n);
+    for (int i = 1; i < n; i++) {
+        int parent = i - 1 - random() % std::min(i, max_back);
+        add_edge(tree, label[parent], label[i]);
+    }
+    return tree;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(37);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 100;
+        auto tree = get_random_tree(n, 1 + random() % n, t);
+        auto centroids = find_centroids(tree);
+
+        // Each root leads CentroidFinder to one of the centroids, and each centroid
+        //  is reached from itself.
+        bool is_correct = !centroids.empty() && centroids.size() <= 2;
+        for (int root = 0; root < n; root++) {
+            int centroid = CentroidFinder(tree, root).find_centroid();
+            if (std::find(centroids.begin(), centroids.end(), centroid) == centroids.end())
+                is_correct = false;
+        }
+        for (int centroid : centroids)
+            if (CentroidFinder(tree, centroid).find_centroid() != centroid)
+                is_correct = false;
+
+        if (!is_correct) {
+            std::cout << "Wrong centroids!" << std::endl;
+            return;
+        }
+    }
+}
+
+void time_test(int n, int max_back, bool run_recursive)
+{
+    auto tree = get_random_tree(n, max_back, n);
+    std::cout << "n = " << n << ", parents up to " << max_back << " nodes back" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto centroids = find_centroids(tree);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Rerooting: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms, " << centroids.size() << " centroid(s)" << std::endl;
+
+    if (run_recursive)
+    {
+        start = std::chrono::high_resolution_clock::now();
+        int centroid = CentroidFinder(tree).find_centroid();
+        end = std::chrono::high_resolution_clock::now();
+        std::cout << "Recursive: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+                  << " ms" << std::endl;
+        if (std::find(centroids.begin(), centroids.end(), centroid) == centroids.end())
+            std::cout << "Wrong centroids!" << std::endl;
+    }
+    else
+    {
+        // A path this long overflows the default stack with the recursive version.
+        std::cout << "Recursive: skipped" << std::endl;
+    }
+
+    std::cout << std::endl;
 }
 
 int main()
 {
     test(get_sample_tree_1());
     test(get_sample_tree_2());
+    random_test(300);
+
+    time_test(10'000'000, 10'000'000, true);
+    time_test(10'000'000, 1, false);
 }
\ No newline at end of file
@@ -1,9 +1,16 @@
 #include <queue>
 #include <vector>
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
 
 typedef std::vector<std::vector<int>> Tree;
 
+int get_to(int node) {
+    return node;
+}
+
 std::pair<int, int> get_center_nodes_by_shrinking_tree(const Tree& tree)
 {
     // some optimizations can be done here to be faster.
@@ -42,9 +49,18 @@ std::pair<int, int> get_center_nodes_by_shrinking_tree(const Tree& tree)
             int node = leaves.front();
             leaves.pop();
 
-            // since the current node is a leaf, it'll
-            // have a single edge, going to its parent.
-            int parent = tree[node].front();
+            // since the current node is a leaf, it'll have a single
+            // edge left, going to its parent. the edges to the nodes
+            // that are already removed are still there, so the parent
+            // is the only neighbour that isn't removed.
+            child_count[node] = 0;
+            int parent = -1;
+            for (int neighbour : tree[node]) {
+                if (child_count[neighbour] > 0) {
+                    parent = neighbour;
+                    break;
+                }
+            }
 
             int& children = child_count[parent];
             if ((--children) == 1) {
@@ -65,6 +81,121 @@ std::pair<int, int> get_center_nodes_by_shrinking_tree(const Tree& tree)
     return {res1, res2};
 }
 
+// The rerooting DP of "../Rerooting DP.cpp": the answer of a tree DP
+//  for every node as the root, with two passes over a BFS order.
+template <typename Policy>
+std::vector<typename Policy::Value> get_rerooted_answers(const Tree& tree, int root = 0)
+{
+    typedef typename Policy::Value Value;
+    typedef typename Tree::value_type::value_type TreeEdge;
+
+    int n = tree.size();
+    std::vector<Value> answers(n, Policy::identity());
+
+    // The BFS order, the position of the parent of each position, the edge
+    //  from it, and where the children of each position start.
+    std::vector<int> order = {root};
+    std::vector<int> parent = {-1};
+    std::vector<TreeEdge> parent_edge(1);
+    std::vector<int> children_start;
+    order.reserve(n);
+    parent.reserve(n);
+    parent_edge.reserve(n);
+    children_start.reserve(n + 1);
+    for (int i = 0; i < (int)order.size(); i++)
+    {
+        int node = order[i];
+        int parent_node = parent[i] == -1 ? -1 : order[parent[i]];
+        children_start.push_back(order.size());
+        for (auto& edge : tree[node]) {
+            int child = get_to(edge);
+            if (child != parent_node) {
+                order.push_back(child);
+                parent.push_back(i);
+                parent_edge.push_back(edge);
+            }
+        }
+    }
+    int count = order.size();
+    children_start.push_back(count);
+
+    // down[i] is first the merge of the children of i so far, then its value.
+    std::vector<Value> down(count, Policy::identity());
+    for (int i = count - 1; i >= 0; i--)
+    {
+        down[i] = Policy::finalize(down[i], order[i]);
+        if (i != 0) down[parent[i]] = Policy::merge(down[parent[i]], Policy::extend(down[i], parent_edge[i]));
+    }
+
+    // up[i] is what the rest of the tree adds to i, through its parent.
+    std::vector<Value> up(count, Policy::identity());
+    std::vector<Value> contributions;
+    std::vector<Value> prefix;
+    for (int i = 0; i < count; i++)
+    {
+        int first = children_start[i];
+        int children_count = children_start[i + 1] - first;
+
+        contributions.resize(children_count);
+        prefix.resize(children_count + 1);
+        prefix[0] = up[i];
+        for (int j = 0; j < children_count; j++) {
+            contributions[j] = Policy::extend(down[first + j], parent_edge[first + j]);
+            prefix[j + 1] = Policy::merge(prefix[j], contributions[j]);
+        }
+
+        answers[order[i]] = Policy::finalize(prefix[children_count], order[i]);
+
+        Value suffix = Policy::identity();
+        for (int j = children_count - 1; j >= 0; j--) {
+            Value without = Policy::finalize(Policy::merge(prefix[j], suffix), order[i]);
+            up[first + j] = Policy::extend(without, parent_edge[first + j]);
+            suffix = Policy::merge(contributions[j], suffix);
+        }
+    }
+
+    return answers;
+}
+
+// The longest branch from a node (the distance to the farthest node).
+struct Eccentricity
+{
+    typedef int Value;
+
+    static Value identity() {
+        return 0;
+    }
+
+    static Value merge(Value a, Value b) {
+        return std::max(a, b);
+    }
+
+    static Value extend(Value value, int /*edge*/) {
+        return value + 1;
+    }
+
+    static Value finalize(Value value, int /*node*/) {
+        return value;
+    }
+};
+
+// The centers are the nodes with the smallest eccentricity. Unlike the
+//  shrinking, this also works for a single node. The centers are in
+//  increasing order.
+std::pair<int, int> get_center_nodes_by_rerooting(const Tree& tree)
+{
+    auto eccentricities = get_rerooted_answers<Eccentricity>(tree);
+    int min = *std::min_element(eccentricities.begin(), eccentricities.end());
+
+    std::pair<int, int> result = {-1, -1};
+    for (int node = 0; node < tree.size(); node++) {
+        if (eccentricities[node] != min) continue;
+        if (result.first == -1) result.first = node;
+        else result.second = node;
+    }
+    return result;
+}
+
 void add_child(Tree &tree, int parent, int child)
 {
     tree[parent].push_back(child);
@@ -128,9 +259,71 @@ void print_centers(const std::vector<Tree> &trees)
     for (auto &tree : trees) {
         auto centers = get_center_nodes_by_shrinking_tree(tree);
         std::cout << centers.first << ", " << centers.second << std::endl;
+        centers = get_center_nodes_by_rerooting(tree);
+        std::cout << centers.first << ", " << centers.second << " (rerooting)" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// The parent of each node is one of the max_back nodes before it
+// (in a random order), so max_back = 1 gives a path.
+Tree get_random_tree(int n, int max_back, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<int> label(n);
+    for (int i = 0; i < n; i++) label[i] = i;
+    std::shuffle(label.begin(), label.end(), random);
+
+    Tree tree(n);
+    for (int i = 1; i < n; i++) {
+        int parent = i - 1 - random() % std::min(i, max_back);
+        add_child(tree, label[parent], label[i]);
+    }
+    return tree;
+}
+
+std::pair<int, int> sorted(std::pair<int, int> centers)
+{
+    if (centers.second != -1 && centers.second < centers.first)
+        std::swap(centers.first, centers.second);
+    return centers;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(29);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 2 + random() % 100; // The shrinking doesn't handle a single node.
+        auto tree = get_random_tree(n, 1 + random() % n, t);
+        if (get_center_nodes_by_rerooting(tree) != sorted(get_center_nodes_by_shrinking_tree(tree))) {
+            std::cout << "Wrong centers!" << std::endl;
+            return;
+        }
     }
 }
 
+void time_test(int n, int max_back)
+{
+    auto tree = get_random_tree(n, max_back, n);
+    std::cout << "n = " << n << ", parents up to " << max_back << " nodes back" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto expected = sorted(get_center_nodes_by_shrinking_tree(tree));
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Shrinking: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    auto centers = get_center_nodes_by_rerooting(tree);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "Rerooting: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms" << std::endl;
+
+    if (centers != expected) std::cout << "Wrong centers!" << std::endl;
+    std::cout << std::endl;
+}
+
 int main()
 {
     std::vector<Tree> trees = {
@@ -140,4 +333,8 @@ int main()
     };
 
     print_centers(trees);
+    random_test(300);
+
+    time_test(10'000'000, 10'000'000);
+    time_test(10'000'000, 1);
 }
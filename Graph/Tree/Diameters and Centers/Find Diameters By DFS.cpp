@@ -3,6 +3,8 @@
 #include <iostream>
 #include <functional>
 #include <algorithm>
+#include <chrono>
+#include <random>
 
 struct Edge
 {
@@ -14,6 +16,10 @@ struct Edge
 
 typedef std::vector<std::vector<Edge>> Tree;
 
+int get_to(const Edge& edge) {
+    return edge.to;
+}
+
 struct LongestPathInfo
 {
     int longest_branch_length;
@@ -83,6 +89,131 @@ LongestPathInfo get_tree_diameter_info_dfs(const Tree &tree, int starting_node =
     return get_diameter_info(starting_node, -1);
 }
 
+// The rerooting DP of "../Rerooting DP.cpp": the answer of a tree DP
+//  for every node as the root, with two passes over a BFS order.
+template <typename Policy>
+std::vector<typename Policy::Value> get_rerooted_answers(const Tree& tree, int root = 0)
+{
+    typedef typename Policy::Value Value;
+    typedef typename Tree::value_type::value_type TreeEdge;
+
+    int n = tree.size();
+    std::vector<Value> answers(n, Policy::identity());
+
+    // The BFS order, the position of the parent of each position, the edge
+    //  from it, and where the children of each position start.
+    std::vector<int> order = {root};
+    std::vector<int> parent = {-1};
+    std::vector<TreeEdge> parent_edge(1);
+    std::vector<int> children_start;
+    order.reserve(n);
+    parent.reserve(n);
+    parent_edge.reserve(n);
+    children_start.reserve(n + 1);
+    for (int i = 0; i < (int)order.size(); i++)
+    {
+        int node = order[i];
+        int parent_node = parent[i] == -1 ? -1 : order[parent[i]];
+        children_start.push_back(order.size());
+        for (auto& edge : tree[node]) {
+            int child = get_to(edge);
+            if (child != parent_node) {
+                order.push_back(child);
+                parent.push_back(i);
+                parent_edge.push_back(edge);
+            }
+        }
+    }
+    int count = order.size();
+    children_start.push_back(count);
+
+    // down[i] is first the merge of the children of i so far, then its value.
+    std::vector<Value> down(count, Policy::identity());
+    for (int i = count - 1; i >= 0; i--)
+    {
+        down[i] = Policy::finalize(down[i], order[i]);
+        if (i != 0) down[parent[i]] = Policy::merge(down[parent[i]], Policy::extend(down[i], parent_edge[i]));
+    }
+
+    // up[i] is what the rest of the tree adds to i, through its parent.
+    std::vector<Value> up(count, Policy::identity());
+    std::vector<Value> contributions;
+    std::vector<Value> prefix;
+    for (int i = 0; i < count; i++)
+    {
+        int first = children_start[i];
+        int children_count = children_start[i + 1] - first;
+
+        contributions.resize(children_count);
+        prefix.resize(children_count + 1);
+        prefix[0] = up[i];
+        for (int j = 0; j < children_count; j++) {
+            contributions[j] = Policy::extend(down[first + j], parent_edge[first + j]);
+            prefix[j + 1] = Policy::merge(prefix[j], contributions[j]);
+        }
+
+        answers[order[i]] = Policy::finalize(prefix[children_count], order[i]);
+
+        Value suffix = Policy::identity();
+        for (int j = children_count - 1; j >= 0; j--) {
+            Value without = Policy::finalize(Policy::merge(prefix[j], suffix), order[i]);
+            up[first + j] = Policy::extend(without, parent_edge[first + j]);
+            suffix = Policy::merge(contributions[j], suffix);
+        }
+    }
+
+    return answers;
+}
+
+// The two longest branches from a node, through different neighbours.
+struct LongestBranches
+{
+    struct Value
+    {
+        int first;
+        int second;
+    };
+
+    static Value identity() {
+        return {0, 0};
+    }
+
+    static Value merge(const Value& a, const Value& b)
+    {
+        if (a.first >= b.first) return {a.first, std::max(a.second, b.first)};
+        return {b.first, std::max(b.second, a.first)};
+    }
+
+    static Value extend(const Value& value, const Edge& edge) {
+        return {value.first + edge.weight, 0};
+    }
+
+    static Value finalize(const Value& value, int /*node*/) {
+        return value;
+    }
+};
+
+// The same info as get_tree_diameter_info_dfs, without recursion. The longest
+//  path through each node is the sum of its two longest branches, and the path
+//  passes through the center (the node with the shortest longest branch), which
+//  is on all the diameters.
+LongestPathInfo get_tree_diameter_info_rerooting(const Tree &tree, int starting_node = 1)
+{
+    auto branches = get_rerooted_answers<LongestBranches>(tree, starting_node);
+
+    LongestPathInfo result = {branches[starting_node].first, 0, starting_node};
+    for (int node = 0; node < tree.size(); node++)
+    {
+        if (tree[node].empty()) continue; // tree[0] is not used.
+
+        result.diameter_length = std::max(result.diameter_length, branches[node].first + branches[node].second);
+        if (branches[node].first < branches[result.passes_through].first)
+            result.passes_through = node;
+    }
+
+    return result;
+}
+
 // set max_count to -1 to get all diameters.
 std::vector<std::vector<int>> generate_diameters(const Tree &tree, const LongestPathInfo &info, int max_count = -1)
 {
@@ -224,6 +355,95 @@ void print_all_diameters(const Tree &tree, const LongestPathInfo &info)
     }
 }
 
+// A random tree on the nodes 1 to n. The parent of each node is one of the
+// max_back nodes before it (in a random order), so max_back = 1 gives a path.
+Tree get_random_tree(int n, int max_back, int max_weight, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<int> label(n + 1);
+    for (int i = 0; i <= n; i++) label[i] = i;
+    std::shuffle(label.begin() + 1, label.end(), random);
+
+    Tree tree(n + 1);
+    for (int i = 2; i <= n; i++) {
+        int parent = i - 1 - random() % std::min(i - 1, max_back);
+        add_child(tree, label[parent], label[i], 1 + random() % max_weight);
+    }
+    return tree;
+}
+
+std::vector<int> get_distances(const Tree& tree, int source)
+{
+    std::vector<int> distances(tree.size(), -1);
+    std::vector<int> queue = {source};
+    distances[source] = 0;
+    for (int i = 0; i < (int)queue.size(); i++) {
+        for (auto& edge : tree[queue[i]]) {
+            if (distances[edge.to] == -1) {
+                distances[edge.to] = distances[queue[i]] + edge.weight;
+                queue.push_back(edge.to);
+            }
+        }
+    }
+    return distances;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(41);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 100;
+        auto tree = get_random_tree(n, 1 + random() % n, 1 + random() % 5, t);
+        auto expected = get_tree_diameter_info_dfs(tree);
+        auto info = get_tree_diameter_info_rerooting(tree);
+
+        // The path from the farthest node from passes_through, to the farthest node from
+        //  that, is a diameter, and passes_through should be on it.
+        auto distances = get_distances(tree, info.passes_through);
+        int end1 = std::max_element(distances.begin(), distances.end()) - distances.begin();
+        auto end1_distances = get_distances(tree, end1);
+        int end2 = std::max_element(end1_distances.begin(), end1_distances.end()) - end1_distances.begin();
+
+        if (info.diameter_length != expected.diameter_length ||
+            info.longest_branch_length != expected.longest_branch_length ||
+            distances[end1] + distances[end2] != info.diameter_length) {
+            std::cout << "Wrong diameter!" << std::endl;
+            return;
+        }
+    }
+}
+
+void time_test(int n, int max_back, bool run_recursive)
+{
+    auto tree = get_random_tree(n, max_back, 100, n);
+    std::cout << "n = " << n << ", parents up to " << max_back << " nodes back" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto info = get_tree_diameter_info_rerooting(tree);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Rerooting: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms, ";
+    print_longest_path_info(info);
+
+    if (run_recursive)
+    {
+        start = std::chrono::high_resolution_clock::now();
+        auto expected = get_tree_diameter_info_dfs(tree);
+        end = std::chrono::high_resolution_clock::now();
+        std::cout << "DFS: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+                  << " ms" << std::endl;
+        if (expected.diameter_length != info.diameter_length) std::cout << "Wrong diameter!" << std::endl;
+    }
+    else
+    {
+        // A path this long overflows the default stack with the recursive version.
+        std::cout << "DFS: skipped" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
 int main()
 {
     auto tree = get_sample_tree();
@@ -231,4 +451,15 @@ int main()
     print_longest_path_info(info);
 
     print_all_diameters(tree, info);
+    std::cout << std::endl;
+
+    info = get_tree_diameter_info_rerooting(tree);
+    print_longest_path_info(info);
+    print_all_diameters(tree, info);
+    std::cout << std::endl;
+
+    random_test(300);
+
+    time_test(10'000'000, 10'000'000, true);
+    time_test(10'000'000, 1, false);
 }
@@ -0,0 +1,503 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <string>
+
+typedef std::vector<std::vector<int>> Tree;
+
+class LowestCommonAncestor
+{
+    // The same binary lifting as "Binary Lifting.cpp", with two changes:
+    //
+    // The table is node-major: the jumps of a node are next to each other in
+    //  one flat array, instead of one row per power of 2. While looking for
+    //  the LCA, most of the jumps aren't taken, and they are read from the
+    //  same node, so they are already in the cache.
+    //
+    // The k-th ancestor is O(1) instead of O(log(n)), using the ladder
+    //  algorithm (Bender and Farach-Colton):
+    //  - The tree is split into long paths: each node continues the path of
+    //    its child with the biggest height.
+    //  - The ladder of a path of h nodes is the path itself, extended upwards
+    //    by up to h ancestors of its top. The ladders take at most 2n entries.
+    //  - Any node of height >= d has a ladder that reaches at least d nodes up,
+    //    since its long path goes at least d nodes down.
+    //  To jump k up from a node, start from the leaf at the bottom of its long
+    //  path instead, which means k' = k + (the distance down to the leaf).
+    //  One jump of 2^i <= k' lands on a node of height >= 2^i, and the
+    //  remaining k' - 2^i < 2^i nodes are read from its ladder.
+    //
+    // The DFS is iterative, so it handles deep trees of 10^7 nodes.
+
+    struct NodeInfo
+    {
+        int depth;
+        // The leaf at the bottom of the long path of the node, and how far down it is.
+        int leaf;
+        int leaf_distance;
+        // The position of the node in the ladder of its own long path.
+        int ladder_position;
+    };
+
+    int levels;
+    std::vector<NodeInfo> info;
+
+    // jumps[node * levels + k] = the (2^k)th ancestor of the node,
+    //  or the root if it's above the root.
+    std::vector<int> jumps;
+
+    std::vector<int> ladders;
+
+    static int log2_floor(int x) {
+        return 31 - __builtin_clz(x);
+    }
+
+    const int* jumps_of(int node) const {
+        return jumps.data() + (size_t)node * levels;
+    }
+
+    void init(const Tree& tree, int root)
+    {
+        int n = tree.size();
+        levels = log2_floor(n) + 1;
+
+        info.resize(n);
+        std::vector<int> parent(n);
+        std::vector<int> order;
+        order.reserve(n);
+
+        parent[root] = root;
+        info[root].depth = 0;
+        std::vector<int> stack = {root};
+        while (!stack.empty())
+        {
+            int node = stack.back();
+            stack.pop_back();
+            order.push_back(node);
+
+            for (int child : tree[node]) {
+                parent[child] = node;
+                info[child].depth = info[node].depth + 1;
+                stack.push_back(child);
+            }
+        }
+
+        // The ancestors of a node come before it in the order, so their jumps
+        //  are ready by the time it needs them. The nodes are filled in batches,
+        //  a power of 2 at a time for the whole batch, so the loads of the nodes
+        //  in a batch don't depend on each other, and can overlap.
+        const int BATCH = 32;
+        jumps.resize((size_t)n * levels);
+        for (int begin = 0; begin < n; begin += BATCH)
+        {
+            int end = std::min(n, begin + BATCH);
+            for (int i = begin; i < end; i++) {
+                jumps[(size_t)order[i] * levels] = parent[order[i]];
+            }
+            for (int k = 1; k < levels; k++) {
+                for (int i = begin; i < end; i++) {
+                    int* row = jumps.data() + (size_t)order[i] * levels;
+                    row[k] = jumps_of(row[k - 1])[k - 1];
+                }
+            }
+        }
+
+        std::vector<int> heights(n, 0);
+        std::vector<int> long_child(n, -1);
+        for (int i = n - 1; i >= 0; i--) {
+            int node = order[i];
+            for (int child : tree[node]) {
+                if (long_child[node] == -1 || heights[child] + 1 > heights[node]) {
+                    heights[node] = heights[child] + 1;
+                    long_child[node] = child;
+                }
+            }
+        }
+
+        ladders.reserve(2 * n);
+        for (int top : order)
+        {
+            if (top != root && long_child[parent[top]] == top)
+                continue;
+
+            int leaf = top;
+            int length = 1;
+            while (long_child[leaf] != -1) {
+                leaf = long_child[leaf];
+                length++;
+            }
+
+            int highest = top;
+            int extension = 0;
+            while (extension < length && highest != root) {
+                highest = parent[highest];
+                extension++;
+            }
+
+            int begin = ladders.size();
+            ladders.resize(begin + extension + length);
+            for (int i = extension - 1, node = parent[top]; i >= 0; i--, node = parent[node]) {
+                ladders[begin + i] = node;
+            }
+            for (int i = extension, node = top; node != -1; i++, node = long_child[node]) {
+                ladders[begin + i] = node;
+                info[node].leaf = leaf;
+                info[node].leaf_distance = length - 1 - (i - extension);
+                info[node].ladder_position = begin + i;
+            }
+        }
+    }
+
+public:
+
+    LowestCommonAncestor(const Tree& tree, int root)
+    {
+        init(tree, root);
+    }
+
+    // Returns -1 if the node has less than k ancestors.
+    int get_kth_ancestor(int node, int k) const
+    {
+        auto& node_info = info[node];
+        if (k == 0)
+            return node;
+        if (k > node_info.depth)
+            return -1;
+
+        k += node_info.leaf_distance;
+        int i = log2_floor(k);
+        int ancestor = jumps_of(node_info.leaf)[i];
+        return ladders[info[ancestor].ladder_position - (k - (1 << i))];
+    }
+
+    int get_LCA(int node1, int node2) const
+    {
+        int depth1 = info[node1].depth;
+        int depth2 = info[node2].depth;
+        if (depth1 < depth2) {
+            std::swap(node1, node2);
+            std::swap(depth1, depth2);
+        }
+
+        node1 = get_kth_ancestor(node1, depth1 - depth2);
+        if (node1 == node2)
+            return node1;
+
+        for (int k = log2_floor(depth2); k >= 0; k--) {
+            int ancestor1 = jumps_of(node1)[k];
+            int ancestor2 = jumps_of(node2)[k];
+            if (ancestor1 != ancestor2) {
+                node1 = ancestor1;
+                node2 = ancestor2;
+            }
+        }
+
+        return jumps_of(node1)[0];
+    }
+
+    int get_depth(int node) const {
+        return info[node].depth;
+    }
+};
+
+// A copy of "Binary Lifting.cpp", used only to compare against.
+int log2_floor(int x)
+{
+    int result = 0;
+    while (x >>= 1) result++;
+    return result;
+}
+
+class BinaryLiftingLCA
+{
+    const Tree& tree;
+
+    std::vector<int> depths;
+
+    // ancestors[k][i] = the
+    //  (2^k)th ancestor of the node i.
+    std::vector<std::vector<int>> ancestors;
+
+    int i, j;
+
+    void dfs(int node, int depth)
+    {
+        depths[node] = depth;
+        for (int child : tree[node]) {
+            ancestors[0][child] = node;
+            dfs(child, depth + 1);
+        }
+    }
+
+    void init_ancestors()
+    {
+        for (int k = 1; k < ancestors.size(); k++) {
+            for (int node = 0; node < tree.size(); node++) {
+                int ancestor = ancestors[k - 1][node];
+                if (ancestor == -1) {
+                    ancestors[k][node] = -1;
+                } else {
+                    ancestors[k][node] = ancestors[k - 1][ancestor];
+                }
+            }
+        }
+    }
+
+    void init(int root)
+    {
+        int n = tree.size();
+        int max_power = log2_floor(n);
+
+        depths.resize(n);
+        ancestors.resize(max_power + 1, std::vector<int>(n));
+
+        ancestors[0][root] = -1;
+        dfs(root, 0);
+
+        init_ancestors();
+    }
+
+    int parent_of(int x) {
+        return ancestors[0][x];
+    }
+
+    void set_at_same_depth()
+    {
+        int diff = depths[j] - depths[i];
+
+        while (diff)
+        {
+            int biggest_power_of_2 = log2_floor(diff);
+            j = ancestors[biggest_power_of_2][j];
+            diff -= (1 << biggest_power_of_2);
+        }
+    }
+
+public:
+
+    // Makes the same jumps as set_at_same_depth.
+    int get_kth_ancestor(int node, int k)
+    {
+        if (k > depths[node])
+            return -1;
+
+        while (k)
+        {
+            int biggest_power_of_2 = log2_floor(k);
+            node = ancestors[biggest_power_of_2][node];
+            k -= (1 << biggest_power_of_2);
+        }
+        return node;
+    }
+
+    int get_LCA(int node1, int node2)
+    {
+        i = node1;
+        j = node2;
+        if (depths[i] > depths[j])
+            std::swap(i, j);
+
+        set_at_same_depth();
+
+        if (i == j)
+            return i;
+
+        int k = log2_floor(depths[i]);
+
+        for (; k >= 0; k--) {
+            if (ancestors[k][i] != ancestors[k][j]) {
+                i = ancestors[k][i];
+                j = ancestors[k][j];
+            }
+        }
+
+        return parent_of(i);
+    }
+
+    BinaryLiftingLCA(const Tree& tree, int root) : tree(tree)
+    {
+        init(root);
+    }
+};
+
+void test(const Tree& tree, int root, const std::vector<std::pair<int, int>>& queries)
+{
+    LowestCommonAncestor lca(tree, root);
+    for (auto& query : queries)
+    {
+        int x = query.first;
+        int y = query.second;
+        std::cout << "LCA of " << x << " and " << y
+                  << " is " << lca.get_LCA(x, y) << std::endl;
+    }
+    std::cout << "The 3rd ancestor of 13 is " << lca.get_kth_ancestor(13, 3) << std::endl;
+    std::cout << std::endl;
+}
+
+Tree get_sample_tree_1()
+{
+    // root = 0
+    Tree tree(14);
+
+    tree[0].push_back(1);
+    tree[0].push_back(2);
+    tree[0].push_back(3);
+
+    tree[1].push_back(4);
+
+    tree[2].push_back(5);
+    tree[2].push_back(6);
+
+    tree[3].push_back(7);
+    tree[3].push_back(8);
+
+    tree[4].push_back(9);
+
+    tree[6].push_back(10);
+
+    tree[8].push_back(11);
+    tree[8].push_back(12);
+
+    tree[9].push_back(13);
+
+    return tree;
+}
+
+std::vector<std::pair<int, int>> get_sample_queries_1()
+{
+    return {
+        {4, 1},
+        {7, 8},
+        {1, 4},
+        {4, 4},
+        {12, 13},
+        {5, 6},
+        {2, 3}
+    };
+}
+
+// The parent of each node is one of the max_back nodes before it
+// (in a random order), so a small max_back gives a deep tree.
+Tree get_random_tree(int n, int max_back, unsigned seed, int& root)
+{
+    std::mt19937 random(seed);
+    std::vector<int> label(n);
+    for (int i = 0; i < n; i++) label[i] = i;
+    std::shuffle(label.begin(), label.end(), random);
+
+    Tree tree(n);
+    for (int i = 1; i < n; i++) {
+        int parent = i - 1 - random() % std::min(i, max_back);
+        tree[label[parent]].push_back(label[i]);
+    }
+    root = label[0];
+    return tree;
+}
+
+std::vector<std::pair<int, int>> get_random_queries(int n, int count, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<std::pair<int, int>> queries(count);
+    for (auto& query : queries) query = {(int)(random() % n), (int)(random() % n)};
+    return queries;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(13);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 1000;
+        int root;
+        auto tree = get_random_tree(n, 1 + random() % n, t, root);
+
+        LowestCommonAncestor lca(tree, root);
+        BinaryLiftingLCA expected(tree, root);
+        for (int i = 0; i < 1000; i++) {
+            int x = random() % n, y = random() % n;
+            int k = random() % (lca.get_depth(x) + 2);
+            if (lca.get_LCA(x, y) != expected.get_LCA(x, y) ||
+                lca.get_kth_ancestor(x, k) != expected.get_kth_ancestor(x, k)) {
+                std::cout << "Wrong answer!" << std::endl;
+                break;
+            }
+        }
+    }
+}
+
+struct TimeResult
+{
+    long long checksum;
+    long long ms;
+};
+
+template <typename Function>
+TimeResult measure(Function function, int count)
+{
+    long long checksum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; i++) checksum += function(i);
+    auto end = std::chrono::high_resolution_clock::now();
+    return {checksum, std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()};
+}
+
+void print_result(const std::string& name, TimeResult result, int count)
+{
+    std::cout << name << ": " << result.ms << " ms, "
+              << (double)count / std::max<long long>(result.ms, 1) / 1000 << "M queries per second" << std::endl;
+}
+
+template <typename LCA>
+std::pair<TimeResult, TimeResult> time_lca(const std::string& name, const Tree& tree, int root,
+                                           const std::vector<std::pair<int, int>>& queries, const std::vector<int>& ks)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    LCA lca(tree, root);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << name << ": " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms to build" << std::endl;
+
+    int count = queries.size();
+    auto lca_result = measure([&](int i) { return lca.get_LCA(queries[i].first, queries[i].second); }, count);
+    print_result("  LCA", lca_result, count);
+    auto kth_result = measure([&](int i) { return lca.get_kth_ancestor(queries[i].first, ks[i]); }, count);
+    print_result("  k-th ancestor", kth_result, count);
+    return {lca_result, kth_result};
+}
+
+void time_test(int n, int max_back, int queries_count, bool run_original)
+{
+    int root;
+    auto tree = get_random_tree(n, max_back, n, root);
+    auto queries = get_random_queries(n, queries_count, n);
+    std::cout << "n = " << n << ", parents up to " << max_back << " nodes back, "
+              << queries_count << " queries" << std::endl;
+
+    std::vector<int> ks(queries_count);
+    {
+        LowestCommonAncestor lca(tree, root);
+        std::mt19937 random(n);
+        for (int i = 0; i < queries_count; i++) ks[i] = random() % (lca.get_depth(queries[i].first) + 1);
+    }
+
+    auto results = time_lca<LowestCommonAncestor>("Node-major + ladders", tree, root, queries, ks);
+    if (run_original) {
+        auto expected = time_lca<BinaryLiftingLCA>("Binary lifting", tree, root, queries, ks);
+        if (results.first.checksum != expected.first.checksum || results.second.checksum != expected.second.checksum)
+            std::cout << "Wrong answer!" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test(get_sample_tree_1(), 0, get_sample_queries_1());
+    random_test(300);
+
+    time_test(1'000'000, 1'000'000, 10'000'000, true);
+    time_test(1'000'000, 100, 10'000'000, true);
+    // The original's recursive DFS overflows the stack on this one.
+    time_test(10'000'000, 2, 10'000'000, false);
+}
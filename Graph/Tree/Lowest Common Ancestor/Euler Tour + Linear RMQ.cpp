@@ -0,0 +1,773 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+typedef std::vector<std::vector<int>> Tree;
+
+class LowestCommonAncestor
+{
+    // O(1) per query, like "Euler Tour + Sparse Table.cpp", but with O(n) memory.
+    //
+    // The tour is replaced by the preorder (each node once instead of the
+    // 2n - 1 entries of the Euler tour). For two different nodes x and y, with
+    // x before y in the preorder, the range (position[x], position[y]] holds
+    // y and a part of every subtree hanging from the path from the LCA down to y,
+    // and the highest of the nodes there is a child of the LCA. So, if each
+    // position holds the position of the parent of its node, the LCA is the
+    // node at the minimum of these values over the range.
+    //
+    // The range minimum is answered in O(1) with O(n) memory:
+    //  - The positions are split into blocks of 64, and a sparse table is built
+    //    over the minimum of each block, which takes (n / 64) * log(n / 64) ints.
+    //  - Inside a block, masks[i] has a bit for each position j <= i of the block
+    //    with values[j] < all the values in (j, i]. These are the positions
+    //    left on a monotonic stack after pushing i, so they're built in O(n).
+    //    The minimum of [l, r] inside a block is then the lowest bit of
+    //    masks[r] that is >= l.
+    //  - A range over more than one block is the suffix of the first block,
+    //    the prefix of the last, and the blocks between them. The minimums of
+    //    the prefixes and the suffixes of the blocks are kept too, so all the
+    //    loads of such a query are independent of each other, which matters
+    //    more than their count when they all miss the cache.
+    // A query is then either one in-block lookup, or four independent loads.
+    //
+    // The DFS is iterative, so deep trees don't overflow the stack.
+
+    static const int BLOCK = 64;
+
+    std::vector<int> order;     // The node at each position of the preorder.
+    std::vector<int> position;  // The position of each node.
+    std::vector<int> values;    // The position of the parent of the node at each position.
+    std::vector<uint64_t> masks;
+    std::vector<int> prefix_minimums;
+    std::vector<int> suffix_minimums;
+
+    // block_minimums[k][b] = the minimum of the values of the blocks [b, b + 2^k).
+    std::vector<std::vector<int>> block_minimums;
+
+    static int log2_floor(int x) {
+        return 31 - __builtin_clz(x);
+    }
+
+    void init_order(const Tree& tree, int root)
+    {
+        int n = tree.size();
+        order.resize(n);
+        position.resize(n);
+        values.resize(n);
+
+        struct StackFrame
+        {
+            int node;
+            int parent_position;
+        };
+        std::vector<StackFrame> stack = {{root, 0}};
+
+        int current = 0;
+        while (!stack.empty())
+        {
+            auto frame = stack.back();
+            stack.pop_back();
+
+            order[current] = frame.node;
+            position[frame.node] = current;
+            values[current] = frame.parent_position;
+
+            for (int child : tree[frame.node])
+                stack.push_back({child, current});
+            current++;
+        }
+    }
+
+    void init_masks()
+    {
+        int n = values.size();
+        masks.resize(n);
+
+        for (int start = 0; start < n; start += BLOCK)
+        {
+            uint64_t stack = 0;
+            for (int i = start; i < std::min(n, start + BLOCK); i++)
+            {
+                while (stack) {
+                    int top = 63 - __builtin_clzll(stack);
+                    if (values[start + top] < values[i]) break;
+                    stack ^= 1ULL << top;
+                }
+                stack |= 1ULL << (i - start);
+                masks[i] = stack;
+            }
+        }
+    }
+
+    void init_block_minimums()
+    {
+        int n = values.size();
+        int blocks = (n + BLOCK - 1) / BLOCK;
+
+        prefix_minimums.resize(n);
+        suffix_minimums.resize(n);
+        for (int i = 0; i < n; i++) {
+            prefix_minimums[i] = (i % BLOCK) ? std::min(prefix_minimums[i - 1], values[i]) : values[i];
+        }
+        for (int i = n - 1; i >= 0; i--) {
+            suffix_minimums[i] = (i % BLOCK != BLOCK - 1 && i + 1 < n) ? std::min(suffix_minimums[i + 1], values[i]) : values[i];
+        }
+
+        block_minimums.resize(log2_floor(blocks) + 1);
+        block_minimums[0].resize(blocks);
+        for (int b = 0; b < blocks; b++) {
+            int end = std::min(n, (b + 1) * BLOCK) - 1;
+            block_minimums[0][b] = prefix_minimums[end];
+        }
+
+        for (int k = 1; k < (int)block_minimums.size(); k++) {
+            auto& previous = block_minimums[k - 1];
+            block_minimums[k].resize(blocks - (1 << k) + 1);
+            for (int b = 0; b + (1 << k) <= blocks; b++) {
+                block_minimums[k][b] = std::min(previous[b], previous[b + (1 << (k - 1))]);
+            }
+        }
+    }
+
+    // The minimum of the values in [l, r], both in the same block.
+    int block_minimum(int l, int r) const
+    {
+        int start = r & ~(BLOCK - 1);
+        uint64_t mask = masks[r] & (~0ULL << (l - start));
+        return values[start + __builtin_ctzll(mask)];
+    }
+
+    int range_minimum(int l, int r) const
+    {
+        int left_block = l / BLOCK;
+        int right_block = r / BLOCK;
+        if (left_block == right_block)
+            return block_minimum(l, r);
+
+        int result = std::min(suffix_minimums[l], prefix_minimums[r]);
+
+        if (left_block + 1 < right_block) {
+            int k = log2_floor(right_block - left_block - 1);
+            result = std::min(result, block_minimums[k][left_block + 1]);
+            result = std::min(result, block_minimums[k][right_block - (1 << k)]);
+        }
+
+        return result;
+    }
+
+public:
+
+    LowestCommonAncestor(const Tree& tree, int root)
+    {
+        init_order(tree, root);
+        init_masks();
+        init_block_minimums();
+    }
+
+    int get_LCA(int node1, int node2) const
+    {
+        if (node1 == node2)
+            return node1;
+
+        int l = position[node1];
+        int r = position[node2];
+        if (l > r) std::swap(l, r);
+
+        return order[range_minimum(l + 1, r)];
+    }
+
+    // The memory used by the structure, without the tree.
+    size_t memory_bytes() const
+    {
+        size_t bytes = (order.size() + position.size() + values.size()) * sizeof(int) + masks.size() * sizeof(uint64_t);
+        bytes += (prefix_minimums.size() + suffix_minimums.size()) * sizeof(int);
+        for (auto& level : block_minimums) bytes += level.size() * sizeof(int);
+        return bytes;
+    }
+};
+
+// A copy of "Tarjan Offline.cpp", used only to compare against.
+class OfflineLowestCommonAncestor
+{
+    const Tree& tree;
+    int root;
+
+    std::vector<int> set_parent;
+
+    int find(int x)
+    {
+        while (set_parent[x] != x) {
+            set_parent[x] = set_parent[set_parent[x]];
+            x = set_parent[x];
+        }
+        return x;
+    }
+
+public:
+
+    OfflineLowestCommonAncestor(const Tree& tree, int root) : tree(tree), root(root) {}
+
+    std::vector<int> get_LCAs(const std::vector<std::pair<int, int>>& queries)
+    {
+        int n = tree.size();
+        int q = queries.size();
+
+        // The queries of each node, both as the first and the second node.
+        struct QueryEntry
+        {
+            int other;
+            int index;
+        };
+        std::vector<int> offsets(n + 1, 0);
+        for (auto& query : queries) {
+            offsets[query.first + 1]++;
+            offsets[query.second + 1]++;
+        }
+        for (int i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+        std::vector<QueryEntry> entries(2 * q);
+        std::vector<int> position(offsets.begin(), offsets.end() - 1);
+        for (int i = 0; i < q; i++) {
+            entries[position[queries[i].first]++] = {queries[i].second, i};
+            entries[position[queries[i].second]++] = {queries[i].first, i};
+        }
+
+        set_parent.resize(n);
+        for (int i = 0; i < n; i++) set_parent[i] = i;
+        std::vector<char> finished(n, false);
+        std::vector<int> answers(q);
+
+        struct StackFrame
+        {
+            int node;
+            int parent;
+            int next_child;
+        };
+        std::vector<StackFrame> stack;
+        stack.push_back({root, -1, 0});
+
+        while (!stack.empty())
+        {
+            auto& frame = stack.back();
+            int node = frame.node;
+
+            if (frame.next_child < (int)tree[node].size()) {
+                int child = tree[node][frame.next_child++];
+                stack.push_back({child, node, 0});
+                continue;
+            }
+
+            finished[node] = true;
+            for (int i = offsets[node]; i < offsets[node + 1]; i++) {
+                if (finished[entries[i].other])
+                    answers[entries[i].index] = find(entries[i].other);
+            }
+            if (frame.parent != -1) set_parent[node] = frame.parent;
+            stack.pop_back();
+        }
+
+        return answers;
+    }
+};
+
+// A copy of "Binary Lifting.cpp", used only to compare against.
+int log2_floor(int x)
+{
+    int result = 0;
+    while (x >>= 1) result++;
+    return result;
+}
+
+class BinaryLiftingLCA
+{
+    const Tree& tree;
+
+    std::vector<int> depths;
+
+    // ancestors[k][i] = the
+    //  (2^k)th ancestor of the node i.
+    std::vector<std::vector<int>> ancestors;
+
+    int i, j;
+
+    void dfs(int node, int depth)
+    {
+        depths[node] = depth;
+        for (int child : tree[node]) {
+            ancestors[0][child] = node;
+            dfs(child, depth + 1);
+        }
+    }
+
+    void init_ancestors()
+    {
+        for (int k = 1; k < ancestors.size(); k++) {
+            for (int node = 0; node < tree.size(); node++) {
+                int ancestor = ancestors[k - 1][node];
+                if (ancestor == -1) {
+                    ancestors[k][node] = -1;
+                } else {
+                    ancestors[k][node] = ancestors[k - 1][ancestor];
+                }
+            }
+        }
+    }
+
+    void init(int root)
+    {
+        int n = tree.size();
+        int max_power = log2_floor(n);
+
+        depths.resize(n);
+        ancestors.resize(max_power + 1, std::vector<int>(n));
+
+        ancestors[0][root] = -1;
+        dfs(root, 0);
+
+        init_ancestors();
+    }
+
+    int parent_of(int x) {
+        return ancestors[0][x];
+    }
+
+    void set_at_same_depth()
+    {
+        int diff = depths[j] - depths[i];
+
+        while (diff)
+        {
+            int biggest_power_of_2 = log2_floor(diff);
+            j = ancestors[biggest_power_of_2][j];
+            diff -= (1 << biggest_power_of_2);
+        }
+    }
+
+public:
+
+    int get_LCA(int node1, int node2)
+    {
+        i = node1;
+        j = node2;
+        if (depths[i] > depths[j])
+            std::swap(i, j);
+
+        set_at_same_depth();
+
+        if (i == j)
+            return i;
+
+        int k = log2_floor(depths[i]);
+
+        for (; k >= 0; k--) {
+            if (ancestors[k][i] != ancestors[k][j]) {
+                i = ancestors[k][i];
+                j = ancestors[k][j];
+            }
+        }
+
+        return parent_of(i);
+    }
+
+    BinaryLiftingLCA(const Tree& tree, int root) : tree(tree)
+    {
+        init(root);
+    }
+};
+
+// A copy of "Euler Tour + Sparse Table.cpp", used only to compare against.
+template <typename T, typename functor, bool is_overlap_friendly, bool is_indexable, bool precompute_log = true>
+class SparseTable
+{
+    int n;
+    int max_depth; // floor(log2(n))
+    functor function;
+
+    std::vector<std::vector<T>> table;
+
+    // Used to get the index of the result element.
+    //  In other words, this is a reverse mapping
+    //  of the table. THIS IS USED WITH FUNCTIONS
+    //  LIKE MIN, MAX, ..., BUT NOT GCD, SUM, ...
+    //  We'll call this kind of functions
+    //  "indexable functions".
+    std::vector<std::vector<int>> index;
+
+    // Used to compute floor(log2(i))
+    //  in O(1) for any index i <= n.
+    std::vector<int> log2floor;
+
+    void resize_table(std::vector<std::vector<T>>& table) {
+        table.resize(max_depth + 1, std::vector<T>(n));
+    }
+
+    int compute_log2_floor(int x)
+    {
+        // We won't get x = 0 since there is no 0 length.
+        int result = 0;
+        while (x >>= 1) result++;
+        return result;
+    }
+
+    int log2_floor(int x)
+    {
+        if (precompute_log)
+            return log2floor[x];
+        return compute_log2_floor(x);
+    }
+
+    void init_table()
+    {
+        for (int depth = 1; depth <= max_depth; depth++)
+        {
+            int range = 1 << depth;
+
+            // We check for the element at index
+            //  i + range - 1 being withing the
+            //  bounds of the array. We don't need
+            // This is equivalent to i + range - 1 < n.
+            for (int i = 0; i + range <= n; i++)
+            {
+                int prev_depth = depth - 1;
+                int prev_range = (1 << prev_depth);
+
+                T left = table[prev_depth][i];
+                T right = table[prev_depth][i + prev_range];
+                table[depth][i] = function(left, right);
+
+                if (is_indexable) {
+                    index[depth][i] =
+                            (table[depth][i] == left) ?
+                            index[prev_depth][i] :
+                            index[prev_depth][i + prev_range];
+                }
+            }
+        }
+    }
+
+    void init(const std::vector<T>& arr)
+    {
+        n = arr.size();
+
+        if (precompute_log) {
+            log2floor.resize(n + 1);
+            for (int i = 2; i <= n; i++)
+                log2floor[i] = log2floor[i / 2] + 1;
+        }
+
+        max_depth = log2_floor(n);
+
+        resize_table(table);
+        if (is_indexable)
+            resize_table(index);
+
+        for (int i = 0; i < n; i++) {
+            table[0][i] = arr[i];
+            if (is_indexable)
+                index[0][i] = i;
+        }
+
+        init_table();
+    }
+
+    T query_o1(int l, int r)
+    {
+        int len = r - l + 1;
+        int depth = log2_floor(len);
+        int range = 1 << depth;
+        T left = table[depth][l];
+        T right = table[depth][r - range + 1];
+        return function(left, right);
+    }
+
+    T query_ologn(int l, int r)
+    {
+        int len = r - l + 1;
+        int depth = log2_floor(len);
+        int range = 1 << depth;
+
+        T result = table[depth][l];
+        l += range;
+
+        while (l <= r)
+        {
+            len = r - l + 1;
+            depth = log2_floor(len);
+            range = 1 << depth;
+
+            result = function(result, table[depth][l]);
+            l += range;
+        }
+
+        return result;
+    }
+
+public:
+
+    SparseTable() = default;
+    SparseTable(const std::vector<T>& arr)
+    {
+        init(arr);
+    }
+
+    void set_array(const std::vector<T>& arr)
+    {
+        init(arr);
+    }
+
+    T query(int l, int r)
+    {
+        return (is_overlap_friendly ? query_o1(l, r) : query_ologn(l, r));
+    }
+
+    int query_index(int l, int r)
+    {
+        static_assert(is_indexable, "This type of sparse table is not indexable.");
+
+        int len = r - l + 1;
+        int depth = log2_floor(len);
+        int range = 1 << depth;
+
+        r = r - range + 1;
+
+        T left = table[depth][l];
+        T right = table[depth][r];
+
+        if (function(left, right) == left)
+            return index[depth][l];
+        return index[depth][r];
+    }
+};
+
+template <typename T>
+struct min
+{
+    T operator()(const T& a, const T& b) { return std::min(a, b); }
+};
+
+typedef SparseTable<int, min<int>, true , true> MinSparseTable;
+
+class EulerTourLCA
+{
+    const Tree& tree;
+
+    // Stores the depth of
+    // each node in the tree.
+    std::vector<int> depths;
+
+    std::vector<int> tour;
+
+    // We can use any occurrence, but
+    // the last is convenient to compute.
+    std::vector<int> last_occurrence;
+
+    MinSparseTable sparse_table;
+
+    void construct_tour(int node, int depth)
+    {
+        tour.push_back(node);
+        depths.push_back(depth);
+        for (int child : tree[node]) {
+            construct_tour(child, depth + 1);
+            tour.push_back(node);
+            depths.push_back(depth);
+        }
+    };
+
+    void set_last_occurrence()
+    {
+        last_occurrence.resize(tree.size());
+
+        for (int i = 0; i < tour.size(); i++)
+            last_occurrence[tour[i]] = i;
+    }
+
+    void set_sparse_table() {
+        sparse_table.set_array(depths);
+    }
+
+    void init(int root)
+    {
+        construct_tour(root, 0);
+        set_last_occurrence();
+        set_sparse_table();
+    }
+
+public:
+
+    EulerTourLCA(const Tree& tree, int root) : tree(tree)
+    {
+        init(root);
+    }
+
+    int get_LCA(int node1, int node2)
+    {
+        int l = last_occurrence[node1];
+        int r = last_occurrence[node2];
+        if (l > r) std::swap(l, r);
+        int index = sparse_table.query_index(l, r);
+        return tour[index];
+    }
+};
+
+void test(const Tree& tree, int root, const std::vector<std::pair<int, int>>& queries)
+{
+    LowestCommonAncestor lca(tree, root);
+    for (auto& query : queries)
+    {
+        int x = query.first;
+        int y = query.second;
+        std::cout << "LCA of " << x << " and " << y
+                  << " is " << lca.get_LCA(x, y) << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+Tree get_sample_tree_1()
+{
+    // root = 0
+    Tree tree(14);
+
+    tree[0].push_back(1);
+    tree[0].push_back(2);
+    tree[0].push_back(3);
+
+    tree[1].push_back(4);
+
+    tree[2].push_back(5);
+    tree[2].push_back(6);
+
+    tree[3].push_back(7);
+    tree[3].push_back(8);
+
+    tree[4].push_back(9);
+
+    tree[6].push_back(10);
+
+    tree[8].push_back(11);
+    tree[8].push_back(12);
+
+    tree[9].push_back(13);
+
+    return tree;
+}
+
+std::vector<std::pair<int, int>> get_sample_queries_1()
+{
+    return {
+        {4, 1},
+        {7, 8},
+        {1, 4},
+        {4, 4},
+        {12, 13},
+        {5, 6},
+        {2, 3}
+    };
+}
+
+// The parent of each node is one of the max_back nodes before it
+// (in a random order), so a small max_back gives a deep tree.
+Tree get_random_tree(int n, int max_back, unsigned seed, int& root)
+{
+    std::mt19937 random(seed);
+    std::vector<int> label(n);
+    for (int i = 0; i < n; i++) label[i] = i;
+    std::shuffle(label.begin(), label.end(), random);
+
+    Tree tree(n);
+    for (int i = 1; i < n; i++) {
+        int parent = i - 1 - random() % std::min(i, max_back);
+        tree[label[parent]].push_back(label[i]);
+    }
+    root = label[0];
+    return tree;
+}
+
+std::vector<std::pair<int, int>> get_random_queries(int n, int count, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<std::pair<int, int>> queries(count);
+    for (auto& query : queries) query = {(int)(random() % n), (int)(random() % n)};
+    return queries;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(7);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 1000;
+        int root;
+        auto tree = get_random_tree(n, 1 + random() % n, t, root);
+        auto queries = get_random_queries(n, random() % 1000, t);
+
+        LowestCommonAncestor lca(tree, root);
+        BinaryLiftingLCA expected(tree, root);
+        for (auto& query : queries) {
+            if (lca.get_LCA(query.first, query.second) != expected.get_LCA(query.first, query.second)) {
+                std::cout << "Wrong LCA!" << std::endl;
+                break;
+            }
+        }
+    }
+}
+
+template <typename LCA>
+std::vector<int> time_online(const std::string& name, const Tree& tree, int root, const std::vector<std::pair<int, int>>& queries)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    LCA lca(tree, root);
+    auto middle = std::chrono::high_resolution_clock::now();
+
+    std::vector<int> answers(queries.size());
+    for (int i = 0; i < (int)queries.size(); i++) {
+        answers[i] = lca.get_LCA(queries[i].first, queries[i].second);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto build_ms = std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count();
+    auto query_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - middle).count();
+    std::cout << name << ": " << build_ms << " ms to build, " << query_ms << " ms, "
+              << (double)queries.size() / std::max<long long>(query_ms, 1) / 1000 << "M queries per second" << std::endl;
+    return answers;
+}
+
+void time_test(int n, int max_back, int queries_count)
+{
+    int root;
+    auto tree = get_random_tree(n, max_back, n, root);
+    auto queries = get_random_queries(n, queries_count, n);
+    std::cout << "n = " << n << ", parents up to " << max_back << " nodes back, "
+              << queries_count << " queries" << std::endl;
+
+    auto expected = time_online<LowestCommonAncestor>("Linear RMQ", tree, root, queries);
+    std::cout << "  (" << LowestCommonAncestor(tree, root).memory_bytes() / (1 << 20) << " MB)" << std::endl;
+
+    bool wrong = false;
+    wrong |= time_online<BinaryLiftingLCA>("Binary lifting", tree, root, queries) != expected;
+    wrong |= time_online<EulerTourLCA>("Euler tour + sparse table", tree, root, queries) != expected;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto answers = OfflineLowestCommonAncestor(tree, root).get_LCAs(queries);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Tarjan offline: " << ms << " ms including the build, "
+              << (double)queries_count / std::max<long long>(ms, 1) / 1000 << "M queries per second" << std::endl;
+    wrong |= answers != expected;
+
+    if (wrong) std::cout << "Wrong LCA!" << std::endl;
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test(get_sample_tree_1(), 0, get_sample_queries_1());
+    random_test(300);
+
+    time_test(1'000'000, 1'000'000, 10'000'000);
+    time_test(1'000'000, 100, 10'000'000);
+}
@@ -0,0 +1,354 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+typedef std::vector<std::vector<int>> Tree;
+
+class OfflineLowestCommonAncestor
+{
+    // Tarjan's offline algorithm: all the queries are known in advance,
+    // and they're all answered in a single DFS over the tree.
+    //
+    // When a node is finished (all its subtree is done), it's merged
+    // into the set of its parent in a union-find. This means that while
+    // node u is being finished, the set of any finished node v is rooted
+    // at the highest node of the path from v up to the current path from
+    // the root to u, which is exactly the LCA of u and v. Each query is
+    // answered when the second of its two nodes is finished.
+    //
+    // The set of a finished child is always attached to its parent, which
+    // is still on the DFS path, so the root of each set is the node we're
+    // looking for, and no separate ancestor array or union by rank is
+    // needed. The find uses path halving.
+    //
+    // The DFS is iterative, so deep trees don't overflow the stack, and the
+    // queries are grouped by node in a flat array instead of a vector per node.
+
+    const Tree& tree;
+    int root;
+
+    std::vector<int> set_parent;
+
+    int find(int x)
+    {
+        while (set_parent[x] != x) {
+            set_parent[x] = set_parent[set_parent[x]];
+            x = set_parent[x];
+        }
+        return x;
+    }
+
+public:
+
+    OfflineLowestCommonAncestor(const Tree& tree, int root) : tree(tree), root(root) {}
+
+    std::vector<int> get_LCAs(const std::vector<std::pair<int, int>>& queries)
+    {
+        int n = tree.size();
+        int q = queries.size();
+
+        // The queries of each node, both as the first and the second node.
+        struct QueryEntry
+        {
+            int other;
+            int index;
+        };
+        std::vector<int> offsets(n + 1, 0);
+        for (auto& query : queries) {
+            offsets[query.first + 1]++;
+            offsets[query.second + 1]++;
+        }
+        for (int i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+        std::vector<QueryEntry> entries(2 * q);
+        std::vector<int> position(offsets.begin(), offsets.end() - 1);
+        for (int i = 0; i < q; i++) {
+            entries[position[queries[i].first]++] = {queries[i].second, i};
+            entries[position[queries[i].second]++] = {queries[i].first, i};
+        }
+
+        set_parent.resize(n);
+        for (int i = 0; i < n; i++) set_parent[i] = i;
+        std::vector<char> finished(n, false);
+        std::vector<int> answers(q);
+
+        struct StackFrame
+        {
+            int node;
+            int parent;
+            int next_child;
+        };
+        std::vector<StackFrame> stack;
+        stack.push_back({root, -1, 0});
+
+        while (!stack.empty())
+        {
+            auto& frame = stack.back();
+            int node = frame.node;
+
+            if (frame.next_child < (int)tree[node].size()) {
+                int child = tree[node][frame.next_child++];
+                stack.push_back({child, node, 0});
+                continue;
+            }
+
+            finished[node] = true;
+            for (int i = offsets[node]; i < offsets[node + 1]; i++) {
+                if (finished[entries[i].other])
+                    answers[entries[i].index] = find(entries[i].other);
+            }
+            if (frame.parent != -1) set_parent[node] = frame.parent;
+            stack.pop_back();
+        }
+
+        return answers;
+    }
+};
+
+// A copy of "Binary Lifting.cpp", used only to compare against.
+int log2_floor(int x)
+{
+    int result = 0;
+    while (x >>= 1) result++;
+    return result;
+}
+
+class LowestCommonAncestor
+{
+    const Tree& tree;
+
+    std::vector<int> depths;
+
+    // ancestors[k][i] = the
+    //  (2^k)th ancestor of the node i.
+    std::vector<std::vector<int>> ancestors;
+
+    int i, j;
+
+    void dfs(int node, int depth)
+    {
+        depths[node] = depth;
+        for (int child : tree[node]) {
+            ancestors[0][child] = node;
+            dfs(child, depth + 1);
+        }
+    }
+
+    void init_ancestors()
+    {
+        for (int k = 1; k < ancestors.size(); k++) {
+            for (int node = 0; node < tree.size(); node++) {
+                int ancestor = ancestors[k - 1][node];
+                if (ancestor == -1) {
+                    ancestors[k][node] = -1;
+                } else {
+                    ancestors[k][node] = ancestors[k - 1][ancestor];
+                }
+            }
+        }
+    }
+
+    void init(int root)
+    {
+        int n = tree.size();
+        int max_power = log2_floor(n);
+
+        depths.resize(n);
+        ancestors.resize(max_power + 1, std::vector<int>(n));
+
+        ancestors[0][root] = -1;
+        dfs(root, 0);
+
+        init_ancestors();
+    }
+
+    int parent_of(int x) {
+        return ancestors[0][x];
+    }
+
+    void set_at_same_depth()
+    {
+        int diff = depths[j] - depths[i];
+
+        while (diff)
+        {
+            int biggest_power_of_2 = log2_floor(diff);
+            j = ancestors[biggest_power_of_2][j];
+            diff -= (1 << biggest_power_of_2);
+        }
+    }
+
+public:
+
+    int get_LCA(int node1, int node2)
+    {
+        i = node1;
+        j = node2;
+        if (depths[i] > depths[j])
+            std::swap(i, j);
+
+        set_at_same_depth();
+
+        if (i == j)
+            return i;
+
+        int k = log2_floor(depths[i]);
+
+        for (; k >= 0; k--) {
+            if (ancestors[k][i] != ancestors[k][j]) {
+                i = ancestors[k][i];
+                j = ancestors[k][j];
+            }
+        }
+
+        return parent_of(i);
+    }
+
+    LowestCommonAncestor(const Tree& tree, int root) : tree(tree)
+    {
+        init(root);
+    }
+};
+
+void test(const Tree& tree, int root, const std::vector<std::pair<int, int>>& queries)
+{
+    OfflineLowestCommonAncestor lca(tree, root);
+    auto answers = lca.get_LCAs(queries);
+    for (int i = 0; i < queries.size(); i++)
+    {
+        int x = queries[i].first;
+        int y = queries[i].second;
+        std::cout << "LCA of " << x << " and " << y
+                  << " is " << answers[i] << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+Tree get_sample_tree_1()
+{
+    // root = 0
+    Tree tree(14);
+
+    tree[0].push_back(1);
+    tree[0].push_back(2);
+    tree[0].push_back(3);
+
+    tree[1].push_back(4);
+
+    tree[2].push_back(5);
+    tree[2].push_back(6);
+
+    tree[3].push_back(7);
+    tree[3].push_back(8);
+
+    tree[4].push_back(9);
+
+    tree[6].push_back(10);
+
+    tree[8].push_back(11);
+    tree[8].push_back(12);
+
+    tree[9].push_back(13);
+
+    return tree;
+}
+
+std::vector<std::pair<int, int>> get_sample_queries_1()
+{
+    return {
+        {4, 1},
+        {7, 8},
+        {1, 4},
+        {4, 4},
+        {12, 13},
+        {5, 6},
+        {2, 3}
+    };
+}
+
+// The parent of each node is one of the max_back nodes before it
+// (in a random order), so a small max_back gives a deep tree.
+Tree get_random_tree(int n, int max_back, unsigned seed, int& root)
+{
+    std::mt19937 random(seed);
+    std::vector<int> label(n);
+    for (int i = 0; i < n; i++) label[i] = i;
+    std::shuffle(label.begin(), label.end(), random);
+
+    Tree tree(n);
+    for (int i = 1; i < n; i++) {
+        int parent = i - 1 - random() % std::min(i, max_back);
+        tree[label[parent]].push_back(label[i]);
+    }
+    root = label[0];
+    return tree;
+}
+
+std::vector<std::pair<int, int>> get_random_queries(int n, int count, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<std::pair<int, int>> queries(count);
+    for (auto& query : queries) query = {(int)(random() % n), (int)(random() % n)};
+    return queries;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(5);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 300;
+        int root;
+        auto tree = get_random_tree(n, 1 + random() % n, t, root);
+        auto queries = get_random_queries(n, random() % 500, t);
+
+        LowestCommonAncestor expected(tree, root);
+        auto answers = OfflineLowestCommonAncestor(tree, root).get_LCAs(queries);
+        for (int i = 0; i < queries.size(); i++) {
+            if (answers[i] != expected.get_LCA(queries[i].first, queries[i].second)) {
+                std::cout << "Wrong LCA!" << std::endl;
+                break;
+            }
+        }
+    }
+}
+
+void time_test(int n, int max_back, int queries_count)
+{
+    int root;
+    auto tree = get_random_tree(n, max_back, n, root);
+    auto queries = get_random_queries(n, queries_count, n);
+    std::cout << "n = " << n << ", parents up to " << max_back << " nodes back, "
+              << queries_count << " queries" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto answers = OfflineLowestCommonAncestor(tree, root).get_LCAs(queries);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Tarjan offline: " << ms << " ms, "
+              << (double)queries_count / ms / 1000 << "M queries per second" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    LowestCommonAncestor lca(tree, root);
+    long long wrong = 0;
+    for (int i = 0; i < queries_count; i++) {
+        wrong += lca.get_LCA(queries[i].first, queries[i].second) != answers[i];
+    }
+    end = std::chrono::high_resolution_clock::now();
+    ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Binary lifting: " << ms << " ms, "
+              << (double)queries_count / ms / 1000 << "M queries per second" << std::endl;
+
+    if (wrong) std::cout << "Wrong LCA!" << std::endl;
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test(get_sample_tree_1(), 0, get_sample_queries_1());
+    random_test(300);
+
+    time_test(1'000'000, 1'000'000, 10'000'000);
+    time_test(1'000'000, 100, 10'000'000);
+}
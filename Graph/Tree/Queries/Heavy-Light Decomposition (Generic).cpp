@@ -0,0 +1,939 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <climits>
+
+const int MAX_VALUE = INT_MAX;
+
+typedef std::vector<std::vector<int>> Tree;
+
+// The segment tree below works with any pair of a monoid of values and a
+// monoid of updates that act on them (a policy):
+//  - combine is associative, and identity is its neutral value.
+//  - apply(value, update) is the value after the update, and has to
+//    distribute over combine: apply(combine(a, b), u) = combine(apply(a, u), apply(b, u)).
+//  - compose(newer, older) is a single update that does older, then newer,
+//    and no_update is the update that changes nothing.
+// The path queries go up from both ends of the path, so they also need
+// combine to be commutative (min, max, sum, xor, gcd, ...). The subtree
+// queries don't.
+
+struct MinAdd
+{
+    typedef long long Value;
+    typedef long long Update;
+    static Value identity() { return LLONG_MAX; }
+    static Value combine(Value a, Value b) { return std::min(a, b); }
+    static Update no_update() { return 0; }
+    static Value apply(Value value, Update update) { return value == LLONG_MAX ? value : value + update; }
+    static Update compose(Update newer, Update older) { return newer + older; }
+};
+
+struct SumAdd
+{
+    // The length is kept in the value, so an addition knows how many values it adds to.
+    struct Value
+    {
+        long long sum;
+        int length;
+    };
+    typedef long long Update;
+    static Value identity() { return {0, 0}; }
+    static Value combine(Value a, Value b) { return {a.sum + b.sum, a.length + b.length}; }
+    static Update no_update() { return 0; }
+    static Value apply(Value value, Update update) { return {value.sum + update * value.length, value.length}; }
+    static Update compose(Update newer, Update older) { return newer + older; }
+};
+
+struct MaxAssign
+{
+    // LLONG_MIN as an update means no assignment.
+    typedef long long Value;
+    typedef long long Update;
+    static Value identity() { return LLONG_MIN; }
+    static Value combine(Value a, Value b) { return std::max(a, b); }
+    static Update no_update() { return LLONG_MIN; }
+    static Value apply(Value value, Update update) { return update == LLONG_MIN ? value : update; }
+    static Update compose(Update newer, Update older) { return newer == LLONG_MIN ? older : newer; }
+};
+
+template <typename Policy>
+class LazySegmentTree
+{
+    // Iterative (bottom-up), with the size rounded up to a power of 2.
+    //  The node k has the children 2k and 2k + 1, and the leaves start
+    //  at size. Before touching a range, the pending updates on the paths
+    //  from its two ends up to the root are pushed down, and after an
+    //  update, the values on these paths are recomputed. Everything in
+    //  between is a whole node, so there's no recursion.
+
+    typedef typename Policy::Value Value;
+    typedef typename Policy::Update Update;
+
+    int n;
+    int log;
+    int size;
+    std::vector<Value> values;
+    std::vector<Update> pending;
+
+    void pull(int k) {
+        values[k] = Policy::combine(values[2 * k], values[2 * k + 1]);
+    }
+
+    void apply_to(int k, const Update& update)
+    {
+        values[k] = Policy::apply(values[k], update);
+        if (k < size) pending[k] = Policy::compose(update, pending[k]);
+    }
+
+    void push(int k)
+    {
+        apply_to(2 * k, pending[k]);
+        apply_to(2 * k + 1, pending[k]);
+        pending[k] = Policy::no_update();
+    }
+
+    void push_ends(int l, int r)
+    {
+        for (int i = log; i >= 1; i--) {
+            if (((l >> i) << i) != l) push(l >> i);
+            if (((r >> i) << i) != r) push((r - 1) >> i);
+        }
+    }
+
+public:
+
+    explicit LazySegmentTree(const std::vector<Value>& array) : n(array.size())
+    {
+        log = 0;
+        while ((1 << log) < n) log++;
+        size = 1 << log;
+
+        values.assign(2 * size, Policy::identity());
+        pending.assign(size, Policy::no_update());
+        for (int i = 0; i < n; i++) values[size + i] = array[i];
+        for (int k = size - 1; k >= 1; k--) pull(k);
+    }
+
+    // Both ends are included, and an empty range (l > r) is allowed.
+    Value query(int l, int r)
+    {
+        if (l > r) return Policy::identity();
+        l += size;
+        r += size + 1;
+        push_ends(l, r);
+
+        Value left = Policy::identity(), right = Policy::identity();
+        for (; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) left = Policy::combine(left, values[l++]);
+            if (r & 1) right = Policy::combine(values[--r], right);
+        }
+        return Policy::combine(left, right);
+    }
+
+    void update(int l, int r, const Update& update)
+    {
+        if (l > r) return;
+        l += size;
+        r += size + 1;
+        push_ends(l, r);
+
+        for (int a = l, b = r; a < b; a >>= 1, b >>= 1) {
+            if (a & 1) apply_to(a++, update);
+            if (b & 1) apply_to(--b, update);
+        }
+
+        for (int i = 1; i <= log; i++) {
+            if (((l >> i) << i) != l) pull(l >> i);
+            if (((r >> i) << i) != r) pull((r - 1) >> i);
+        }
+    }
+};
+
+template <typename Policy, template <typename> class SegmentTree = LazySegmentTree>
+class HeavyLightDecomposition
+{
+    // The same decomposition as "Minimum Value In A Path - Heavy-Light
+    //  Decomposition.cpp" (see the comments there), over any segment tree
+    //  with query(l, r) and update(l, r, update), and any policy it takes.
+    //
+    // The indices are a preorder that always visits the heavy child first,
+    //  so each heavy chain is a contiguous range, top to bottom, and so is
+    //  each subtree: [index, index + subtree size - 1].
+    //
+    // The path operations only use the indices. For a node at index i,
+    //  chains[i] has the index of the top of its chain, and the index of the
+    //  parent of that top, which is all that's needed to jump over a chain.
+    //  Of two nodes on different chains, the one with the later chain top
+    //  can't have its chain top above the LCA (if it did, the other node
+    //  would be in the middle of that chain), so it's the one to jump, and
+    //  no depths are needed.
+    //
+    // With edge_weighted, the value of each node is the value of the edge
+    //  from its parent, so a path doesn't include the value of its LCA,
+    //  and a subtree doesn't include the value of its root.
+    //
+    // The DFS is iterative, so deep trees don't overflow the stack.
+
+    typedef typename Policy::Value Value;
+    typedef typename Policy::Update Update;
+
+    struct ChainLink
+    {
+        int top;
+        int above_top;
+    };
+
+    bool edge_weighted;
+    std::vector<int> index_of;
+    std::vector<int> subtree_size;
+    std::vector<ChainLink> chains;
+    SegmentTree<Policy> segment_tree;
+
+    // Returns the segment tree in the order of the indices.
+    std::vector<Value> init(const Tree& tree, int root, const std::vector<Value>& values)
+    {
+        int n = tree.size();
+        std::vector<int> parent(n, -1);
+        std::vector<int> order;
+        order.reserve(n);
+
+        std::vector<int> stack = {root};
+        while (!stack.empty()) {
+            int node = stack.back();
+            stack.pop_back();
+            order.push_back(node);
+            for (int child : tree[node]) {
+                parent[child] = node;
+                stack.push_back(child);
+            }
+        }
+
+        subtree_size.assign(n, 1);
+        std::vector<int> heavy_child(n, -1);
+        for (int i = n - 1; i > 0; i--) {
+            int node = order[i];
+            subtree_size[parent[node]] += subtree_size[node];
+        }
+        for (int node = 0; node < n; node++) {
+            for (int child : tree[node]) {
+                if (heavy_child[node] == -1 || subtree_size[child] > subtree_size[heavy_child[node]])
+                    heavy_child[node] = child;
+            }
+        }
+
+        // The heavy child is pushed last, so it's the next one to get an index.
+        index_of.resize(n);
+        chains.resize(n);
+        std::vector<int> top_of(n);
+        std::vector<Value> array(n);
+        int index = 0;
+
+        top_of[root] = root;
+        stack = {root};
+        while (!stack.empty())
+        {
+            int node = stack.back();
+            stack.pop_back();
+
+            index_of[node] = index;
+            array[index] = values[node];
+            int top = top_of[node];
+            chains[index] = {index_of[top], top == root ? -1 : index_of[parent[top]]};
+            index++;
+
+            for (int child : tree[node]) {
+                if (child != heavy_child[node]) {
+                    top_of[child] = child;
+                    stack.push_back(child);
+                }
+            }
+            if (heavy_child[node] != -1) {
+                top_of[heavy_child[node]] = top;
+                stack.push_back(heavy_child[node]);
+            }
+        }
+
+        return array;
+    }
+
+    // Calls function(l, r) for each range of indices that makes up the path.
+    template <typename Function>
+    void for_each_range(int node1, int node2, Function function)
+    {
+        int i = index_of[node1];
+        int j = index_of[node2];
+
+        while (chains[i].top != chains[j].top) {
+            if (chains[i].top < chains[j].top) std::swap(i, j);
+            function(chains[i].top, i);
+            i = chains[i].above_top;
+        }
+
+        if (i > j) std::swap(i, j);
+        function(i + edge_weighted, j);
+    }
+
+public:
+
+    // values[node] is the value of the node, or of the edge from its parent
+    //  with edge_weighted (the value of the root is then ignored).
+    HeavyLightDecomposition(const Tree& tree, int root, const std::vector<Value>& values, bool edge_weighted = false)
+        : edge_weighted(edge_weighted), segment_tree(init(tree, root, values))
+    {
+    }
+
+    Value query_path(int node1, int node2)
+    {
+        Value result = Policy::identity();
+        for_each_range(node1, node2, [&](int l, int r) {
+            result = Policy::combine(result, segment_tree.query(l, r));
+        });
+        return result;
+    }
+
+    void update_path(int node1, int node2, const Update& update)
+    {
+        for_each_range(node1, node2, [&](int l, int r) {
+            segment_tree.update(l, r, update);
+        });
+    }
+
+    Value query_subtree(int node)
+    {
+        int index = index_of[node];
+        return segment_tree.query(index + edge_weighted, index + subtree_size[node] - 1);
+    }
+
+    void update_subtree(int node, const Update& update)
+    {
+        int index = index_of[node];
+        segment_tree.update(index + edge_weighted, index + subtree_size[node] - 1, update);
+    }
+
+    // The position of the node in the segment tree.
+    int get_index(int node) const {
+        return index_of[node];
+    }
+};
+
+// A copy of "Minimum Value In A Path - Heavy-Light Decomposition.cpp",
+// used only to compare against.
+namespace original
+{
+
+template <typename T>
+struct TreeNode : public std::vector<int>
+{
+    T value;
+};
+
+template <typename T>
+using Tree = std::vector<TreeNode<T>>;
+
+struct Range
+{
+    int start;
+    int end;
+};
+
+template <typename T>
+class MinSegmentTree
+{
+    const int root = 0;
+
+    mutable std::vector<T> min;
+    mutable std::vector<T> delta;
+    std::vector<Range> ranges;
+
+    int left(int parent) const {
+        return parent * 2 + 1;
+    }
+
+    int right(int parent) const {
+        return left(parent) + 1;
+    }
+
+    bool is_complete_coverage(int node, const Range& range) const
+    {
+        return ranges[node].start >= range.start &&
+               ranges[node].end   <= range.end;
+    }
+
+    bool is_out_of_range(int node, const Range& range) const
+    {
+        return ranges[node].start > range.end ||
+               ranges[node].end   < range.start;
+    }
+
+    void push_delta(int node) const
+    {
+        delta[left (node)] += delta[node];
+        delta[right(node)] += delta[node];
+        delta[node] = 0;
+    }
+
+    void increment(int node, const Range& range, const T& value)
+    {
+        if (is_out_of_range(node, range))
+            return;
+
+        if (is_complete_coverage(node, range))
+        {
+            delta[node] += value;
+            return;
+        }
+
+        int l = left (node);
+        int r = right(node);
+
+        push_delta(node);
+        increment(l, range, value);
+        increment(r, range, value);
+        min[node] = std::min(min[l] + delta[l], min[r] + delta[r]);
+    }
+
+    T query(int node, const Range& range) const
+    {
+        if (is_out_of_range(node, range))
+            return MAX_VALUE;
+
+        if (is_complete_coverage(node, range))
+            return min[node] + delta[node];
+
+        int l = left (node);
+        int r = right(node);
+
+        min[node] += delta[node];
+        push_delta(node);
+        T result = std::min(query(l, range), query(r, range));
+        return result;
+    }
+
+    void init_ranges(int node, const Range& range)
+    {
+        ranges[node] = range;
+
+        if (range.start == range.end)
+            return;
+
+        int middle = (range.start + range.end) / 2;
+        init_ranges(left (node), {range.start, middle});
+        init_ranges(right(node), {middle + 1, range.end});
+    }
+
+    void init(const std::vector<T>& array)
+    {
+        int n = 4 * array.size() + 1;
+        min.resize(n);
+        delta.resize(n);
+        ranges.resize(n);
+
+        init_ranges(root, {0, (int)array.size() - 1});
+
+        for (int i = 0; i < array.size(); i++)
+            increment({i, i}, array[i]);
+    }
+
+public:
+
+    void increment(const Range& range, const T& value) {
+        return increment(root, range, value);
+    }
+
+    T query(const Range& range) const {
+        return query(root, range);
+    }
+
+    explicit MinSegmentTree(const std::vector<T>& array) {
+        init(array);
+    }
+};
+
+template <typename T>
+class MinHeavyLightDecomposition
+{
+    const Tree<T>& tree;
+    MinSegmentTree<T> segment_tree;
+    std::vector<int> depths;
+    std::vector<int> parent_of;
+    std::vector<int> chain_root;
+    std::vector<int> heavy_child;
+    std::vector<int> index_mapping;
+
+    int segment_tree_index;
+    int lower_node, higher_node;
+    Range range;
+
+    bool is_leaf_node(int node) {
+        return tree[node].empty();
+    }
+
+    int init_subtree(int node, int depth)
+    {
+        depths[node] = depth;
+
+        int subtree_size = 1;
+
+        if (!is_leaf_node(node))
+        {
+            int max_child = node, max_size = 0;
+
+            for (int child : tree[node])
+            {
+                parent_of[child] = node;
+                int child_size = init_subtree(child, depth + 1);
+                subtree_size += child_size;
+
+                if (child_size > max_size) {
+                    max_child = child;
+                    max_size = child_size;
+                }
+            }
+
+            heavy_child[node] = max_child;
+        }
+
+        return subtree_size;
+    }
+
+    void set_chain_root(int parent)
+    {
+        if (is_leaf_node(parent))
+            return;
+
+        int heavy = heavy_child[parent];
+        chain_root[heavy] = chain_root[parent];
+        set_chain_root(heavy);
+    }
+
+    void set_index_mapping(int node)
+    {
+        index_mapping[node] = segment_tree_index++;
+
+        if (is_leaf_node(node))
+            return;
+
+        int heavy = heavy_child[node];
+        set_index_mapping(heavy);
+
+        for (int child : tree[node]) {
+            if (child != heavy)
+                set_index_mapping(child);
+        }
+    }
+
+    void set_next_range()
+    {
+        if (depths[chain_root[lower_node]] < depths[chain_root[higher_node]])
+            std::swap(lower_node, higher_node);
+
+        range = {chain_root[lower_node], lower_node};
+
+        lower_node = parent_of[chain_root[lower_node]];
+    }
+
+    void map_current_range()
+    {
+        int l = index_mapping[range.start];
+        int r = index_mapping[range.end];
+        range = {l, r};
+    }
+
+    T query_current_range() {
+        map_current_range();
+        return segment_tree.query(range);
+    }
+
+    void increment_current_range(const T& value) {
+        map_current_range();
+        return segment_tree.increment(range, value);
+    }
+
+    bool is_in_same_chain() {
+        return chain_root[lower_node] == chain_root[higher_node];
+    }
+
+    void init_segment_tree()
+    {
+        for (int i = 0; i < index_mapping.size(); i++) {
+            range = {i, i};
+            increment_current_range(tree[i].value);
+        }
+    }
+
+    void init(int root)
+    {
+        depths.resize(tree.size());
+        parent_of.resize(tree.size());
+        chain_root.resize(tree.size());
+        heavy_child.resize(tree.size());
+        index_mapping.resize(tree.size());
+
+        init_subtree(root, 0);
+
+        for (int i = 0; i < chain_root.size(); i++)
+            chain_root[i] = i;
+
+        set_chain_root(root);
+
+        segment_tree_index = 0;
+        set_index_mapping(root);
+
+        init_segment_tree();
+    }
+
+public:
+
+    MinHeavyLightDecomposition(const Tree<T>& tree, int root)
+            : tree(tree), segment_tree(std::vector<T>(tree.size(), 0))
+    {
+        init(root);
+    }
+
+    T query(int node1, int node2)
+    {
+        T result = MAX_VALUE;
+
+        lower_node = node1;
+        higher_node = node2;
+
+        while (!is_in_same_chain()) {
+            set_next_range();
+            result = std::min(result, query_current_range());
+        }
+
+        if (depths[lower_node] < depths[higher_node])
+            std::swap(lower_node, higher_node);
+
+        range = {higher_node, lower_node};
+        result = std::min(result, query_current_range());
+
+        return result;
+    }
+
+    void increment(int node1, int node2, const T& value)
+    {
+        lower_node = node1;
+        higher_node = node2;
+
+        while (!is_in_same_chain()) {
+            set_next_range();
+            increment_current_range(value);
+        }
+
+        if (depths[lower_node] < depths[higher_node])
+            std::swap(lower_node, higher_node);
+
+        range = {higher_node, lower_node};
+        increment_current_range(value);
+    }
+};
+
+}
+
+// Walks the path and the subtree one node at a time, used only to compare against.
+template <typename Policy>
+class NaiveTree
+{
+    typedef typename Policy::Value Value;
+    typedef typename Policy::Update Update;
+
+    const Tree& tree;
+    bool edge_weighted;
+    std::vector<int> parent;
+    std::vector<int> depth;
+    std::vector<Value> values;
+
+    template <typename Function>
+    void for_each_on_path(int x, int y, Function function)
+    {
+        while (x != y) {
+            if (depth[x] < depth[y]) std::swap(x, y);
+            function(x);
+            x = parent[x];
+        }
+        if (!edge_weighted) function(x);
+    }
+
+    template <typename Function>
+    void for_each_in_subtree(int node, Function function)
+    {
+        std::vector<int> stack = {node};
+        while (!stack.empty()) {
+            int x = stack.back();
+            stack.pop_back();
+            if (x != node || !edge_weighted) function(x);
+            for (int child : tree[x]) stack.push_back(child);
+        }
+    }
+
+public:
+
+    NaiveTree(const Tree& tree, int root, const std::vector<Value>& values, bool edge_weighted)
+        : tree(tree), edge_weighted(edge_weighted), parent(tree.size(), -1), depth(tree.size(), 0), values(values)
+    {
+        std::vector<int> stack = {root};
+        while (!stack.empty()) {
+            int x = stack.back();
+            stack.pop_back();
+            for (int child : tree[x]) {
+                parent[child] = x;
+                depth[child] = depth[x] + 1;
+                stack.push_back(child);
+            }
+        }
+    }
+
+    Value query_path(int x, int y)
+    {
+        Value result = Policy::identity();
+        for_each_on_path(x, y, [&](int node) { result = Policy::combine(result, values[node]); });
+        return result;
+    }
+
+    void update_path(int x, int y, const Update& update) {
+        for_each_on_path(x, y, [&](int node) { values[node] = Policy::apply(values[node], update); });
+    }
+
+    Value query_subtree(int node)
+    {
+        Value result = Policy::identity();
+        for_each_in_subtree(node, [&](int x) { result = Policy::combine(result, values[x]); });
+        return result;
+    }
+
+    void update_subtree(int node, const Update& update) {
+        for_each_in_subtree(node, [&](int x) { values[x] = Policy::apply(values[x], update); });
+    }
+};
+
+Tree get_sample_tree_1()
+{
+    // root = 0
+    Tree tree(14);
+
+    tree[0].push_back(1);
+    tree[0].push_back(2);
+    tree[0].push_back(3);
+
+    tree[1].push_back(4);
+
+    tree[2].push_back(5);
+    tree[2].push_back(6);
+
+    tree[3].push_back(7);
+    tree[3].push_back(8);
+
+    tree[4].push_back(9);
+
+    tree[6].push_back(10);
+
+    tree[8].push_back(11);
+    tree[8].push_back(12);
+
+    tree[9].push_back(13);
+
+    return tree;
+}
+
+std::vector<std::pair<int, int>> get_sample_queries_1()
+{
+    return {
+            {4, 1},
+            {7, 8},
+            {1, 4},
+            {4, 4},
+            {12, 13},
+            {5, 6},
+            {2, 3}
+    };
+}
+
+// The parent of each node is one of the max_back nodes before it
+// (in a random order), so a small max_back gives a deep tree.
+Tree get_random_tree(int n, int max_back, unsigned seed, int& root)
+{
+    std::mt19937 random(seed);
+    std::vector<int> label(n);
+    for (int i = 0; i < n; i++) label[i] = i;
+    std::shuffle(label.begin(), label.end(), random);
+
+    Tree tree(n);
+    for (int i = 1; i < n; i++) {
+        int parent = i - 1 - random() % std::min(i, max_back);
+        tree[label[parent]].push_back(label[i]);
+    }
+    root = label[0];
+    return tree;
+}
+
+void test()
+{
+    auto tree = get_sample_tree_1();
+    std::vector<long long> values = {13, 4, 20, 2, 3, 2, 4, 1, 8, 2, 5, 3, 1, 1};
+
+    HeavyLightDecomposition<MinAdd> hld(tree, 0, values);
+    for (auto& query : get_sample_queries_1())
+    {
+        int x = query.first;
+        int y = query.second;
+        std::cout << "Minimum value along the path from " << x << " to " << y
+                  << " is " << hld.query_path(x, y) << std::endl;
+    }
+    std::cout << std::endl;
+
+    std::vector<SumAdd::Value> sums(values.size());
+    for (int i = 0; i < values.size(); i++) sums[i] = {values[i], 1};
+    HeavyLightDecomposition<SumAdd> edges(tree, 0, sums, true);
+    std::cout << "The sum of the edges from 12 to 13 is " << edges.query_path(12, 13).sum << std::endl;
+    std::cout << "The sum of the edges under 3 is " << edges.query_subtree(3).sum << std::endl;
+    std::cout << std::endl;
+}
+
+template <typename Policy, typename Equal, typename RandomValue, typename RandomUpdate>
+void random_test_policy(int tests, unsigned seed, Equal equal, RandomValue random_value, RandomUpdate random_update)
+{
+    std::mt19937 random(seed);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 200;
+        int root;
+        auto tree = get_random_tree(n, 1 + random() % n, t, root);
+        bool edge_weighted = random() % 2;
+
+        std::vector<typename Policy::Value> values(n);
+        for (auto& value : values) value = random_value(random);
+
+        HeavyLightDecomposition<Policy> hld(tree, root, values, edge_weighted);
+        NaiveTree<Policy> naive(tree, root, values, edge_weighted);
+
+        for (int i = 0; i < 300; i++)
+        {
+            int x = random() % n, y = random() % n;
+            int type = random() % 4;
+            if (type == 0) {
+                auto update = random_update(random);
+                hld.update_path(x, y, update);
+                naive.update_path(x, y, update);
+            } else if (type == 1) {
+                auto update = random_update(random);
+                hld.update_subtree(x, update);
+                naive.update_subtree(x, update);
+            } else if (type == 2) {
+                if (!equal(hld.query_path(x, y), naive.query_path(x, y))) {
+                    std::cout << "Wrong path query!" << std::endl;
+                    break;
+                }
+            } else {
+                if (!equal(hld.query_subtree(x), naive.query_subtree(x))) {
+                    std::cout << "Wrong subtree query!" << std::endl;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void random_test(int tests)
+{
+    auto equal = [](long long a, long long b) { return a == b; };
+    auto random_value = [](std::mt19937& random) { return (long long)(random() % 1000); };
+    auto random_update = [](std::mt19937& random) { return (long long)(random() % 100) - 50; };
+
+    random_test_policy<MinAdd>(tests, 1, equal, random_value, random_update);
+    random_test_policy<MaxAssign>(tests, 2, equal, random_value, random_value);
+    random_test_policy<SumAdd>(tests, 3,
+        [](SumAdd::Value a, SumAdd::Value b) { return a.sum == b.sum && a.length == b.length; },
+        [](std::mt19937& random) { return SumAdd::Value{(long long)(random() % 1000), 1}; },
+        random_update);
+}
+
+void time_test(int n, int max_back, int operations, bool run_original)
+{
+    int root;
+    auto tree = get_random_tree(n, max_back, n, root);
+    std::cout << "n = " << n << ", parents up to " << max_back << " nodes back, "
+              << operations << " operations (half path updates, half path queries)" << std::endl;
+
+    std::mt19937 random(n);
+    std::vector<long long> values(n);
+    for (auto& value : values) value = random() % 1'000'000;
+    struct Operation
+    {
+        int x;
+        int y;
+        int value;
+    };
+    std::vector<Operation> stream(operations);
+    for (auto& operation : stream) {
+        operation = {(int)(random() % n), (int)(random() % n), (int)(random() % 3) ? 0 : (int)(random() % 100) - 50};
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    HeavyLightDecomposition<MinAdd> hld(tree, root, values);
+    auto middle = std::chrono::high_resolution_clock::now();
+    std::vector<long long> answers;
+    answers.reserve(operations / 2);
+    for (int i = 0; i < operations; i++) {
+        auto& operation = stream[i];
+        if (i % 2) answers.push_back(hld.query_path(operation.x, operation.y));
+        else hld.update_path(operation.x, operation.y, operation.value);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Generic: " << std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count()
+              << " ms to build, " << std::chrono::duration_cast<std::chrono::milliseconds>(end - middle).count()
+              << " ms for the operations" << std::endl;
+
+    long long checksum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < operations; i++) {
+        auto& operation = stream[i];
+        if (i % 2) checksum += hld.query_subtree(operation.x);
+        else hld.update_subtree(operation.x, operation.value);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "Generic, subtrees: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms for the same count of subtree operations" << std::endl;
+
+    if (run_original)
+    {
+        // The original takes int values, and the values here stay far from overflowing them.
+        original::Tree<int> original_tree(n);
+        for (int i = 0; i < n; i++) {
+            original_tree[i].assign(tree[i].begin(), tree[i].end());
+            original_tree[i].value = values[i];
+        }
+
+        start = std::chrono::high_resolution_clock::now();
+        original::MinHeavyLightDecomposition<int> original_hld(original_tree, root);
+        middle = std::chrono::high_resolution_clock::now();
+        std::vector<long long> expected;
+        expected.reserve(operations / 2);
+        for (int i = 0; i < operations; i++) {
+            auto& operation = stream[i];
+            if (i % 2) expected.push_back(original_hld.query(operation.x, operation.y));
+            else original_hld.increment(operation.x, operation.y, operation.value);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::cout << "Original: " << std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count()
+                  << " ms to build, " << std::chrono::duration_cast<std::chrono::milliseconds>(end - middle).count()
+                  << " ms for the operations" << std::endl;
+        bool wrong = expected != answers;
+        if (wrong) std::cout << "Wrong path query!" << std::endl;
+    }
+
+    std::cout << "(checksum " << checksum << ")" << std::endl << std::endl;
+}
+
+int main()
+{
+    test();
+    random_test(300);
+
+    time_test(1'000'000, 1'000'000, 1'000'000, true);
+    // The original's recursive DFS overflows the stack on this one.
+    time_test(1'000'000, 2, 1'000'000, false);
+}
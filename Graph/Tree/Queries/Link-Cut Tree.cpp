@@ -0,0 +1,958 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <climits>
+
+const int MAX_VALUE = INT_MAX;
+
+typedef std::vector<std::vector<int>> Tree;
+
+class LinkCutTree
+{
+    // A forest of rooted trees that can change: a node can be cut from its
+    //  parent, and a root can be linked under any node of another tree. On
+    //  top of this, it has the same path operations as MinHeavyLightDecomposition
+    //  (the minimum of the values on the path between two nodes, and adding
+    //  to all of them), and the LCA. Everything is amortized O(log(n)).
+    //
+    // Like heavy-light decomposition, each tree is split into vertical paths,
+    //  but the paths aren't fixed. Each path is kept in a splay tree ordered by
+    //  depth (the left subtree is above, the right is below), and the root of
+    //  each splay tree points to the parent of the top of its path (a "path
+    //  parent" pointer, which the parent doesn't point back to).
+    //
+    // access(x) makes the path from the root of the tree down to x a single
+    //  splay tree with x at its root, and nothing below x: it splays x, drops
+    //  the part below it, and then keeps going up through the path parent
+    //  pointers, splaying each node and putting the path so far as its right
+    //  subtree. The last node it splays on the way up is where x's path joined
+    //  the path that was accessed before, so after access(x), access(y) returns
+    //  the LCA of x and y.
+    //
+    // For the path between x and y, with w = LCA(x, y): after access(x), the
+    //  splay tree holds the path from the root to x, and after splaying w in it,
+    //  the right subtree of w is exactly the part of the path below w. The same
+    //  goes for y, and w itself is added once.
+    //
+    // Each splay tree node keeps the minimum of its subtree, and the additions
+    //  are lazy: a pending addition of a node is already applied to its own value
+    //  and minimum, and is pushed to its children before they're looked at.
+    //
+    // The nodes are in a flat array, and -1 means no node.
+
+    struct Node
+    {
+        int child[2] = {-1, -1};
+        // The splay tree parent, or the path parent for the root of a splay tree.
+        int parent = -1;
+        long long value = 0;
+        long long min = 0;
+        long long pending = 0;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> stack;
+
+    bool is_splay_root(int x) const
+    {
+        int parent = nodes[x].parent;
+        return parent == -1 || (nodes[parent].child[0] != x && nodes[parent].child[1] != x);
+    }
+
+    void add_to(int x, long long value)
+    {
+        if (x == -1) return;
+        nodes[x].value += value;
+        nodes[x].min += value;
+        nodes[x].pending += value;
+    }
+
+    void push(int x)
+    {
+        if (nodes[x].pending) {
+            add_to(nodes[x].child[0], nodes[x].pending);
+            add_to(nodes[x].child[1], nodes[x].pending);
+            nodes[x].pending = 0;
+        }
+    }
+
+    void pull(int x)
+    {
+        auto& node = nodes[x];
+        node.min = node.value;
+        for (int child : node.child) {
+            if (child != -1) node.min = std::min(node.min, nodes[child].min);
+        }
+    }
+
+    long long min_of(int x) const {
+        return x == -1 ? LLONG_MAX : nodes[x].min;
+    }
+
+    void rotate(int x)
+    {
+        int parent = nodes[x].parent;
+        int grandparent = nodes[parent].parent;
+        int side = nodes[parent].child[1] == x;
+
+        if (!is_splay_root(parent)) {
+            nodes[grandparent].child[nodes[grandparent].child[1] == parent] = x;
+        }
+        nodes[x].parent = grandparent;
+
+        int moved = nodes[x].child[!side];
+        nodes[parent].child[side] = moved;
+        if (moved != -1) nodes[moved].parent = parent;
+
+        nodes[x].child[!side] = parent;
+        nodes[parent].parent = x;
+
+        pull(parent);
+        pull(x);
+    }
+
+    void splay(int x)
+    {
+        // The pending additions above x are pushed down first, from the top.
+        stack.clear();
+        for (int y = x; ; y = nodes[y].parent) {
+            stack.push_back(y);
+            if (is_splay_root(y)) break;
+        }
+        for (int i = stack.size() - 1; i >= 0; i--) push(stack[i]);
+
+        while (!is_splay_root(x))
+        {
+            int parent = nodes[x].parent;
+            if (!is_splay_root(parent)) {
+                int grandparent = nodes[parent].parent;
+                bool zig_zig = (nodes[parent].child[1] == x) == (nodes[grandparent].child[1] == parent);
+                rotate(zig_zig ? parent : x);
+            }
+            rotate(x);
+        }
+    }
+
+    int access(int x)
+    {
+        int last = -1;
+        for (int y = x; y != -1; y = nodes[y].parent) {
+            splay(y);
+            nodes[y].child[1] = last;
+            pull(y);
+            last = y;
+        }
+        splay(x);
+        return last;
+    }
+
+    // Calls function(w, below_x, below_y), where w is the LCA of x and y, and
+    //  below_x and below_y are the splay trees of the paths from w down to x
+    //  and to y, without w itself (-1 if empty). They are only valid during the call.
+    template <typename Function>
+    void with_path(int x, int y, Function function)
+    {
+        access(x);
+        int w = access(y);
+
+        splay(w);
+        int below_y = nodes[w].child[1];
+
+        // Accessing x again puts the path down to y aside, as a path parent pointer
+        //  from below_y to w, which stays valid since nothing below it changes.
+        access(x);
+        splay(w);
+        int below_x = nodes[w].child[1];
+
+        function(w, below_x, below_y);
+    }
+
+public:
+
+    explicit LinkCutTree(const std::vector<long long>& values) : nodes(values.size())
+    {
+        for (int i = 0; i < (int)values.size(); i++) {
+            nodes[i].value = nodes[i].min = values[i];
+        }
+    }
+
+    // Makes the root x a child of parent, which has to be in another tree.
+    void link(int x, int parent)
+    {
+        access(x);
+        nodes[x].parent = parent;
+    }
+
+    // Cuts x from its parent, which makes x the root of its own tree.
+    void cut(int x)
+    {
+        access(x);
+        int above = nodes[x].child[0];
+        if (above != -1) {
+            nodes[above].parent = -1;
+            nodes[x].child[0] = -1;
+            pull(x);
+        }
+    }
+
+    int find_root(int x)
+    {
+        access(x);
+        while (true) {
+            push(x);
+            if (nodes[x].child[0] == -1) break;
+            x = nodes[x].child[0];
+        }
+        splay(x);
+        return x;
+    }
+
+    bool is_connected(int x, int y) {
+        return find_root(x) == find_root(y);
+    }
+
+    // Both nodes have to be in the same tree.
+    int get_LCA(int x, int y)
+    {
+        access(x);
+        return access(y);
+    }
+
+    // The minimum value on the path between x and y, which have to be in the same tree.
+    long long query(int x, int y)
+    {
+        long long result = LLONG_MAX;
+        with_path(x, y, [&](int w, int below_x, int below_y) {
+            result = std::min({nodes[w].value, min_of(below_x), min_of(below_y)});
+        });
+        return result;
+    }
+
+    // Adds the value to all the nodes on the path between x and y.
+    void increment(int x, int y, long long value)
+    {
+        with_path(x, y, [&](int w, int below_x, int below_y) {
+            nodes[w].value += value;
+            add_to(below_x, value);
+            add_to(below_y, value);
+            pull(w);
+        });
+    }
+};
+
+// A copy of "Minimum Value In A Path - Heavy-Light Decomposition.cpp",
+// used only to compare against.
+namespace original
+{
+
+template <typename T>
+struct TreeNode : public std::vector<int>
+{
+    T value;
+};
+
+template <typename T>
+using Tree = std::vector<TreeNode<T>>;
+
+struct Range
+{
+    int start;
+    int end;
+};
+
+template <typename T>
+class MinSegmentTree
+{
+    const int root = 0;
+
+    mutable std::vector<T> min;
+    mutable std::vector<T> delta;
+    std::vector<Range> ranges;
+
+    int left(int parent) const {
+        return parent * 2 + 1;
+    }
+
+    int right(int parent) const {
+        return left(parent) + 1;
+    }
+
+    bool is_complete_coverage(int node, const Range& range) const
+    {
+        return ranges[node].start >= range.start &&
+               ranges[node].end   <= range.end;
+    }
+
+    bool is_out_of_range(int node, const Range& range) const
+    {
+        return ranges[node].start > range.end ||
+               ranges[node].end   < range.start;
+    }
+
+    void push_delta(int node) const
+    {
+        delta[left (node)] += delta[node];
+        delta[right(node)] += delta[node];
+        delta[node] = 0;
+    }
+
+    void increment(int node, const Range& range, const T& value)
+    {
+        if (is_out_of_range(node, range))
+            return;
+
+        if (is_complete_coverage(node, range))
+        {
+            delta[node] += value;
+            return;
+        }
+
+        int l = left (node);
+        int r = right(node);
+
+        push_delta(node);
+        increment(l, range, value);
+        increment(r, range, value);
+        min[node] = std::min(min[l] + delta[l], min[r] + delta[r]);
+    }
+
+    T query(int node, const Range& range) const
+    {
+        if (is_out_of_range(node, range))
+            return MAX_VALUE;
+
+        if (is_complete_coverage(node, range))
+            return min[node] + delta[node];
+
+        int l = left (node);
+        int r = right(node);
+
+        min[node] += delta[node];
+        push_delta(node);
+        T result = std::min(query(l, range), query(r, range));
+        return result;
+    }
+
+    void init_ranges(int node, const Range& range)
+    {
+        ranges[node] = range;
+
+        if (range.start == range.end)
+            return;
+
+        int middle = (range.start + range.end) / 2;
+        init_ranges(left (node), {range.start, middle});
+        init_ranges(right(node), {middle + 1, range.end});
+    }
+
+    void init(const std::vector<T>& array)
+    {
+        int n = 4 * array.size() + 1;
+        min.resize(n);
+        delta.resize(n);
+        ranges.resize(n);
+
+        init_ranges(root, {0, (int)array.size() - 1});
+
+        for (int i = 0; i < array.size(); i++)
+            increment({i, i}, array[i]);
+    }
+
+public:
+
+    void increment(const Range& range, const T& value) {
+        return increment(root, range, value);
+    }
+
+    T query(const Range& range) const {
+        return query(root, range);
+    }
+
+    explicit MinSegmentTree(const std::vector<T>& array) {
+        init(array);
+    }
+};
+
+template <typename T>
+class MinHeavyLightDecomposition
+{
+    const Tree<T>& tree;
+    MinSegmentTree<T> segment_tree;
+    std::vector<int> depths;
+    std::vector<int> parent_of;
+    std::vector<int> chain_root;
+    std::vector<int> heavy_child;
+    std::vector<int> index_mapping;
+
+    int segment_tree_index;
+    int lower_node, higher_node;
+    Range range;
+
+    bool is_leaf_node(int node) {
+        return tree[node].empty();
+    }
+
+    int init_subtree(int node, int depth)
+    {
+        depths[node] = depth;
+
+        int subtree_size = 1;
+
+        if (!is_leaf_node(node))
+        {
+            int max_child = node, max_size = 0;
+
+            for (int child : tree[node])
+            {
+                parent_of[child] = node;
+                int child_size = init_subtree(child, depth + 1);
+                subtree_size += child_size;
+
+                if (child_size > max_size) {
+                    max_child = child;
+                    max_size = child_size;
+                }
+            }
+
+            heavy_child[node] = max_child;
+        }
+
+        return subtree_size;
+    }
+
+    void set_chain_root(int parent)
+    {
+        if (is_leaf_node(parent))
+            return;
+
+        int heavy = heavy_child[parent];
+        chain_root[heavy] = chain_root[parent];
+        set_chain_root(heavy);
+    }
+
+    void set_index_mapping(int node)
+    {
+        index_mapping[node] = segment_tree_index++;
+
+        if (is_leaf_node(node))
+            return;
+
+        int heavy = heavy_child[node];
+        set_index_mapping(heavy);
+
+        for (int child : tree[node]) {
+            if (child != heavy)
+                set_index_mapping(child);
+        }
+    }
+
+    void set_next_range()
+    {
+        if (depths[chain_root[lower_node]] < depths[chain_root[higher_node]])
+            std::swap(lower_node, higher_node);
+
+        range = {chain_root[lower_node], lower_node};
+
+        lower_node = parent_of[chain_root[lower_node]];
+    }
+
+    void map_current_range()
+    {
+        int l = index_mapping[range.start];
+        int r = index_mapping[range.end];
+        range = {l, r};
+    }
+
+    T query_current_range() {
+        map_current_range();
+        return segment_tree.query(range);
+    }
+
+    void increment_current_range(const T& value) {
+        map_current_range();
+        return segment_tree.increment(range, value);
+    }
+
+    bool is_in_same_chain() {
+        return chain_root[lower_node] == chain_root[higher_node];
+    }
+
+    void init_segment_tree()
+    {
+        for (int i = 0; i < index_mapping.size(); i++) {
+            range = {i, i};
+            increment_current_range(tree[i].value);
+        }
+    }
+
+    void init(int root)
+    {
+        depths.resize(tree.size());
+        parent_of.resize(tree.size());
+        chain_root.resize(tree.size());
+        heavy_child.resize(tree.size());
+        index_mapping.resize(tree.size());
+
+        init_subtree(root, 0);
+
+        for (int i = 0; i < chain_root.size(); i++)
+            chain_root[i] = i;
+
+        set_chain_root(root);
+
+        segment_tree_index = 0;
+        set_index_mapping(root);
+
+        init_segment_tree();
+    }
+
+public:
+
+    MinHeavyLightDecomposition(const Tree<T>& tree, int root)
+            : tree(tree), segment_tree(std::vector<T>(tree.size(), 0))
+    {
+        init(root);
+    }
+
+    T query(int node1, int node2)
+    {
+        T result = MAX_VALUE;
+
+        lower_node = node1;
+        higher_node = node2;
+
+        while (!is_in_same_chain()) {
+            set_next_range();
+            result = std::min(result, query_current_range());
+        }
+
+        if (depths[lower_node] < depths[higher_node])
+            std::swap(lower_node, higher_node);
+
+        range = {higher_node, lower_node};
+        result = std::min(result, query_current_range());
+
+        return result;
+    }
+
+    void increment(int node1, int node2, const T& value)
+    {
+        lower_node = node1;
+        higher_node = node2;
+
+        while (!is_in_same_chain()) {
+            set_next_range();
+            increment_current_range(value);
+        }
+
+        if (depths[lower_node] < depths[higher_node])
+            std::swap(lower_node, higher_node);
+
+        range = {higher_node, lower_node};
+        increment_current_range(value);
+    }
+};
+
+}
+
+// A forest as a plain array of parents, used only to compare against.
+class NaiveForest
+{
+    std::vector<int> parent;
+    std::vector<long long> values;
+
+    int depth(int x) const
+    {
+        int result = 0;
+        for (; parent[x] != -1; x = parent[x]) result++;
+        return result;
+    }
+
+    template <typename Function>
+    int for_each_on_path(int x, int y, Function function)
+    {
+        int depth_x = depth(x), depth_y = depth(y);
+        while (x != y) {
+            if (depth_x < depth_y) {
+                std::swap(x, y);
+                std::swap(depth_x, depth_y);
+            }
+            function(x);
+            x = parent[x];
+            depth_x--;
+        }
+        function(x);
+        return x;
+    }
+
+public:
+
+    explicit NaiveForest(const std::vector<long long>& values) : parent(values.size(), -1), values(values) {}
+
+    void link(int x, int p) { parent[x] = p; }
+    void cut(int x) { parent[x] = -1; }
+    int get_parent(int x) const { return parent[x]; }
+
+    int find_root(int x) const
+    {
+        while (parent[x] != -1) x = parent[x];
+        return x;
+    }
+
+    int get_LCA(int x, int y) {
+        return for_each_on_path(x, y, [](int) {});
+    }
+
+    long long query(int x, int y)
+    {
+        long long result = LLONG_MAX;
+        for_each_on_path(x, y, [&](int node) { result = std::min(result, values[node]); });
+        return result;
+    }
+
+    void increment(int x, int y, long long value) {
+        for_each_on_path(x, y, [&](int node) { values[node] += value; });
+    }
+};
+
+Tree get_sample_tree_1()
+{
+    // root = 0
+    Tree tree(14);
+
+    tree[0].push_back(1);
+    tree[0].push_back(2);
+    tree[0].push_back(3);
+
+    tree[1].push_back(4);
+
+    tree[2].push_back(5);
+    tree[2].push_back(6);
+
+    tree[3].push_back(7);
+    tree[3].push_back(8);
+
+    tree[4].push_back(9);
+
+    tree[6].push_back(10);
+
+    tree[8].push_back(11);
+    tree[8].push_back(12);
+
+    tree[9].push_back(13);
+
+    return tree;
+}
+
+std::vector<std::pair<int, int>> get_sample_queries_1()
+{
+    return {
+            {4, 1},
+            {7, 8},
+            {1, 4},
+            {4, 4},
+            {12, 13},
+            {5, 6},
+            {2, 3}
+    };
+}
+
+// The parent of each node is one of the max_back nodes before it
+// (in a random order), so a small max_back gives a deep tree.
+Tree get_random_tree(int n, int max_back, unsigned seed, int& root)
+{
+    std::mt19937 random(seed);
+    std::vector<int> label(n);
+    for (int i = 0; i < n; i++) label[i] = i;
+    std::shuffle(label.begin(), label.end(), random);
+
+    Tree tree(n);
+    for (int i = 1; i < n; i++) {
+        int parent = i - 1 - random() % std::min(i, max_back);
+        tree[label[parent]].push_back(label[i]);
+    }
+    root = label[0];
+    return tree;
+}
+
+
+// Links every node of the tree under its parent.
+LinkCutTree get_link_cut_tree(const Tree& tree, const std::vector<long long>& values)
+{
+    LinkCutTree result(values);
+    for (int node = 0; node < tree.size(); node++) {
+        for (int child : tree[node]) result.link(child, node);
+    }
+    return result;
+}
+
+original::Tree<int> get_original_tree(const Tree& tree, const std::vector<long long>& values)
+{
+    original::Tree<int> result(tree.size());
+    for (int node = 0; node < tree.size(); node++) {
+        result[node].assign(tree[node].begin(), tree[node].end());
+        result[node].value = values[node];
+    }
+    return result;
+}
+
+std::vector<long long> get_random_values(int n, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<long long> values(n);
+    for (auto& value : values) value = random() % 1000;
+    return values;
+}
+
+void test(const Tree& tree, const std::vector<std::pair<int, int>>& queries)
+{
+    std::vector<long long> values(tree.size());
+    for (int i = 0; i < tree.size(); i++) values[i] = i;
+    auto lct = get_link_cut_tree(tree, values);
+
+    for (auto& query : queries) {
+        std::cout << "LCA of " << query.first << " and " << query.second << " is "
+                  << lct.get_LCA(query.first, query.second) << ", the minimum on the path is "
+                  << lct.query(query.first, query.second) << std::endl;
+    }
+
+    // Moves the subtree of 8 under 13.
+    lct.cut(8);
+    lct.link(8, 13);
+    std::cout << "After moving 8 under 13:" << std::endl;
+    for (auto& query : queries) {
+        std::cout << "LCA of " << query.first << " and " << query.second << " is "
+                  << lct.get_LCA(query.first, query.second) << ", the minimum on the path is "
+                  << lct.query(query.first, query.second) << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void random_static_test(int tests)
+{
+    std::mt19937 random(7);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 200;
+        int root;
+        auto tree = get_random_tree(n, 1 + random() % n, t, root);
+        auto values = get_random_values(n, t);
+
+        auto lct = get_link_cut_tree(tree, values);
+        auto original_tree = get_original_tree(tree, values);
+        original::MinHeavyLightDecomposition<int> hld(original_tree, root);
+
+        for (int i = 0; i < 300; i++)
+        {
+            int x = random() % n;
+            int y = random() % n;
+            if (random() % 2) {
+                int value = (int)(random() % 100) - 50;
+                lct.increment(x, y, value);
+                hld.increment(x, y, value);
+            } else if (lct.query(x, y) != hld.query(x, y)) {
+                std::cout << "Wrong minimum!" << std::endl;
+                return;
+            }
+        }
+    }
+}
+
+void random_dynamic_test(int tests)
+{
+    std::mt19937 random(11);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 100;
+        auto values = get_random_values(n, t);
+        LinkCutTree lct(values);
+        NaiveForest naive(values);
+
+        for (int i = 0; i < 1000; i++)
+        {
+            int x = random() % n;
+            int y = random() % n;
+            int type = random() % 6;
+
+            if (type == 0) {
+                // Links the root of x under y if they're in different trees.
+                int root = naive.find_root(x);
+                if (naive.find_root(y) != root) {
+                    lct.link(root, y);
+                    naive.link(root, y);
+                }
+            } else if (type == 1) {
+                lct.cut(x);
+                naive.cut(x);
+            } else if (type == 2) {
+                if (lct.find_root(x) != naive.find_root(x)) {
+                    std::cout << "Wrong root!" << std::endl;
+                    return;
+                }
+            } else if (naive.find_root(x) != naive.find_root(y)) {
+                if (lct.is_connected(x, y)) {
+                    std::cout << "Wrong connectivity!" << std::endl;
+                    return;
+                }
+            } else if (type == 3) {
+                if (lct.get_LCA(x, y) != naive.get_LCA(x, y)) {
+                    std::cout << "Wrong LCA!" << std::endl;
+                    return;
+                }
+            } else if (type == 4) {
+                if (lct.query(x, y) != naive.query(x, y)) {
+                    std::cout << "Wrong minimum!" << std::endl;
+                    return;
+                }
+            } else {
+                int value = (int)(random() % 100) - 50;
+                lct.increment(x, y, value);
+                naive.increment(x, y, value);
+            }
+        }
+    }
+}
+
+// A tree that keeps changing: each change moves the subtree of a random node under
+//  another random node outside of it, and it's followed by queries_per_change path
+//  minimum queries. A static structure has to be rebuilt after every change.
+void time_test(int n, int changes, int queries_per_change)
+{
+    int root;
+    auto tree = get_random_tree(n, n, n, root);
+    auto values = get_random_values(n, n);
+    std::cout << "n = " << n << ", " << changes << " changes, "
+              << queries_per_change << " queries after each" << std::endl;
+
+    std::mt19937 random(n);
+    std::vector<int> parent(n, -1);
+    for (int node = 0; node < n; node++) {
+        for (int child : tree[node]) parent[child] = node;
+    }
+
+    // The changes are picked first, so that both versions do the same work.
+    struct Change
+    {
+        int node;
+        int new_parent;
+    };
+    std::vector<Change> schedule;
+    std::vector<std::pair<int, int>> queries;
+    {
+        auto lct = get_link_cut_tree(tree, values);
+        for (int i = 0; i < changes; i++)
+        {
+            int node, new_parent;
+            do {
+                node = random() % n;
+                new_parent = random() % n;
+                if (node == root) continue;
+                lct.cut(node);
+                if (lct.find_root(new_parent) != node) break;
+                lct.link(node, parent[node]);
+            } while (true);
+            lct.link(node, new_parent);
+            parent[node] = new_parent;
+            schedule.push_back({node, new_parent});
+            for (int j = 0; j < queries_per_change; j++) {
+                queries.push_back({(int)(random() % n), (int)(random() % n)});
+            }
+        }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto lct = get_link_cut_tree(tree, values);
+    std::vector<long long> answers;
+    answers.reserve(queries.size());
+    for (int i = 0; i < changes; i++)
+    {
+        lct.cut(schedule[i].node);
+        lct.link(schedule[i].node, schedule[i].new_parent);
+        for (int j = i * queries_per_change; j < (i + 1) * queries_per_change; j++) {
+            answers.push_back(lct.query(queries[j].first, queries[j].second));
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Link-cut tree: " << ms << " ms" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    std::fill(parent.begin(), parent.end(), -1);
+    for (int node = 0; node < n; node++) {
+        for (int child : tree[node]) parent[child] = node;
+    }
+    long long wrong = 0;
+    for (int i = 0; i < changes; i++)
+    {
+        parent[schedule[i].node] = schedule[i].new_parent;
+        Tree current(n);
+        for (int node = 0; node < n; node++) {
+            if (parent[node] != -1) current[parent[node]].push_back(node);
+        }
+        auto original_tree = get_original_tree(current, values);
+        original::MinHeavyLightDecomposition<int> hld(original_tree, root);
+        for (int j = i * queries_per_change; j < (i + 1) * queries_per_change; j++) {
+            wrong += hld.query(queries[j].first, queries[j].second) != answers[j];
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Heavy-light decomposition, rebuilt after each change: " << ms << " ms" << std::endl;
+
+    if (wrong) std::cout << "Wrong minimum!" << std::endl;
+    std::cout << std::endl;
+}
+
+// Only the link-cut tree, with a mix of all the operations on a forest.
+void time_test_operations(int n, int operations, int max_back)
+{
+    int root;
+    auto tree = get_random_tree(n, max_back, n, root);
+    auto values = get_random_values(n, n);
+    std::cout << "n = " << n << ", parents up to " << max_back << " nodes back, "
+              << operations << " operations" << std::endl;
+
+    std::mt19937 random(n);
+    auto start = std::chrono::high_resolution_clock::now();
+    auto lct = get_link_cut_tree(tree, values);
+    long long checksum = 0;
+    for (int i = 0; i < operations; i++)
+    {
+        int x = random() % n;
+        int y = random() % n;
+        switch (random() % 4)
+        {
+            case 0:
+                // Moves the tree of x under y, or cuts x if they're already connected.
+                if (lct.find_root(y) != lct.find_root(x)) lct.link(lct.find_root(x), y);
+                else lct.cut(x);
+                break;
+            case 1:
+                if (lct.is_connected(x, y)) lct.increment(x, y, 1);
+                break;
+            case 2:
+                if (lct.is_connected(x, y)) checksum += lct.query(x, y);
+                break;
+            default:
+                if (lct.is_connected(x, y)) checksum += lct.get_LCA(x, y);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Link-cut tree: " << ms << " ms, " << (double)operations / ms / 1000
+              << "M operations per second (checksum " << checksum << ")" << std::endl;
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test(get_sample_tree_1(), get_sample_queries_1());
+    random_static_test(300);
+    random_dynamic_test(300);
+
+    time_test(100'000, 100, 1000);
+    time_test_operations(1'000'000, 1'000'000, 1'000'000);
+    time_test_operations(1'000'000, 1'000'000, 3);
+}
@@ -1,5 +1,9 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <random>
 
 const int MAX_VALUE = 1'000'000;
 
@@ -135,6 +139,152 @@ public:
 };
 
 
+// The centroid decomposition as flat arrays, which is
+// what most of the distance-based queries need.
+struct FlatCentroidDecomposition
+{
+    int root;
+    // The levels are at most log2(n), so each node has a
+    //  row of levels_count distances.
+    int levels_count;
+    std::vector<int> parent_of;
+    std::vector<int> level;
+    // distances[node * levels_count + k] = the distance in the original
+    //  tree between the node and its ancestor at level k in the centroid
+    //  decomposition tree, for all k <= level[node].
+    std::vector<int> distances;
+
+    int distance_to_ancestor(int node, int ancestor_level) const {
+        return distances[(size_t)node * levels_count + ancestor_level];
+    }
+};
+
+class IterativeCentroidDecomposition
+{
+    // Builds the same decomposition as CentroidDecomposition (the same
+    //  centroids, and the same parents), but without recursion, so path-like
+    //  trees don't overflow the stack, and without building a Tree for it.
+    //
+    // Each component is explored with a BFS from its centroid, which gives
+    //  the distances from the centroid to the whole component. The same BFS
+    //  also gives the subtree sizes of each of the components that are left
+    //  after removing the centroid, rooted at the neighbour of the centroid,
+    //  which is where CentroidDecomposition would start looking for their
+    //  centroids. This way, each node is visited once per level.
+
+    const Tree& tree;
+
+    std::vector<char> is_blocked;
+    std::vector<int> subtree_size;
+
+    struct QueueFrame
+    {
+        int node;
+        int parent;
+        int distance;
+    };
+    std::vector<QueueFrame> queue;
+
+    // Puts the component of the node in the queue, in BFS order,
+    //  and sets the subtree sizes, rooted at the node.
+    void explore_component(int node)
+    {
+        queue.clear();
+        queue.push_back({node, -1, 0});
+        for (int i = 0; i < (int)queue.size(); i++)
+        {
+            auto frame = queue[i];
+            subtree_size[frame.node] = 1;
+            for (int child : tree[frame.node]) {
+                if (!is_blocked[child] && child != frame.parent)
+                    queue.push_back({child, frame.node, frame.distance + 1});
+            }
+        }
+
+        for (int i = queue.size() - 1; i > 0; i--)
+            subtree_size[queue[i].parent] += subtree_size[queue[i].node];
+    }
+
+    int find_centroid(int node)
+    {
+        int tree_size = subtree_size[node];
+        int parent = -1;
+
+        while (true)
+        {
+            int next = -1;
+            for (int child : tree[node])
+            {
+                if (is_blocked[child] || child == parent)
+                    continue;
+
+                if (subtree_size[child] > tree_size / 2) {
+                    next = child;
+                    break;
+                }
+            }
+
+            if (next == -1) return node;
+            parent = node;
+            node = next;
+        }
+    }
+
+public:
+
+    explicit IterativeCentroidDecomposition(const Tree& tree) :
+        tree(tree),
+        is_blocked(tree.size(), false),
+        subtree_size(tree.size())
+    {}
+
+    FlatCentroidDecomposition get_centroid_decomposition()
+    {
+        int n = tree.size();
+
+        FlatCentroidDecomposition result;
+        result.levels_count = log2_floor(n) + 1;
+        result.parent_of.resize(n);
+        result.level.resize(n);
+        result.distances.resize((size_t)n * result.levels_count);
+
+        struct Component
+        {
+            int start;
+            int parent_centroid;
+        };
+
+        int node = 0; // The node here doesn't matter.
+        explore_component(node);
+        std::vector<Component> stack = {{node, -1}};
+
+        while (!stack.empty())
+        {
+            auto component = stack.back();
+            stack.pop_back();
+
+            int centroid = find_centroid(component.start);
+            int parent = component.parent_centroid;
+            int level = parent == -1 ? 0 : result.level[parent] + 1;
+            result.parent_of[centroid] = parent;
+            result.level[centroid] = level;
+            if (parent == -1) result.root = centroid;
+
+            explore_component(centroid);
+            for (auto& frame : queue)
+                result.distances[(size_t)frame.node * result.levels_count + level] = frame.distance;
+            is_blocked[centroid] = true;
+
+            for (int child : tree[centroid])
+                if (!is_blocked[child])
+                    stack.push_back({child, centroid});
+        }
+
+        return result;
+    }
+};
+
+
 class LowestCommonAncestor
 {
     const Tree& tree;
@@ -252,52 +402,91 @@ public:
 
 private:
 
-    const Tree& tree;
-    RootedTree centroid_decomposition;
-    // Binary Lifting is being used here to
-    // compute the LCA, but you can use any
-    // other method for finding the LCA.
-    LowestCommonAncestor lca;
-    std::vector<int> parent_of;
-    std::vector<NearNode> nearest_nodes;
+    struct CentroidAncestor
+    {
+        int centroid;
+        int distance;
+    };
 
-    int distance(int node1, int node2)
+    struct HeapEntry
     {
-        // A quick hack. since the LCA class contains
-        // an array of depths, why not use it.
-        return lca.distance(node1, node2);
-    }
+        int distance;
+        int node;
+        // The index of the centroid in the ancestors of the node.
+        int ancestor_index;
 
-    void minimize_nearest_node(int node, int near_node)
+        bool operator>(const HeapEntry& other) const {
+            return distance > other.distance;
+        }
+    };
+
+    const Tree& tree;
+
+    // The centroid ancestors of the node x, from the root of the centroid
+    //  decomposition tree down to x itself, with their distances to x, are
+    //  ancestors[offsets[x]] ... ancestors[offsets[x + 1] - 1]. This is
+    //  O(n * log(n)) ints, and it's what the queries use instead of an LCA.
+    std::vector<int> offsets;
+    std::vector<CentroidAncestor> ancestors;
+
+    // A min-heap for each centroid, of the colored nodes in its subtree (in
+    //  the centroid decomposition tree) by their distance to it. Uncolored
+    //  nodes aren't removed right away, but only once they reach the top.
+    //  is_in_heap[i] tells if the entry of ancestors[i] is still in the heap,
+    //  so coloring a node again reuses it, and each heap has at most one entry
+    //  per node in the subtree, however many times the nodes are toggled.
+    std::vector<std::vector<HeapEntry>> heaps;
+    std::vector<char> is_in_heap;
+    std::vector<char> is_colored;
+
+    // The top of each heap, in a flat array, so that the queries don't have
+    //  to go through the heaps at all.
+    std::vector<NearNode> nearest_nodes;
+
+    // The same arrays, from the flat centroid decomposition, but with the
+    //  ancestors of each node next to each other, and without the padding.
+    void set_ancestors(const FlatCentroidDecomposition& centroid_decomposition)
     {
-        int dist = distance(node, near_node);
-        if (dist < nearest_nodes[node].distance) {
-            nearest_nodes[node].distance = dist;
-            nearest_nodes[node].node = near_node;
+        int n = tree.size();
+        const auto& level = centroid_decomposition.level;
+        offsets.assign(n + 1, 0);
+        for (int i = 0; i < n; i++)
+            offsets[i + 1] = offsets[i] + level[i] + 1;
+        ancestors.resize(offsets[n]);
+        is_in_heap.assign(offsets[n], false);
+
+        for (int node = 0; node < n; node++)
+        {
+            int ancestor = node;
+            for (int k = level[node]; k >= 0; k--) {
+                int distance = centroid_decomposition.distance_to_ancestor(node, k);
+                ancestors[offsets[node] + k] = {ancestor, distance};
+                ancestor = centroid_decomposition.parent_of[ancestor];
+            }
         }
     }
 
-    void set_centroid_decomposition_parents(int node, int parent = -1)
+    void update_nearest_node(int centroid)
     {
-        parent_of[node] = parent;
-        for (int child : centroid_decomposition.tree[node])
-            if (child != parent)
-                set_centroid_decomposition_parents(child, node);
+        auto& heap = heaps[centroid];
+        while (!heap.empty() && !is_colored[heap.front().node]) {
+            is_in_heap[heap.front().ancestor_index] = false;
+            std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+            heap.pop_back();
+        }
+        if (heap.empty()) nearest_nodes[centroid] = {-1, MAX_VALUE};
+        else nearest_nodes[centroid] = {heap.front().node, heap.front().distance};
     }
 
     void init()
     {
-        set_centroid_decomposition_parents(centroid_decomposition.root);
+        set_ancestors(IterativeCentroidDecomposition(tree).get_centroid_decomposition());
         for (int i = 0; i < tree.size(); i++)
-            nearest_nodes[i].distance = MAX_VALUE;
+            nearest_nodes[i] = {-1, MAX_VALUE};
     }
 
 public:
 
-    // TODO figure out how to uncolor a node.
-
-    // TODO review the explanation below.
-
     // Algorithm:
     //  For each node in the tree, store the nearest colored node in ITS SUBTREE.
     //  Initially, all nodes are not colored, thus all nodes won't have a nearest
@@ -326,14 +515,15 @@ public:
     //   algorithm working on it.
     //  We'll use a centroid decomposition tree. Its height is O(log(n)), which means that
     //   the updates and the lookups should be O(log(n)), assuming that the distance between
-    //   two nodes can be computed in O(1). Here, we'll use a binary lifting, which takes
-    //   O(log(n)) as well, which makes both updates and queries take O(log(n)^2).
+    //   two nodes can be computed in O(1). Here, the distances from each node to all of its
+    //   ancestors in the centroid decomposition tree are computed once, when it's built,
+    //   so the distance to an ancestor is a lookup.
     //  Since the centroid decomposition tree won't have the same set of edges as in the
     //   original tree, an ancestor in the centroid decomposition tree doesn't have to be
     //   an ancestor in the original tree. Moreover, even if all ancestors in the centroid
     //   decomposition tree were ancestors in the original tree, they don't have to have
-    //   the same order, thus, we'll have to compute the distance every time we go up a node
-    //   in the centroid decomposition tree.
+    //   the same order, thus, we'll need the distance to every ancestor in the centroid
+    //   decomposition tree, and not only to the parent.
     //  But, why would it work? Notice that the algorithm works in the original tree because
     //   going up the ancestors in the original tree ensures that we explore every single node
     //   in the tree. If it's not in our subtree, then it must be in the subtree of one
@@ -349,6 +539,137 @@ public:
     //   in its subtree (the stored value), and search in the subtrees of the ancestors, we
     //   would be searching for every node in the tree, which means that  we can use a centroid
     //   decomposition tree and get a correct result.
+    //  To uncolor a node, storing only the nearest colored node isn't enough, since once
+    //   it's uncolored, the next nearest one is needed. Instead, each node keeps a min-heap
+    //   of all the colored nodes in its subtree, by their distance to it. Uncoloring a node
+    //   only marks it, and it's removed from a heap when it gets to the top (lazy deletion).
+    //   The top of each heap is kept next to it, like the stored value before, so coloring
+    //   is O(log(n)^2), uncoloring is O(log(n)^2) amortized, and the queries are O(log(n)).
+
+    void color_node(int node)
+    {
+        if (is_colored[node]) return;
+        is_colored[node] = true;
+        for (int i = offsets[node]; i < offsets[node + 1]; i++) {
+            int centroid = ancestors[i].centroid;
+            int distance = ancestors[i].distance;
+
+            if (!is_in_heap[i]) {
+                auto& heap = heaps[centroid];
+                heap.push_back({distance, node, i});
+                std::push_heap(heap.begin(), heap.end(), std::greater<>());
+                is_in_heap[i] = true;
+            }
+
+            if (distance < nearest_nodes[centroid].distance)
+                nearest_nodes[centroid] = {node, distance};
+        }
+    }
+
+    void uncolor_node(int node)
+    {
+        // The entries of the node stay in the heaps where it's not the nearest,
+        //  and become valid again if it's colored again before they're removed.
+        if (!is_colored[node]) return;
+        is_colored[node] = false;
+        for (int i = offsets[node]; i < offsets[node + 1]; i++) {
+            int centroid = ancestors[i].centroid;
+            if (nearest_nodes[centroid].node == node)
+                update_nearest_node(centroid);
+        }
+    }
+
+    NearNode get_closest_colored_node(int node) const
+    {
+        NearNode result = {-1, MAX_VALUE};
+        for (int i = offsets[node]; i < offsets[node + 1]; i++)
+        {
+            auto& nearest = nearest_nodes[ancestors[i].centroid];
+            int total_distance = ancestors[i].distance + nearest.distance;
+            if (total_distance < result.distance) {
+                result.node = nearest.node;
+                result.distance = total_distance;
+            }
+        }
+        return result;
+    }
+
+    // The number of entries in all the heaps, including the ones waiting to
+    //  be removed.
+    long long get_heap_entries_count() const
+    {
+        long long count = 0;
+        for (auto& heap : heaps)
+            count += heap.size();
+        return count;
+    }
+
+    NearestColoredNode(const Tree& tree) :
+        tree(tree),
+        heaps(tree.size()),
+        is_colored(tree.size(), false),
+        nearest_nodes(tree.size())
+    {
+        init();
+    }
+};
+
+// A copy of the NearestColoredNode before uncoloring was added, which computes
+// every distance with an LCA, used only to compare against.
+class NearestColoredNodeWithLCA
+{
+
+public:
+
+    struct NearNode
+    {
+        int node;
+        int distance;
+    };
+
+private:
+
+    const Tree& tree;
+    RootedTree centroid_decomposition;
+    // Binary Lifting is being used here to
+    // compute the LCA, but you can use any
+    // other method for finding the LCA.
+    LowestCommonAncestor lca;
+    std::vector<int> parent_of;
+    std::vector<NearNode> nearest_nodes;
+
+    int distance(int node1, int node2)
+    {
+        // A quick hack. since the LCA class contains
+        // an array of depths, why not use it.
+        return lca.distance(node1, node2);
+    }
+
+    void minimize_nearest_node(int node, int near_node)
+    {
+        int dist = distance(node, near_node);
+        if (dist < nearest_nodes[node].distance) {
+            nearest_nodes[node].distance = dist;
+            nearest_nodes[node].node = near_node;
+        }
+    }
+
+    void set_centroid_decomposition_parents(int node, int parent = -1)
+    {
+        parent_of[node] = parent;
+        for (int child : centroid_decomposition.tree[node])
+            if (child != parent)
+                set_centroid_decomposition_parents(child, node);
+    }
+
+    void init()
+    {
+        set_centroid_decomposition_parents(centroid_decomposition.root);
+        for (int i = 0; i < tree.size(); i++)
+            nearest_nodes[i].distance = MAX_VALUE;
+    }
+
+public:
 
     void color_node(int node)
     {
@@ -382,7 +703,7 @@ public:
 
     // We query the centroid decomposition tree, but we
     // use the original tree to compute the distance.
-    NearestColoredNode(const Tree& tree, int root = 0) :
+    NearestColoredNodeWithLCA(const Tree& tree, int root = 0) :
         tree(tree),
         centroid_decomposition(CentroidDecomposition(tree).get_centroid_decomposition()),
         lca(tree, root),
@@ -408,13 +729,13 @@ void test(const Tree& tree, const std::vector<Query>& queries)
         if (query.type == Query::color) {
             std::cout << "Coloring the node " << query.node + 1 << std::endl;
             ncn.color_node(query.node);
-//        } else if (query.type == Query::uncolor) {
-//            std::cout << "Uncoloring the node " << query.node + 1 << std::endl;
-//            ncn.uncolor_node(query.node);
+        } else if (query.type == Query::uncolor) {
+            std::cout << "Uncoloring the node " << query.node + 1 << std::endl;
+            ncn.uncolor_node(query.node);
         } else if (query.type == Query::query) {
             auto result = ncn.get_closest_colored_node(query.node);
             if (result.distance == MAX_VALUE) {
-                std::cout << "There is no colored node in the tree yet." << std::endl;
+                std::cout << "There is no colored node in the tree." << std::endl;
             } else {
                 std::cout << "Nearest colored node to node " << query.node + 1
                           << " is node " << result.node + 1 << " with a distance of "
@@ -497,12 +818,212 @@ std::vector<Query> get_sample_queries_2()
         {Query::query, 5},
         {Query::query, 13},
         {Query::query, 7},
+        {Query::uncolor, 15},
+        {Query::query, 13},
+        {Query::uncolor, 5},
+        {Query::query, 7},
+        {Query::uncolor, 1},
+        {Query::query, 7},
+        {Query::color, 15},
+        {Query::query, 7},
     };
 }
 
 
+// The parent of each node is one of the max_back nodes before it
+// (in a random order), so a small max_back gives a deep tree.
+Tree get_random_tree(int n, int max_back, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<int> label(n);
+    for (int i = 0; i < n; i++) label[i] = i;
+    std::shuffle(label.begin(), label.end(), random);
+
+    Tree tree(n);
+    for (int i = 1; i < n; i++) {
+        int parent = i - 1 - random() % std::min(i, max_back);
+        add_edge(tree, label[parent], label[i]);
+    }
+    return tree;
+}
+
+// Roughly 1/3 colors, 1/6 uncolors (of a colored node, if any) and 1/2 queries.
+std::vector<Query> get_random_queries(int n, int count, bool uncolor, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<int> colored;
+    std::vector<Query> queries(count);
+    for (auto& query : queries)
+    {
+        int type = random() % 6;
+        if (type < 2) {
+            query = {Query::color, (int)(random() % n)};
+            colored.push_back(query.node);
+        } else if (type < 3 && uncolor && !colored.empty()) {
+            int i = random() % colored.size();
+            query = {Query::uncolor, colored[i]};
+            colored[i] = colored.back();
+            colored.pop_back();
+        } else {
+            query = {Query::query, (int)(random() % n)};
+        }
+    }
+    return queries;
+}
+
+std::vector<int> get_distances(const Tree& tree, int source)
+{
+    std::vector<int> distances(tree.size(), -1);
+    std::vector<int> queue = {source};
+    distances[source] = 0;
+    for (int i = 0; i < (int)queue.size(); i++) {
+        for (int child : tree[queue[i]]) {
+            if (distances[child] == -1) {
+                distances[child] = distances[queue[i]] + 1;
+                queue.push_back(child);
+            }
+        }
+    }
+    return distances;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(13);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 100;
+        auto tree = get_random_tree(n, 1 + random() % n, t);
+        auto queries = get_random_queries(n, random() % 300, true, t);
+
+        NearestColoredNode ncn(tree);
+        std::vector<char> is_colored(n, false);
+        for (const Query& query : queries)
+        {
+            if (query.type == Query::color) {
+                ncn.color_node(query.node);
+                is_colored[query.node] = true;
+            } else if (query.type == Query::uncolor) {
+                ncn.uncolor_node(query.node);
+                is_colored[query.node] = false;
+            } else {
+                auto distances = get_distances(tree, query.node);
+                int expected = MAX_VALUE;
+                for (int i = 0; i < n; i++)
+                    if (is_colored[i]) expected = std::min(expected, distances[i]);
+
+                auto result = ncn.get_closest_colored_node(query.node);
+                bool is_valid = result.distance == MAX_VALUE ||
+                        (is_colored[result.node] && distances[result.node] == result.distance);
+                if (result.distance != expected || !is_valid) {
+                    std::cout << "Wrong nearest colored node!" << std::endl;
+                    return;
+                }
+            }
+        }
+    }
+}
+
+// Toggles some nodes many times while all the other nodes are colored, so
+//  their entries are never at the top of most heaps. The heaps should still
+//  have at most one entry per node and centroid ancestor, which is what they
+//  have right after coloring all the nodes.
+void toggle_test(int n, int toggles)
+{
+    std::mt19937 random(17);
+    auto tree = get_random_tree(n, n, n);
+    NearestColoredNode ncn(tree);
+    for (int i = 0; i < n; i++)
+        ncn.color_node(i);
+    long long max_entries = ncn.get_heap_entries_count();
+
+    for (int node : {0, n / 2, n - 1})
+    {
+        for (int i = 0; i < toggles; i++) {
+            ncn.uncolor_node(node);
+            ncn.color_node(node);
+        }
+        ncn.uncolor_node(node);
+
+        int query_node = random() % n;
+        auto result = ncn.get_closest_colored_node(query_node);
+        int expected_distance = query_node == node ? 1 : 0;
+        if (ncn.get_heap_entries_count() > max_entries || result.distance != expected_distance) {
+            std::cout << "Wrong heap sizes!" << std::endl;
+            return;
+        }
+        ncn.color_node(node);
+    }
+}
+
+template <typename NearestColoredNodeType>
+long long run(NearestColoredNodeType& ncn, const std::vector<Query>& queries)
+{
+    long long checksum = 0;
+    for (const Query& query : queries)
+    {
+        if (query.type == Query::color) {
+            ncn.color_node(query.node);
+        } else if (query.type == Query::query) {
+            checksum += ncn.get_closest_colored_node(query.node).distance;
+        } else if constexpr (std::is_same_v<NearestColoredNodeType, NearestColoredNode>) {
+            ncn.uncolor_node(query.node);
+        }
+    }
+    return checksum;
+}
+
+void time_test(int n, int max_back, int queries_count)
+{
+    auto tree = get_random_tree(n, max_back, n);
+    std::cout << "n = " << n << ", parents up to " << max_back << " nodes back, "
+              << queries_count << " operations" << std::endl;
+
+    // The original can't uncolor, so it's compared on colors and queries only.
+    auto queries = get_random_queries(n, queries_count, false, n);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    NearestColoredNode ncn(tree);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto build_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    long long checksum = run(ncn, queries);
+    end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Precomputed distances: build " << build_ms << " ms, colors and queries "
+              << ms << " ms" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    NearestColoredNodeWithLCA original(tree);
+    end = std::chrono::high_resolution_clock::now();
+    build_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    long long expected_checksum = run(original, queries);
+    end = std::chrono::high_resolution_clock::now();
+    ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Binary lifting LCA: build " << build_ms << " ms, colors and queries "
+              << ms << " ms" << std::endl;
+
+    if (checksum != expected_checksum) std::cout << "Wrong nearest colored node!" << std::endl;
+
+    auto mixed_queries = get_random_queries(n, queries_count, true, n + 1);
+    NearestColoredNode mixed(tree);
+    start = std::chrono::high_resolution_clock::now();
+    run(mixed, mixed_queries);
+    end = std::chrono::high_resolution_clock::now();
+    ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Precomputed distances, with uncolors: " << ms << " ms" << std::endl;
+
+    std::cout << std::endl;
+}
+
 int main()
 {
 //    test(get_sample_tree_1(), get_sample_queries_1());
     test(get_sample_tree_2(), get_sample_queries_2());
+    random_test(300);
+    toggle_test(1000, 100'000);
+
+    time_test(1'000'000, 1'000'000, 1'000'000);
+    time_test(1'000'000, 100, 1'000'000);
 }
\ No newline at end of file
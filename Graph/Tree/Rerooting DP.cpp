@@ -0,0 +1,379 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+struct Edge
+{
+    int to;
+    int weight;
+};
+
+typedef std::vector<std::vector<Edge>> Tree;
+
+int get_to(const Edge& edge) {
+    return edge.to;
+}
+
+// Computes the answer of a tree DP for every node as the root, in O(n)
+//  calls to the policy, with two passes over a BFS order (no recursion).
+//
+// The DP of a rooted subtree is
+//  value(node) = finalize(merge of extend(value(child), edge) over the children, node)
+//  where merge is associative with identity() as its identity, and the order of
+//  the children doesn't matter.
+//
+// The first pass computes the values of all the subtrees with the given root,
+//  bottom-up. When the root moves from a node to its child, the child gets one
+//  more "child": the rest of the tree, through its old parent. The second pass
+//  computes this value for all the nodes, top-down: it's the merge of all the
+//  neighbours of the parent except the child, which is a prefix merge times a
+//  suffix merge over the neighbours of the parent. The answer for a node is the
+//  merge of all of its neighbours, the parent included.
+//
+// Both passes work on the positions in the BFS order instead of the nodes, where
+//  the children of each node are next to each other, so only the BFS itself
+//  jumps around the memory.
+//
+// Only the nodes that are connected to the root get an answer.
+template <typename Policy>
+std::vector<typename Policy::Value> get_rerooted_answers(const Tree& tree, int root = 0)
+{
+    typedef typename Policy::Value Value;
+    typedef typename Tree::value_type::value_type TreeEdge;
+
+    int n = tree.size();
+    std::vector<Value> answers(n, Policy::identity());
+
+    // The BFS order, the position of the parent of each position, the edge
+    //  from it, and where the children of each position start.
+    std::vector<int> order = {root};
+    std::vector<int> parent = {-1};
+    std::vector<TreeEdge> parent_edge(1);
+    std::vector<int> children_start;
+    order.reserve(n);
+    parent.reserve(n);
+    parent_edge.reserve(n);
+    children_start.reserve(n + 1);
+    for (int i = 0; i < (int)order.size(); i++)
+    {
+        int node = order[i];
+        int parent_node = parent[i] == -1 ? -1 : order[parent[i]];
+        children_start.push_back(order.size());
+        for (auto& edge : tree[node]) {
+            int child = get_to(edge);
+            if (child != parent_node) {
+                order.push_back(child);
+                parent.push_back(i);
+                parent_edge.push_back(edge);
+            }
+        }
+    }
+    int count = order.size();
+    children_start.push_back(count);
+
+    // down[i] is first the merge of the children of i so far, then its value.
+    std::vector<Value> down(count, Policy::identity());
+    for (int i = count - 1; i >= 0; i--)
+    {
+        down[i] = Policy::finalize(down[i], order[i]);
+        if (i != 0) down[parent[i]] = Policy::merge(down[parent[i]], Policy::extend(down[i], parent_edge[i]));
+    }
+
+    // up[i] is what the rest of the tree adds to i, through its parent.
+    std::vector<Value> up(count, Policy::identity());
+    std::vector<Value> contributions;
+    std::vector<Value> prefix;
+    for (int i = 0; i < count; i++)
+    {
+        int first = children_start[i];
+        int children_count = children_start[i + 1] - first;
+
+        contributions.resize(children_count);
+        prefix.resize(children_count + 1);
+        prefix[0] = up[i];
+        for (int j = 0; j < children_count; j++) {
+            contributions[j] = Policy::extend(down[first + j], parent_edge[first + j]);
+            prefix[j + 1] = Policy::merge(prefix[j], contributions[j]);
+        }
+
+        answers[order[i]] = Policy::finalize(prefix[children_count], order[i]);
+
+        Value suffix = Policy::identity();
+        for (int j = children_count - 1; j >= 0; j--) {
+            Value without = Policy::finalize(Policy::merge(prefix[j], suffix), order[i]);
+            up[first + j] = Policy::extend(without, parent_edge[first + j]);
+            suffix = Policy::merge(contributions[j], suffix);
+        }
+    }
+
+    return answers;
+}
+
+// The two longest branches from a node, through different neighbours.
+//  The first is the eccentricity of the node, and the longest path
+//  through the node is first + second.
+struct LongestBranches
+{
+    struct Value
+    {
+        long long first;
+        long long second;
+    };
+
+    static Value identity() {
+        return {0, 0};
+    }
+
+    static Value merge(const Value& a, const Value& b)
+    {
+        if (a.first >= b.first) return {a.first, std::max(a.second, b.first)};
+        return {b.first, std::max(b.second, a.first)};
+    }
+
+    static Value extend(const Value& value, const Edge& edge) {
+        return {value.first + edge.weight, 0};
+    }
+
+    static Value finalize(const Value& value, int /*node*/) {
+        return value;
+    }
+};
+
+// The farthest node from each node (the smallest one, for ties).
+struct FarthestNode
+{
+    struct Value
+    {
+        long long distance;
+        int node;
+    };
+
+    static Value identity() {
+        return {-1, -1};
+    }
+
+    static Value merge(const Value& a, const Value& b)
+    {
+        if (a.distance != b.distance) return a.distance > b.distance ? a : b;
+        return a.node < b.node ? a : b;
+    }
+
+    static Value extend(const Value& value, const Edge& edge) {
+        return {value.distance + edge.weight, value.node};
+    }
+
+    static Value finalize(const Value& value, int node) {
+        return merge(value, {0, node});
+    }
+};
+
+// The sum of the distances from each node to all the nodes.
+struct SumOfDistances
+{
+    struct Value
+    {
+        long long size;
+        long long sum;
+    };
+
+    static Value identity() {
+        return {0, 0};
+    }
+
+    static Value merge(const Value& a, const Value& b) {
+        return {a.size + b.size, a.sum + b.sum};
+    }
+
+    static Value extend(const Value& value, const Edge& edge) {
+        return {value.size, value.sum + value.size * edge.weight};
+    }
+
+    static Value finalize(const Value& value, int /*node*/) {
+        return {value.size + 1, value.sum};
+    }
+};
+
+// The size of the largest component left after removing each node. It's
+//  at most n / 2 exactly for the centroids.
+struct LargestComponent
+{
+    struct Value
+    {
+        int size;
+        int largest;
+    };
+
+    static Value identity() {
+        return {0, 0};
+    }
+
+    static Value merge(const Value& a, const Value& b) {
+        return {a.size + b.size, std::max(a.largest, b.largest)};
+    }
+
+    static Value extend(const Value& value, const Edge& /*edge*/) {
+        return {value.size, value.size};
+    }
+
+    static Value finalize(const Value& value, int /*node*/) {
+        return {value.size + 1, value.largest};
+    }
+};
+
+void add_child(Tree &tree, int parent, int child, int weight)
+{
+    tree[parent].push_back({child, weight});
+    tree[child].push_back({parent, weight});
+}
+
+Tree get_sample_tree()
+{
+    Tree tree(7);
+
+    add_child(tree, 0, 1, 1);
+    add_child(tree, 0, 2, 2);
+
+    add_child(tree, 1, 5, 3);
+    add_child(tree, 1, 6, 1);
+
+    add_child(tree, 2, 3, 1);
+    add_child(tree, 2, 4, 5);
+
+    return tree;
+}
+
+void test(const Tree& tree)
+{
+    auto branches = get_rerooted_answers<LongestBranches>(tree);
+    auto farthest = get_rerooted_answers<FarthestNode>(tree);
+    auto sums = get_rerooted_answers<SumOfDistances>(tree);
+    auto components = get_rerooted_answers<LargestComponent>(tree);
+
+    for (int node = 0; node < tree.size(); node++)
+    {
+        std::cout << "Node " << node << ": eccentricity " << branches[node].first
+                  << ", farthest node " << farthest[node].node
+                  << ", sum of distances " << sums[node].sum
+                  << ", largest component without it " << components[node].largest << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// The parent of each node is one of the max_back nodes before it
+// (in a random order), so max_back = 1 gives a path.
+Tree get_random_tree(int n, int max_back, int max_weight, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<int> label(n);
+    for (int i = 0; i < n; i++) label[i] = i;
+    std::shuffle(label.begin(), label.end(), random);
+
+    Tree tree(n);
+    for (int i = 1; i < n; i++) {
+        int parent = i - 1 - random() % std::min(i, max_back);
+        add_child(tree, label[parent], label[i], 1 + random() % max_weight);
+    }
+    return tree;
+}
+
+std::vector<long long> get_distances(const Tree& tree, int source)
+{
+    std::vector<long long> distances(tree.size(), -1);
+    std::vector<int> queue = {source};
+    distances[source] = 0;
+    for (int i = 0; i < (int)queue.size(); i++) {
+        for (auto& edge : tree[queue[i]]) {
+            if (distances[edge.to] == -1) {
+                distances[edge.to] = distances[queue[i]] + edge.weight;
+                queue.push_back(edge.to);
+            }
+        }
+    }
+    return distances;
+}
+
+void random_test(int tests)
+{
+    std::mt19937 random(23);
+    for (int t = 0; t < tests; t++)
+    {
+        int n = 1 + random() % 60;
+        auto tree = get_random_tree(n, 1 + random() % n, 1 + random() % 5, t);
+        int root = random() % n;
+
+        auto branches = get_rerooted_answers<LongestBranches>(tree, root);
+        auto farthest = get_rerooted_answers<FarthestNode>(tree, root);
+        auto sums = get_rerooted_answers<SumOfDistances>(tree, root);
+        auto components = get_rerooted_answers<LargestComponent>(tree, root);
+
+        long long diameter = 0;
+        for (int node = 0; node < n; node++)
+        {
+            auto distances = get_distances(tree, node);
+            long long eccentricity = *std::max_element(distances.begin(), distances.end());
+            long long sum = 0;
+            for (long long distance : distances) sum += distance;
+            int farthest_node = std::find(distances.begin(), distances.end(), eccentricity) - distances.begin();
+            diameter = std::max(diameter, eccentricity);
+
+            // The component of each neighbour is the nodes closer to it than to the node.
+            int largest = 0;
+            for (auto& edge : tree[node]) {
+                auto neighbour_distances = get_distances(tree, edge.to);
+                int size = 0;
+                for (int i = 0; i < n; i++) size += neighbour_distances[i] < distances[i];
+                largest = std::max(largest, size);
+            }
+
+            if (branches[node].first != eccentricity || farthest[node].node != farthest_node ||
+                farthest[node].distance != eccentricity || sums[node].sum != sum ||
+                components[node].largest != largest) {
+                std::cout << "Wrong answer!" << std::endl;
+                return;
+            }
+        }
+
+        long long longest_path = 0;
+        for (int node = 0; node < n; node++)
+            longest_path = std::max(longest_path, branches[node].first + branches[node].second);
+        if (longest_path != diameter) {
+            std::cout << "Wrong diameter!" << std::endl;
+            return;
+        }
+    }
+}
+
+template <typename Policy>
+long long time_policy(const Tree& tree, const char* name)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    auto answers = get_rerooted_answers<Policy>(tree);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << name << ": " << ms << " ms" << std::endl;
+    return answers.size();
+}
+
+void time_test(int n, int max_back)
+{
+    auto tree = get_random_tree(n, max_back, 100, n);
+    std::cout << "n = " << n << ", parents up to " << max_back << " nodes back" << std::endl;
+
+    time_policy<LongestBranches>(tree, "Eccentricities");
+    time_policy<FarthestNode>(tree, "Farthest nodes");
+    time_policy<SumOfDistances>(tree, "Sums of distances");
+    time_policy<LargestComponent>(tree, "Largest components");
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    test(get_sample_tree());
+    random_test(300);
+
+    time_test(10'000'000, 10'000'000);
+    time_test(10'000'000, 1);
+}